@@ -23,6 +23,7 @@
 namespace llvm {
 
 class BlockFrequencyInfo;
+class CallInst;
 class Function;
 class Module;
 class ProfileSummaryInfo;
@@ -38,6 +39,13 @@ ModuleSummaryIndex buildModuleSummaryIndex(
     std::function<BlockFrequencyInfo *(const Function &F)> GetBFICallback,
     ProfileSummaryInfo *PSI);
 
+/// If \p CI is a call to llvm.contract.check of which the predicate only
+/// compares a parameter of the enclosing function with constants (possibly
+/// several times, joined by `and'), return the check as recorded in the
+/// summary.
+Optional<FunctionSummary::ContractCheck>
+getContractParamCheck(const CallInst &CI);
+
 /// Analysis pass to provide the ModuleSummaryIndex object.
 class ModuleSummaryIndexAnalysis
     : public AnalysisInfoMixin<ModuleSummaryIndexAnalysis> {
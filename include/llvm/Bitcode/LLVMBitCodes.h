@@ -256,6 +256,14 @@ enum GlobalValueSummarySymtabCodes {
   // strings in strtab.
   // [n * name]
   FS_CFI_FUNCTION_DECLS = 18,
+  // The list of contract checks of this function that compare a parameter
+  // with constants, i.e. hold iff it is in [lower, upper).
+  // [n x (paramno, bitwidth, lower, upper, redundant)]
+  FS_CONTRACT_CHECKS = 19,
+  // The ranges of the integer arguments of the direct calls made by this
+  // function to a callee, joined over all the call sites.
+  // [callee guid, n x (argno, bitwidth, lower, upper)]
+  FS_CONTRACT_CALL_ARGS = 20,
 };
 
 enum MetadataCodes {
@@ -23,6 +23,7 @@
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/IR/ConstantRange.h"
 #include "llvm/IR/GlobalValue.h"
 #include "llvm/IR/Module.h"
 #include <algorithm>
@@ -309,6 +310,23 @@ public:
     unsigned ReturnDoesNotAlias : 1;
   };
 
+  /// A contract check (llvm.contract.check) of which the predicate only
+  /// compares a parameter with constants, i.e. holds iff the parameter is in
+  /// Range. Redundant is set by the thin link if every call satisfies it.
+  struct ContractCheck {
+    unsigned ParamNo;
+    ConstantRange Range;
+    bool Redundant;
+  };
+
+  /// The ranges of the integer arguments of the direct calls to Callee made
+  /// by this function, joined over all the call sites. Arguments of which
+  /// nothing is known are omitted.
+  struct ContractCallArgs {
+    GlobalValue::GUID Callee;
+    std::vector<std::pair<unsigned, ConstantRange>> Args;
+  };
+
 private:
   /// Number of instructions (ignoring debug instructions, e.g.) computed
   /// during the initial compile step when the summary index is first built.
@@ -342,6 +360,15 @@ private:
 
   std::unique_ptr<TypeIdInfo> TIdInfo;
 
+  /// Contract related information, only allocated if the function has
+  /// contract checks or passes known arguments to other functions.
+  struct ContractInfo {
+    std::vector<ContractCheck> Checks;
+    std::vector<ContractCallArgs> CallArgs;
+  };
+
+  std::unique_ptr<ContractInfo> CInfo;
+
 public:
   FunctionSummary(GVFlags Flags, unsigned NumInsts, FFlags FunFlags,
                   std::vector<ValueInfo> Refs, std::vector<EdgeTy> CGEdges,
@@ -428,6 +455,40 @@ public:
       TIdInfo = llvm::make_unique<TypeIdInfo>();
     TIdInfo->TypeTests.push_back(Guid);
   }
+
+  /// Returns the contract checks of this function on its parameters.
+  ArrayRef<ContractCheck> contract_checks() const {
+    if (CInfo)
+      return CInfo->Checks;
+    return {};
+  }
+
+  /// Returns the known ranges of the arguments passed by this function to the
+  /// functions it calls.
+  ArrayRef<ContractCallArgs> contract_call_args() const {
+    if (CInfo)
+      return CInfo->CallArgs;
+    return {};
+  }
+
+  void addContractCheck(ContractCheck Check) {
+    if (!CInfo)
+      CInfo = llvm::make_unique<ContractInfo>();
+    CInfo->Checks.push_back(std::move(Check));
+  }
+
+  void addContractCallArgs(ContractCallArgs Args) {
+    if (!CInfo)
+      CInfo = llvm::make_unique<ContractInfo>();
+    CInfo->CallArgs.push_back(std::move(Args));
+  }
+
+  /// Mark the contract check I as satisfied by all the calls to this function.
+  /// This is used by the thin link (see computeRedundantContractChecks()).
+  void setContractCheckRedundant(unsigned I) {
+    assert(CInfo && I < CInfo->Checks.size() && "Unknown contract check");
+    CInfo->Checks[I].Redundant = true;
+  }
 };
 
 template <> struct DenseMapInfo<FunctionSummary::VFuncId> {
@@ -106,6 +106,9 @@ namespace {
       (void) llvm::createGlobalOptimizerPass();
       (void) llvm::createGlobalsAAWrapperPass();
       (void) llvm::createGuardWideningPass();
+      (void) llvm::createContractCheckEliminationPass();
+      (void) llvm::createLowerContractCheckIntrinsicPass();
+      (void) llvm::createLoopContractVersioningPass();
       (void) llvm::createIPConstantPropagationPass();
       (void) llvm::createIPSCCPPass();
       (void) llvm::createInductiveRangeCheckEliminationPass();
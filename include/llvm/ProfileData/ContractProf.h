@@ -0,0 +1,91 @@
+//===- ContractProf.h - Contract profiling data -----------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains the reader and writer of the profiles written by the
+// contract profiling runtime (clang -fcontract-profile).
+//
+// A contract profile is a text file with one record per line and per contract
+// check site:
+//
+//   evaluations violations cost line level file function comment
+//
+// Fields are separated by a tab; tabs, newlines and backslashes in the string
+// fields are escaped as "\t", "\n" and "\\".  Lines starting with '#' are
+// comments.  Records for the same site (file, line, function and comment) are
+// summed, so that the concatenation of two profiles is their merge.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_PROFILEDATA_CONTRACTPROF_H
+#define LLVM_PROFILEDATA_CONTRACTPROF_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/raw_ostream.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace llvm {
+
+/// The counters of a contract check site.
+struct ContractProfRecord {
+  std::string File;
+  unsigned Line = 0;
+  std::string Function;
+  std::string Comment;
+  std::string Level;
+  /// Number of times the predicate was evaluated.
+  uint64_t Evaluations = 0;
+  /// Number of times the predicate evaluated to false.
+  uint64_t Violations = 0;
+  /// Static estimate of the cost of one evaluation, in cycles.
+  uint64_t Cost = 0;
+
+  /// Estimated number of cycles spent evaluating the predicate.
+  uint64_t getEstimatedCycles() const { return Evaluations * Cost; }
+};
+
+/// A set of contract profile records, keyed by site.
+class ContractProfile {
+public:
+  typedef std::tuple<std::string, unsigned, std::string, std::string> KeyTy;
+
+  /// Merge the records in \p Buffer (named \p Name for diagnostics).
+  Error read(StringRef Buffer, StringRef Name = "<buffer>");
+
+  /// Merge the records in the file \p Filename.
+  Error readFile(StringRef Filename);
+
+  /// Merge \p R into this profile.
+  void addRecord(const ContractProfRecord &R);
+
+  /// Write all the records to \p OS, sorted by site.
+  void write(raw_ostream &OS) const;
+
+  /// Return the record for a site, or nullptr if the site was not profiled.
+  const ContractProfRecord *lookup(StringRef File, unsigned Line,
+                                   StringRef Function, StringRef Comment) const;
+
+  /// Return the records sorted by decreasing estimated cycles, then by
+  /// decreasing evaluation count.
+  std::vector<const ContractProfRecord *> getRanking() const;
+
+  bool empty() const { return Records.empty(); }
+  size_t size() const { return Records.size(); }
+
+private:
+  std::map<KeyTy, ContractProfRecord> Records;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_PROFILEDATA_CONTRACTPROF_H
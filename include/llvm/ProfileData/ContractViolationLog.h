@@ -0,0 +1,85 @@
+//===- ContractViolationLog.h - Contract violation logs ---------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains the reader of the logs written by the contract violation
+// logging runtime (clang -fcontract-violation-log).
+//
+// A log is a binary file in the byte order of the target.  It starts with a
+// 16-byte header, the magic "CONTRLOG" followed by the version and a reserved
+// 32-bit word, and is followed by records that are each a multiple of 8 bytes
+// long and start with a 32-bit kind:
+//
+//   module:    kind (1), module, number of sites N, size S of the strings;
+//              then the N entries of the module's __contract_violation_tab
+//              (five 32-bit words: line, and offsets of the file, function,
+//              comment and level strings) and its S bytes of strings.
+//   violation: kind (2), module, site, count (1), 64-bit time in ns.
+//   dropped:   kind (3), module, site, count, 64-bit time in ns; count
+//              violations of the site were not logged because of the rate
+//              limit.  Module and site are ~0U for the violations lost to a
+//              full buffer.
+//
+// A zero kind ends the log.  Records refer to sites by module and index in
+// the table of the module, which precedes them in the log.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_PROFILEDATA_CONTRACTVIOLATIONLOG_H
+#define LLVM_PROFILEDATA_CONTRACTVIOLATIONLOG_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace llvm {
+
+/// A contract check site, from the __contract_violation_tab of its module.
+struct ContractViolationSite {
+  std::string File;
+  unsigned Line = 0;
+  std::string Function;
+  std::string Comment;
+  std::string Level;
+};
+
+/// A violation, or a number of violations left out of the log.
+struct ContractViolationEvent {
+  /// Time of the violation, or of the last dropped one, in ns since the epoch.
+  uint64_t Time = 0;
+  /// The violated site; nullptr for the violations lost to a full buffer.
+  const ContractViolationSite *Site = nullptr;
+  /// Number of violations; 1 for a logged violation.
+  uint64_t Count = 0;
+  bool Dropped = false;
+};
+
+/// The contents of a contract violation log.
+class ContractViolationLog {
+public:
+  /// Read the log in \p Buffer (named \p Name for diagnostics).
+  Error read(StringRef Buffer, StringRef Name = "<buffer>");
+
+  /// Read the log in the file \p Filename.
+  Error readFile(StringRef Filename);
+
+  /// The events in the order they were logged.
+  const std::vector<ContractViolationEvent> &events() const { return Events; }
+
+private:
+  std::map<std::pair<uint32_t, uint32_t>, ContractViolationSite> Sites;
+  std::vector<ContractViolationEvent> Events;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_PROFILEDATA_CONTRACTVIOLATIONLOG_H
@@ -102,6 +102,14 @@ void computeDeadSymbols(
     ModuleSummaryIndex &Index,
     const DenseSet<GlobalValue::GUID> &GUIDPreservedSymbols);
 
+/// Mark as redundant the contract checks on the parameters of a function that
+/// every call in the index satisfies, given the ranges of the arguments
+/// recorded at the call edges. Functions listed in \p GUIDPreservedSymbols,
+/// or of which the address is taken, may have other callers and are skipped.
+void computeRedundantContractChecks(
+    ModuleSummaryIndex &Index,
+    const DenseSet<GlobalValue::GUID> &GUIDPreservedSymbols);
+
 /// Compute the set of summaries needed for a ThinLTO backend compilation of
 /// \p ModulePath.
 //
@@ -132,6 +140,12 @@ void thinLTOResolveWeakForLinkerModule(Module &TheModule,
 /// during global summary-based analysis.
 void thinLTOInternalizeModule(Module &TheModule,
                               const GVSummaryMapTy &DefinedGlobals);
+
+/// Remove from \p TheModule the contract checks found to be redundant by
+/// computeRedundantContractChecks(). This must happen before the module is
+/// renamed for ThinLTO, while its GUIDs match those of the summaries.
+void thinLTORemoveRedundantContractChecks(Module &TheModule,
+                                          const GVSummaryMapTy &DefinedGlobals);
 }
 
 #endif // LLVM_FUNCTIONIMPORT_H
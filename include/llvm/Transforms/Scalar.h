@@ -90,6 +90,21 @@ FunctionPass *createAggressiveDCEPass();
 //
 FunctionPass *createGuardWideningPass();
 
+//===----------------------------------------------------------------------===//
+//
+// ContractCheckElimination - An optimization over the @llvm.contract.check
+// intrinsic that removes checks which are known to hold, and hoists
+// loop-invariant checks out of loops.
+//
+FunctionPass *createContractCheckEliminationPass();
+
+//===----------------------------------------------------------------------===//
+//
+// LoopContractVersioning - Version inner loops on a run-time test proving that
+// none of their contract checks on induction variables fails.
+//
+FunctionPass *createLoopContractVersioningPass();
+
 
 //===----------------------------------------------------------------------===//
 //
@@ -426,6 +441,13 @@ Pass *createLowerAtomicPass();
 //
 Pass *createLowerGuardIntrinsicPass();
 
+//===----------------------------------------------------------------------===//
+//
+// LowerContractCheckIntrinsic - Replace contract check intrinsics by their
+// predicate.
+//
+FunctionPass *createLowerContractCheckIntrinsicPass();
+
 //===----------------------------------------------------------------------===//
 //
 // MergeICmps - Merge integer comparison chains
@@ -0,0 +1,32 @@
+//===- ContractCheckElimination.h - Remove redundant contracts --*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Contract check elimination is an optimization over the @llvm.contract.check
+// intrinsic that folds checks whose predicate is implied by dominating
+// conditions, value ranges or SCEV, and hoists loop-invariant checks out of
+// the loop so that they are evaluated once.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TRANSFORMS_SCALAR_CONTRACTCHECKELIMINATION_H
+#define LLVM_TRANSFORMS_SCALAR_CONTRACTCHECKELIMINATION_H
+
+#include "llvm/IR/PassManager.h"
+
+namespace llvm {
+
+class Function;
+
+struct ContractCheckEliminationPass
+    : public PassInfoMixin<ContractCheckEliminationPass> {
+  PreservedAnalyses run(Function &F, FunctionAnalysisManager &AM);
+};
+}
+
+#endif // LLVM_TRANSFORMS_SCALAR_CONTRACTCHECKELIMINATION_H
@@ -0,0 +1,31 @@
+//===- LoopContractVersioning.h - Version loops on contracts ----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// This header defines the LoopContractVersioningPass object.  This pass
+/// versions a loop on a single run-time test proving that none of the contract
+/// checks on its induction variables can fail, so that the checks can be
+/// removed from the version that normally runs.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TRANSFORMS_SCALAR_LOOPCONTRACTVERSIONING_H
+#define LLVM_TRANSFORMS_SCALAR_LOOPCONTRACTVERSIONING_H
+
+#include "llvm/IR/PassManager.h"
+
+namespace llvm {
+
+/// Pass to hoist the contract checks on induction variables out of loops.
+struct LoopContractVersioningPass
+    : public PassInfoMixin<LoopContractVersioningPass> {
+  PreservedAnalyses run(Function &F, FunctionAnalysisManager &AM);
+};
+}
+
+#endif // LLVM_TRANSFORMS_SCALAR_LOOPCONTRACTVERSIONING_H
@@ -0,0 +1,29 @@
+//===- LowerContractCheckIntrinsic.h - Lower contract checks ----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This pass replaces each call to llvm.contract.check by its predicate.  Once
+// this happens, the check can no longer be told apart from ordinary control
+// flow.
+//
+//===----------------------------------------------------------------------===//
+#ifndef LLVM_TRANSFORMS_SCALAR_LOWERCONTRACTCHECKINTRINSIC_H
+#define LLVM_TRANSFORMS_SCALAR_LOWERCONTRACTCHECKINTRINSIC_H
+
+#include "llvm/IR/PassManager.h"
+
+namespace llvm {
+
+struct LowerContractCheckIntrinsicPass
+    : PassInfoMixin<LowerContractCheckIntrinsicPass> {
+  PreservedAnalyses run(Function &F, FunctionAnalysisManager &AM);
+};
+
+}
+
+#endif //LLVM_TRANSFORMS_SCALAR_LOWERCONTRACTCHECKINTRINSIC_H
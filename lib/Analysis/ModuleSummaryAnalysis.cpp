@@ -27,6 +27,7 @@
 #include "llvm/Analysis/LoopInfo.h"
 #include "llvm/Analysis/ProfileSummaryInfo.h"
 #include "llvm/Analysis/TypeMetadataUtils.h"
+#include "llvm/Analysis/ValueTracking.h"
 #include "llvm/IR/Attributes.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/CallSite.h"
@@ -49,6 +50,7 @@
 #include "llvm/Object/SymbolicFile.h"
 #include "llvm/Pass.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/KnownBits.h"
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
@@ -195,6 +197,92 @@ static void addIntrinsicToSummary(
   }
 }
 
+/// Return the values of the parameter Arg for which the predicate Cond holds,
+/// or None if Cond does not only compare Arg with constants.
+static Optional<ConstantRange> getContractParamRange(const Value *Cond,
+                                                     const Argument *&Arg) {
+  if (auto *BO = dyn_cast<BinaryOperator>(Cond)) {
+    if (BO->getOpcode() != Instruction::And)
+      return None;
+    Optional<ConstantRange> LHS = getContractParamRange(BO->getOperand(0), Arg);
+    if (!LHS)
+      return None;
+    Optional<ConstantRange> RHS = getContractParamRange(BO->getOperand(1), Arg);
+    if (!RHS)
+      return None;
+    // intersectWith() returns a superset of the intersection if the latter is
+    // not a single range.
+    ConstantRange Range = LHS->intersectWith(*RHS);
+    if (!LHS->contains(Range) || !RHS->contains(Range))
+      return None;
+    return Range;
+  }
+
+  auto *Cmp = dyn_cast<ICmpInst>(Cond);
+  if (!Cmp)
+    return None;
+  CmpInst::Predicate Pred = Cmp->getPredicate();
+  const Value *LHS = Cmp->getOperand(0);
+  const auto *RHS = dyn_cast<ConstantInt>(Cmp->getOperand(1));
+  if (!RHS) {
+    RHS = dyn_cast<ConstantInt>(LHS);
+    LHS = Cmp->getOperand(1);
+    Pred = Cmp->getSwappedPredicate();
+  }
+  auto *A = dyn_cast<Argument>(LHS);
+  if (!RHS || !A || (Arg && A != Arg))
+    return None;
+  Arg = A;
+  return ConstantRange::makeExactICmpRegion(Pred, RHS->getValue());
+}
+
+Optional<FunctionSummary::ContractCheck>
+llvm::getContractParamCheck(const CallInst &CI) {
+  const Function *Callee = CI.getCalledFunction();
+  if (!Callee || Callee->getIntrinsicID() != Intrinsic::contract_check)
+    return None;
+  const Argument *Arg = nullptr;
+  Optional<ConstantRange> Range =
+      getContractParamRange(CI.getArgOperand(0), Arg);
+  if (!Range || Range->isFullSet() || Range->getBitWidth() > 64)
+    return None;
+  return FunctionSummary::ContractCheck{Arg->getArgNo(), *Range,
+                                        /*Redundant=*/false};
+}
+
+/// Join the ranges of the integer arguments of the call CS into Args, which
+/// holds those of the previous calls to the same function (if any).
+static void addContractCallArgs(
+    ImmutableCallSite CS, const DataLayout &DL, bool FirstCall,
+    std::vector<std::pair<unsigned, ConstantRange>> &Args) {
+  std::vector<std::pair<unsigned, ConstantRange>> Joined;
+  for (unsigned ArgNo = 0, E = CS.arg_size(); ArgNo != E; ++ArgNo) {
+    const Value *V = CS.getArgument(ArgNo);
+    if (!V->getType()->isIntegerTy() ||
+        V->getType()->getIntegerBitWidth() > 64)
+      continue;
+    auto Prev = find_if(Args, [&](const std::pair<unsigned, ConstantRange> &A) {
+      return A.first == ArgNo;
+    });
+    if (!FirstCall && Prev == Args.end())
+      continue;
+
+    // The unsigned range of the values with the known bits, e.g. a single
+    // value for a constant.
+    KnownBits Known = computeKnownBits(V, DL, 0, nullptr,
+                                       CS.getInstruction());
+    APInt Max = ~Known.Zero;
+    ConstantRange Range(Known.getBitWidth());
+    if (!Known.hasConflict() && (!Known.One.isNullValue() || !Max.isMaxValue()))
+      Range = ConstantRange(Known.One, Max + 1);
+    if (!FirstCall)
+      Range = Range.unionWith(Prev->second);
+    if (!Range.isFullSet())
+      Joined.emplace_back(ArgNo, Range);
+  }
+  Args = std::move(Joined);
+}
+
 static void
 computeFunctionSummary(ModuleSummaryIndex &Index, const Module &M,
                        const Function &F, BlockFrequencyInfo *BFI,
@@ -216,6 +304,9 @@ computeFunctionSummary(ModuleSummaryIndex &Index, const Module &M,
       TypeCheckedLoadConstVCalls;
   ICallPromotionAnalysis ICallAnalysis;
   SmallPtrSet<const User *, 8> Visited;
+  std::vector<FunctionSummary::ContractCheck> ContractChecks;
+  MapVector<GlobalValue::GUID, std::vector<std::pair<unsigned, ConstantRange>>>
+      ContractCallArgs;
 
   // Add personality function, prefix data and prologue data to function's ref
   // list.
@@ -253,6 +344,8 @@ computeFunctionSummary(ModuleSummaryIndex &Index, const Module &M,
       // intrinsic, or an indirect call with profile data.
       if (CalledFunction) {
         if (CI && CalledFunction->isIntrinsic()) {
+          if (auto Check = getContractParamCheck(*CI))
+            ContractChecks.push_back(*Check);
           addIntrinsicToSummary(
               CI, TypeTests, TypeTestAssumeVCalls, TypeCheckedLoadVCalls,
               TypeTestAssumeConstVCalls, TypeCheckedLoadConstVCalls);
@@ -271,6 +364,16 @@ computeFunctionSummary(ModuleSummaryIndex &Index, const Module &M,
         CallGraphEdges[Index.getOrInsertValueInfo(
                            cast<GlobalValue>(CalledValue))]
             .updateHotness(Hotness);
+
+        // Record the ranges of the arguments, for the thin link to find the
+        // contract checks of the callee that all its callers satisfy.
+        GlobalValue::GUID Callee = cast<GlobalValue>(CalledValue)->getGUID();
+        bool FirstCall = !ContractCallArgs.count(Callee);
+        auto &Args = ContractCallArgs[Callee];
+        if (CS.getFunctionType() == CalledFunction->getFunctionType())
+          addContractCallArgs(CS, M.getDataLayout(), FirstCall, Args);
+        else
+          Args.clear();
       } else {
         // Skip inline assembly calls.
         if (CI && CI->isInlineAsm())
@@ -316,6 +419,11 @@ computeFunctionSummary(ModuleSummaryIndex &Index, const Module &M,
       TypeTestAssumeVCalls.takeVector(), TypeCheckedLoadVCalls.takeVector(),
       TypeTestAssumeConstVCalls.takeVector(),
       TypeCheckedLoadConstVCalls.takeVector());
+  for (auto &Check : ContractChecks)
+    FuncSummary->addContractCheck(std::move(Check));
+  for (auto &Args : ContractCallArgs)
+    if (!Args.second.empty())
+      FuncSummary->addContractCallArgs({Args.first, std::move(Args.second)});
   if (NonRenamableLocal)
     CantBePromoted.insert(F.getGUID());
   Index.addGlobalValueSummary(F.getName(), std::move(FuncSummary));
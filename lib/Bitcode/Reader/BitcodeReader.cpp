@@ -5065,6 +5065,29 @@ Error ModuleSummaryIndexBitcodeReader::parseEntireSummary(unsigned ID) {
       PendingTypeCheckedLoadVCalls;
   std::vector<FunctionSummary::ConstVCall> PendingTypeTestAssumeConstVCalls,
       PendingTypeCheckedLoadConstVCalls;
+  // Likewise for the contract records.
+  std::vector<FunctionSummary::ContractCheck> PendingContractChecks;
+  std::vector<FunctionSummary::ContractCallArgs> PendingContractCallArgs;
+
+  // Attach the pending contract records to the function summary FS.
+  auto addPendingContractRecords = [&](FunctionSummary &FS) {
+    for (auto &Check : PendingContractChecks)
+      FS.addContractCheck(std::move(Check));
+    for (auto &CallArgs : PendingContractCallArgs)
+      FS.addContractCallArgs(std::move(CallArgs));
+    PendingContractChecks.clear();
+    PendingContractCallArgs.clear();
+  };
+
+  // Decode a [bitwidth, lower, upper] range.
+  auto isValidRange = [](ArrayRef<uint64_t> Record) {
+    return Record[0] > 0 && Record[0] <= 64;
+  };
+  auto getRange = [](ArrayRef<uint64_t> Record) {
+    unsigned BitWidth = Record[0];
+    return ConstantRange(APInt(BitWidth, Record[1]),
+                         APInt(BitWidth, Record[2]));
+  };
 
   while (true) {
     BitstreamEntry Entry = Stream.advanceSkippingSubblocks();
@@ -5145,6 +5168,7 @@ Error ModuleSummaryIndexBitcodeReader::parseEntireSummary(unsigned ID) {
       PendingTypeCheckedLoadVCalls.clear();
       PendingTypeTestAssumeConstVCalls.clear();
       PendingTypeCheckedLoadConstVCalls.clear();
+      addPendingContractRecords(*FS);
       auto VIAndOriginalGUID = getValueInfoFromValueId(ValueID);
       FS->setModulePath(addThisModule()->first());
       FS->setOriginalName(VIAndOriginalGUID.second);
@@ -5237,6 +5261,7 @@ Error ModuleSummaryIndexBitcodeReader::parseEntireSummary(unsigned ID) {
       PendingTypeCheckedLoadVCalls.clear();
       PendingTypeTestAssumeConstVCalls.clear();
       PendingTypeCheckedLoadConstVCalls.clear();
+      addPendingContractRecords(*FS);
       LastSeenSummary = FS.get();
       LastSeenGUID = VI.getGUID();
       FS->setModulePath(ModuleIdMap[ModuleId]);
@@ -5325,6 +5350,33 @@ Error ModuleSummaryIndexBitcodeReader::parseEntireSummary(unsigned ID) {
           {{Record[0], Record[1]}, {Record.begin() + 2, Record.end()}});
       break;
 
+    case bitc::FS_CONTRACT_CHECKS:
+      // A function summary has at most one such record.
+      if (!PendingContractChecks.empty())
+        return error("Malformed contract check record");
+      for (unsigned I = 0; I + 5 <= Record.size(); I += 5) {
+        ArrayRef<uint64_t> Range = ArrayRef<uint64_t>(Record).slice(I + 1, 3);
+        if (!isValidRange(Range))
+          return error("Invalid record");
+        PendingContractChecks.push_back({static_cast<unsigned>(Record[I]),
+                                         getRange(Range), Record[I + 4] != 0});
+      }
+      break;
+
+    case bitc::FS_CONTRACT_CALL_ARGS: {
+      if (Record.empty())
+        break;
+      FunctionSummary::ContractCallArgs CallArgs{Record[0], {}};
+      for (unsigned I = 1; I + 4 <= Record.size(); I += 4) {
+        ArrayRef<uint64_t> Range = ArrayRef<uint64_t>(Record).slice(I + 1, 3);
+        if (!isValidRange(Range))
+          return error("Invalid record");
+        CallArgs.Args.emplace_back(Record[I], getRange(Range));
+      }
+      PendingContractCallArgs.push_back(std::move(CallArgs));
+      break;
+    }
+
     case bitc::FS_CFI_FUNCTION_DEFS: {
       std::set<std::string> &CfiFunctionDefs = TheIndex.cfiFunctionDefs();
       for (unsigned I = 0; I != Record.size(); I += 2)
@@ -3334,6 +3334,37 @@ static void writeFunctionTypeMetadataRecords(BitstreamWriter &Stream,
                      FS->type_checked_load_const_vcalls());
 }
 
+/// Write the contract related records that need to appear before a function
+/// summary entry (whether per-module or combined).
+static void writeFunctionContractRecords(BitstreamWriter &Stream,
+                                         FunctionSummary *FS) {
+  SmallVector<uint64_t, 64> Record;
+
+  auto PushRange = [&](const ConstantRange &Range) {
+    Record.push_back(Range.getBitWidth());
+    Record.push_back(Range.getLower().getZExtValue());
+    Record.push_back(Range.getUpper().getZExtValue());
+  };
+
+  for (auto &Check : FS->contract_checks()) {
+    Record.push_back(Check.ParamNo);
+    PushRange(Check.Range);
+    Record.push_back(Check.Redundant);
+  }
+  if (!Record.empty())
+    Stream.EmitRecord(bitc::FS_CONTRACT_CHECKS, Record);
+
+  for (auto &CallArgs : FS->contract_call_args()) {
+    Record.clear();
+    Record.push_back(CallArgs.Callee);
+    for (auto &Arg : CallArgs.Args) {
+      Record.push_back(Arg.first);
+      PushRange(Arg.second);
+    }
+    Stream.EmitRecord(bitc::FS_CONTRACT_CALL_ARGS, Record);
+  }
+}
+
 // Helper to emit a single function summary record.
 void ModuleBitcodeWriterBase::writePerModuleFunctionSummaryRecord(
     SmallVector<uint64_t, 64> &NameVals, GlobalValueSummary *Summary,
@@ -3343,6 +3374,7 @@ void ModuleBitcodeWriterBase::writePerModuleFunctionSummaryRecord(
 
   FunctionSummary *FS = cast<FunctionSummary>(Summary);
   writeFunctionTypeMetadataRecords(Stream, FS);
+  writeFunctionContractRecords(Stream, FS);
 
   NameVals.push_back(getEncodedGVSummaryFlags(FS->flags()));
   NameVals.push_back(FS->instCount());
@@ -3627,6 +3659,7 @@ void IndexBitcodeWriter::writeCombinedGlobalValueSummary() {
 
     auto *FS = cast<FunctionSummary>(S);
     writeFunctionTypeMetadataRecords(Stream, FS);
+    writeFunctionContractRecords(Stream, FS);
 
     NameVals.push_back(*ValueId);
     NameVals.push_back(Index.getModuleId(FS->modulePath()));
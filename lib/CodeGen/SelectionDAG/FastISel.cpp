@@ -1255,7 +1255,8 @@ bool FastISel::selectIntrinsicCall(const IntrinsicInst *II) {
     return true;
   }
   case Intrinsic::invariant_group_barrier:
-  case Intrinsic::expect: {
+  case Intrinsic::expect:
+  case Intrinsic::contract_check: {
     unsigned ResultReg = getRegForValue(II->getArgOperand(0));
     if (!ResultReg)
       return false;
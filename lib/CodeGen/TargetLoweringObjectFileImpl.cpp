@@ -181,6 +181,11 @@ getELFKindForNamedSection(StringRef Name, SectionKind K) {
                                       /*AddSegmentInfo=*/false))
     return SectionKind::getMetadata();
 
+  // The descriptions of the contract checks built with
+  // -fcontract-violation-site-ids are only read from the file.
+  if (Name == ".llvm_contract_info")
+    return SectionKind::getMetadata();
+
   if (Name.empty() || Name[0] != '.') return K;
 
   // Some lame default implementation based on some magic section names.
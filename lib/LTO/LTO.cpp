@@ -742,6 +742,7 @@ Error LTO::run(AddStreamFn AddStream, NativeObjectCache Cache) {
   }
 
   computeDeadSymbols(ThinLTO.CombinedIndex, GUIDPreservedSymbols);
+  computeRedundantContractChecks(ThinLTO.CombinedIndex, GUIDPreservedSymbols);
 
   // Save the status of having a regularLTO combined module, as
   // this is needed for generating the ThinLTO Task ID, and
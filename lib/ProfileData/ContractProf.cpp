@@ -0,0 +1,160 @@
+//===- ContractProf.cpp - Contract profiling data -------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the reader and writer of contract profiles.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ProfileData/ContractProf.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <algorithm>
+
+using namespace llvm;
+
+static std::string unescape(StringRef S) {
+  std::string Res;
+  Res.reserve(S.size());
+  for (size_t I = 0, E = S.size(); I != E; ++I) {
+    if (S[I] != '\\' || I + 1 == E) {
+      Res.push_back(S[I]);
+      continue;
+    }
+    switch (S[++I]) {
+    case 't':
+      Res.push_back('\t');
+      break;
+    case 'n':
+      Res.push_back('\n');
+      break;
+    default:
+      Res.push_back(S[I]);
+      break;
+    }
+  }
+  return Res;
+}
+
+static void escape(raw_ostream &OS, StringRef S) {
+  for (char C : S) {
+    switch (C) {
+    case '\t':
+      OS << "\\t";
+      break;
+    case '\n':
+      OS << "\\n";
+      break;
+    case '\\':
+      OS << "\\\\";
+      break;
+    default:
+      OS << C;
+      break;
+    }
+  }
+}
+
+static Error malformed(StringRef Name, unsigned LineNo, const Twine &Msg) {
+  return make_error<StringError>(Name + ":" + Twine(LineNo) + ": " + Msg,
+                                 inconvertibleErrorCode());
+}
+
+Error ContractProfile::read(StringRef Buffer, StringRef Name) {
+  SmallVector<StringRef, 16> Lines;
+  Buffer.split(Lines, '\n');
+  unsigned LineNo = 0;
+  for (StringRef L : Lines) {
+    ++LineNo;
+    L = L.rtrim("\r");
+    if (L.empty() || L.startswith("#"))
+      continue;
+
+    SmallVector<StringRef, 8> Fields;
+    L.split(Fields, '\t');
+    if (Fields.size() != 8)
+      return malformed(Name, LineNo, "expected 8 fields, found " +
+                                         Twine(Fields.size()));
+
+    ContractProfRecord R;
+    if (Fields[0].getAsInteger(10, R.Evaluations) ||
+        Fields[1].getAsInteger(10, R.Violations) ||
+        Fields[2].getAsInteger(10, R.Cost) ||
+        Fields[3].getAsInteger(10, R.Line))
+      return malformed(Name, LineNo, "malformed counter");
+    R.Level = unescape(Fields[4]);
+    R.File = unescape(Fields[5]);
+    R.Function = unescape(Fields[6]);
+    R.Comment = unescape(Fields[7]);
+    addRecord(R);
+  }
+  return Error::success();
+}
+
+Error ContractProfile::readFile(StringRef Filename) {
+  auto BufferOrErr = MemoryBuffer::getFileOrSTDIN(Filename);
+  if (std::error_code EC = BufferOrErr.getError())
+    return make_error<StringError>(Filename + ": " + EC.message(), EC);
+  return read((*BufferOrErr)->getBuffer(), Filename);
+}
+
+void ContractProfile::addRecord(const ContractProfRecord &R) {
+  auto Res = Records.insert(
+      std::make_pair(KeyTy(R.File, R.Line, R.Function, R.Comment), R));
+  if (Res.second)
+    return;
+
+  ContractProfRecord &Old = Res.first->second;
+  Old.Evaluations = SaturatingAdd(Old.Evaluations, R.Evaluations);
+  Old.Violations = SaturatingAdd(Old.Violations, R.Violations);
+  // The cost is a static estimate; it may differ if the profiles come from
+  // different builds.
+  Old.Cost = std::max(Old.Cost, R.Cost);
+  if (!R.Level.empty())
+    Old.Level = R.Level;
+}
+
+void ContractProfile::write(raw_ostream &OS) const {
+  for (const auto &I : Records) {
+    const ContractProfRecord &R = I.second;
+    OS << R.Evaluations << '\t' << R.Violations << '\t' << R.Cost << '\t'
+       << R.Line << '\t';
+    escape(OS, R.Level);
+    OS << '\t';
+    escape(OS, R.File);
+    OS << '\t';
+    escape(OS, R.Function);
+    OS << '\t';
+    escape(OS, R.Comment);
+    OS << '\n';
+  }
+}
+
+const ContractProfRecord *
+ContractProfile::lookup(StringRef File, unsigned Line, StringRef Function,
+                        StringRef Comment) const {
+  auto I = Records.find(KeyTy(File, Line, Function, Comment));
+  return I == Records.end() ? nullptr : &I->second;
+}
+
+std::vector<const ContractProfRecord *> ContractProfile::getRanking() const {
+  std::vector<const ContractProfRecord *> Ranking;
+  Ranking.reserve(Records.size());
+  for (const auto &I : Records)
+    Ranking.push_back(&I.second);
+  std::stable_sort(
+      Ranking.begin(), Ranking.end(),
+      [](const ContractProfRecord *L, const ContractProfRecord *R) {
+        if (L->getEstimatedCycles() != R->getEstimatedCycles())
+          return L->getEstimatedCycles() > R->getEstimatedCycles();
+        return L->Evaluations > R->Evaluations;
+      });
+  return Ranking;
+}
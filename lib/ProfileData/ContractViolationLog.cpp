@@ -0,0 +1,124 @@
+//===- ContractViolationLog.cpp - Contract violation logs -----------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the reader of contract violation logs.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ProfileData/ContractViolationLog.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+using namespace llvm;
+using namespace llvm::support;
+
+namespace {
+enum : uint32_t {
+  LogEnd = 0,
+  LogModule = 1,
+  LogViolation = 2,
+  LogDropped = 3,
+};
+} // end anonymous namespace
+
+static const uint32_t LogVersion = 1;
+
+static Error malformed(StringRef Name, uint64_t Offset, const Twine &Msg) {
+  return make_error<StringError>(Name + ": offset " + Twine(Offset) + ": " +
+                                     Msg,
+                                 inconvertibleErrorCode());
+}
+
+static uint32_t read32(StringRef Buffer, uint64_t Offset) {
+  return endian::read<uint32_t, native, 1>(Buffer.data() + Offset);
+}
+
+static uint64_t read64(StringRef Buffer, uint64_t Offset) {
+  return endian::read<uint64_t, native, 1>(Buffer.data() + Offset);
+}
+
+Error ContractViolationLog::read(StringRef Buffer, StringRef Name) {
+  if (Buffer.size() < 16 || !Buffer.startswith("CONTRLOG"))
+    return make_error<StringError>(Name + ": not a contract violation log",
+                                   inconvertibleErrorCode());
+  if (read32(Buffer, 8) != LogVersion)
+    return malformed(Name, 8, "unsupported version " +
+                                  Twine(read32(Buffer, 8)));
+
+  uint64_t Offset = 16;
+  while (Offset + 4 <= Buffer.size()) {
+    uint32_t Kind = read32(Buffer, Offset);
+    if (Kind == LogEnd)
+      break;
+
+    if (Kind == LogModule) {
+      if (Offset + 16 > Buffer.size())
+        return malformed(Name, Offset, "truncated module record");
+      uint32_t Module = read32(Buffer, Offset + 4);
+      uint64_t NumSites = read32(Buffer, Offset + 8);
+      uint64_t StrTabSize = read32(Buffer, Offset + 12);
+      uint64_t TableOffset = Offset + 16;
+      uint64_t StrTabOffset = TableOffset + NumSites * 20;
+      uint64_t End = alignTo(StrTabOffset + StrTabSize, 8);
+      if (End > Buffer.size())
+        return malformed(Name, Offset, "truncated module record");
+      StringRef StrTab = Buffer.substr(StrTabOffset, StrTabSize);
+      for (uint32_t I = 0; I < NumSites; ++I) {
+        ContractViolationSite Site;
+        StringRef Strings[4];
+        Site.Line = read32(Buffer, TableOffset + I * 20);
+        for (unsigned F = 0; F < 4; ++F) {
+          uint32_t StrOffset =
+              read32(Buffer, TableOffset + I * 20 + 4 * (F + 1));
+          if (StrOffset >= StrTab.size())
+            return malformed(Name, Offset, "string offset out of bounds");
+          // The strings are NUL-terminated.
+          Strings[F] = StrTab.substr(StrOffset).split('\0').first;
+        }
+        Site.File = Strings[0];
+        Site.Function = Strings[1];
+        Site.Comment = Strings[2];
+        Site.Level = Strings[3];
+        Sites[std::make_pair(Module, I)] = Site;
+      }
+      Offset = End;
+      continue;
+    }
+
+    if (Kind != LogViolation && Kind != LogDropped)
+      return malformed(Name, Offset, "unknown record kind " + Twine(Kind));
+    if (Offset + 24 > Buffer.size())
+      return malformed(Name, Offset, "truncated record");
+    uint32_t Module = read32(Buffer, Offset + 4);
+    uint32_t Site = read32(Buffer, Offset + 8);
+    ContractViolationEvent E;
+    E.Count = read32(Buffer, Offset + 12);
+    E.Time = read64(Buffer, Offset + 16);
+    E.Dropped = Kind == LogDropped;
+    if (!E.Dropped || Module != ~0U || Site != ~0U) {
+      auto I = Sites.find(std::make_pair(Module, Site));
+      if (I == Sites.end())
+        return malformed(Name, Offset, "unknown contract site " +
+                                           Twine(Module) + ":" + Twine(Site));
+      E.Site = &I->second;
+    }
+    Events.push_back(E);
+    Offset += 24;
+  }
+  return Error::success();
+}
+
+Error ContractViolationLog::readFile(StringRef Filename) {
+  auto BufferOrErr = MemoryBuffer::getFileOrSTDIN(Filename);
+  if (std::error_code EC = BufferOrErr.getError())
+    return make_error<StringError>(Filename + ": " + EC.message(), EC);
+  return read((*BufferOrErr)->getBuffer(), Filename);
+}
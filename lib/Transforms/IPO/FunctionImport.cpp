@@ -17,6 +17,7 @@
 #include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringSet.h"
 #include "llvm/ADT/Triple.h"
+#include "llvm/Analysis/ModuleSummaryAnalysis.h"
 #include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/IR/AutoUpgrade.h"
 #include "llvm/IR/DiagnosticPrinter.h"
@@ -40,6 +41,10 @@ STATISTIC(NumImportedFunctions, "Number of functions imported");
 STATISTIC(NumImportedModules, "Number of modules imported from");
 STATISTIC(NumDeadSymbols, "Number of dead stripped symbols in index");
 STATISTIC(NumLiveSymbols, "Number of live symbols in index");
+STATISTIC(NumRedundantContractChecks,
+          "Number of contract checks satisfied by all the calls in index");
+STATISTIC(NumRemovedContractChecks, "Number of redundant contract checks "
+                                    "removed");
 
 /// Limit on instruction count of imported functions.
 static cl::opt<unsigned> ImportInstrLimit(
@@ -81,6 +86,11 @@ static cl::opt<bool> PrintImports("print-imports", cl::init(false), cl::Hidden,
 static cl::opt<bool> ComputeDead("compute-dead", cl::init(true), cl::Hidden,
                                  cl::desc("Compute dead symbols"));
 
+static cl::opt<bool> EliminateContractChecks(
+    "thinlto-eliminate-contract-checks", cl::init(true), cl::Hidden,
+    cl::desc("Remove the contract checks on parameters that all the calls in "
+             "the index satisfy"));
+
 static cl::opt<bool> EnableImportMetadata(
     "enable-import-metadata", cl::init(
 #if !defined(NDEBUG)
@@ -503,6 +513,85 @@ void llvm::computeDeadSymbols(
   NumLiveSymbols += LiveSymbols;
 }
 
+/// Return true if the arguments passed to \p Callee by \p Caller always
+/// satisfy \p Check.
+static bool isContractCheckSatisfied(const FunctionSummary &Caller,
+                                     GlobalValue::GUID Callee,
+                                     const FunctionSummary::ContractCheck &Check) {
+  for (auto &CallArgs : Caller.contract_call_args()) {
+    if (CallArgs.Callee != Callee)
+      continue;
+    for (auto &Arg : CallArgs.Args)
+      if (Arg.first == Check.ParamNo)
+        return Arg.second.getBitWidth() == Check.Range.getBitWidth() &&
+               Check.Range.contains(Arg.second);
+    return false;
+  }
+  return false;
+}
+
+void llvm::computeRedundantContractChecks(
+    ModuleSummaryIndex &Index,
+    const DenseSet<GlobalValue::GUID> &GUIDPreservedSymbols) {
+  if (!EliminateContractChecks)
+    return;
+
+  // Collect the functions with contract checks, and those that may be called
+  // from outside of the index: the preserved ones, and those referenced
+  // other than by a direct call or aliased.
+  DenseSet<GlobalValue::GUID> Checked;
+  DenseSet<GlobalValue::GUID> Escaping = GUIDPreservedSymbols;
+  DenseSet<const GlobalValueSummary *> Aliased;
+  for (const auto &Entry : Index)
+    for (auto &S : Entry.second.SummaryList) {
+      for (auto Ref : S->refs())
+        Escaping.insert(Ref.getGUID());
+      if (auto *AS = dyn_cast<AliasSummary>(S.get()))
+        Aliased.insert(&AS->getAliasee());
+      else if (auto *FS = dyn_cast<FunctionSummary>(S.get()))
+        if (!FS->contract_checks().empty())
+          Checked.insert(Entry.first);
+    }
+  if (Checked.empty())
+    return;
+
+  DenseMap<GlobalValue::GUID, SmallVector<const FunctionSummary *, 4>> Callers;
+  for (const auto &Entry : Index)
+    for (auto &S : Entry.second.SummaryList)
+      if (auto *FS = dyn_cast<FunctionSummary>(S.get()))
+        for (auto &Call : FS->calls())
+          if (Checked.count(Call.first.getGUID()))
+            Callers[Call.first.getGUID()].push_back(FS);
+
+  for (auto GUID : Checked) {
+    auto I = Callers.find(GUID);
+    if (Escaping.count(GUID) || I == Callers.end())
+      continue;
+    ValueInfo VI = Index.getValueInfo(GUID);
+    if (any_of(VI.getSummaryList(),
+               [&](const std::unique_ptr<GlobalValueSummary> &S) {
+                 return S->notEligibleToImport() || Aliased.count(S.get());
+               }))
+      continue;
+
+    for (auto &S : VI.getSummaryList()) {
+      auto *FS = dyn_cast<FunctionSummary>(S.get());
+      if (!FS)
+        continue;
+      ArrayRef<FunctionSummary::ContractCheck> Checks = FS->contract_checks();
+      for (unsigned C = 0, E = Checks.size(); C != E; ++C)
+        if (all_of(I->second, [&](const FunctionSummary *Caller) {
+              return isContractCheckSatisfied(*Caller, GUID, Checks[C]);
+            })) {
+          DEBUG(dbgs() << "Redundant contract check on parameter "
+                       << Checks[C].ParamNo << " of " << GUID << "\n");
+          FS->setContractCheckRedundant(C);
+          ++NumRedundantContractChecks;
+        }
+    }
+  }
+}
+
 /// Compute the set of summaries needed for a ThinLTO backend compilation of
 /// \p ModulePath.
 void llvm::gatherImportedSummariesForModule(
@@ -666,6 +755,40 @@ void llvm::thinLTOInternalizeModule(Module &TheModule,
   llvm::internalizeModule(TheModule, MustPreserveGV);
 }
 
+void llvm::thinLTORemoveRedundantContractChecks(
+    Module &TheModule, const GVSummaryMapTy &DefinedGlobals) {
+  auto *CheckDecl = TheModule.getFunction(
+      Intrinsic::getName(Intrinsic::contract_check));
+  if (!CheckDecl)
+    return;
+
+  SmallVector<CallInst *, 8> ToRemove;
+  for (User *U : CheckDecl->users()) {
+    auto *CI = dyn_cast<CallInst>(U);
+    if (!CI)
+      continue;
+    auto GS = DefinedGlobals.find(CI->getFunction()->getGUID());
+    if (GS == DefinedGlobals.end())
+      continue;
+    auto *FS = dyn_cast<FunctionSummary>(GS->second);
+    Optional<FunctionSummary::ContractCheck> Check = getContractParamCheck(*CI);
+    if (!FS || !Check)
+      continue;
+    if (any_of(FS->contract_checks(),
+               [&](const FunctionSummary::ContractCheck &C) {
+                 return C.Redundant && C.ParamNo == Check->ParamNo &&
+                        C.Range == Check->Range;
+               }))
+      ToRemove.push_back(CI);
+  }
+
+  for (CallInst *CI : ToRemove) {
+    CI->replaceAllUsesWith(ConstantInt::getTrue(CI->getContext()));
+    CI->eraseFromParent();
+    ++NumRemovedContractChecks;
+  }
+}
+
 // Automatically import functions in Module \p DestModule based on the summaries
 // index.
 //
@@ -375,6 +375,7 @@ void PassManagerBuilder::addFunctionSimplificationPasses(
   MPM.add(createCorrelatedValuePropagationPass());
   MPM.add(createDeadStoreEliminationPass());  // Delete dead stores
   MPM.add(createLICMPass());
+  MPM.add(createContractCheckEliminationPass()); // Remove redundant contracts
 
   addExtensionsToPM(EP_ScalarOptimizerLate, MPM);
 
@@ -568,6 +569,8 @@ void PassManagerBuilder::populateModulePassManager(
   MPM.add(createGlobalsAAWrapperPass());
 
   MPM.add(createFloat2IntPass());
+  MPM.add(createLoopContractVersioningPass());
+  MPM.add(createLowerContractCheckIntrinsicPass());
 
   addExtensionsToPM(EP_VectorizerStart, MPM);
 
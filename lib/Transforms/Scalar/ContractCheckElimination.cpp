@@ -0,0 +1,348 @@
+//===- ContractCheckElimination.cpp - Remove redundant contracts ----------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Front-ends that check C++ contracts at run time wrap the predicate of each
+// check in a call to @llvm.contract.check and branch on its result to a block
+// that reports the violation.  This pass:
+//
+//  - folds a check to true if its predicate is implied by the conditions on
+//    the dominating branches, by the value ranges computed by LazyValueInfo,
+//    or by ScalarEvolution.  A contract that repeats the precondition of an
+//    inlined callee, or one which the loop bounds already guarantee, is thus
+//    removed;
+//
+//  - hoists a loop-invariant check in a loop header into the preheader, where
+//    it is evaluated once instead of on every iteration.  This is only done if
+//    the violation block does not return, and if nothing observable happens
+//    in the header before the check.
+//
+// The intrinsic is lowered by LowerContractCheckIntrinsic before the late loop
+// optimizations.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/Scalar/ContractCheckElimination.h"
+#include "llvm/ADT/DepthFirstIterator.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Analysis/GlobalsModRef.h"
+#include "llvm/Analysis/LazyValueInfo.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/ScalarEvolution.h"
+#include "llvm/Analysis/ValueTracking.h"
+#include "llvm/IR/CFG.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Transforms/Scalar.h"
+#include "llvm/Transforms/Utils/BasicBlockUtils.h"
+
+using namespace llvm;
+
+#define DEBUG_TYPE "contract-check-elim"
+
+STATISTIC(NumEliminated, "Number of contract checks proven to hold");
+STATISTIC(NumHoisted, "Number of contract checks hoisted out of loops");
+
+static cl::opt<unsigned> MaxDominatingConditions(
+    "contract-check-elim-max-dominators", cl::Hidden, cl::init(16),
+    cl::desc("Maximum number of dominating branches inspected to prove a "
+             "contract check (default = 16)"));
+
+static bool isContractCheck(const Value *V) {
+  if (auto *II = dyn_cast<IntrinsicInst>(V))
+    return II->getIntrinsicID() == Intrinsic::contract_check;
+  return false;
+}
+
+namespace {
+
+class ContractCheckEliminationImpl {
+  DominatorTree &DT;
+  LoopInfo &LI;
+  ScalarEvolution &SE;
+  LazyValueInfo &LVI;
+  const DataLayout &DL;
+
+  /// Whether the IR was changed.  Operands of a check may be hoisted out of a
+  /// loop even if the check itself is not.
+  bool Changed = false;
+
+  /// Whether the CFG was changed, i.e. whether a check was hoisted.
+  bool CFGChanged = false;
+
+  /// Returns true if the predicate of \p Check is known to hold where
+  /// \p Check is evaluated.
+  bool isKnownTrue(IntrinsicInst *Check);
+
+  /// Try to hoist \p Check, which is in the header of a loop, into the
+  /// preheader of that loop.
+  bool hoistOutOfLoop(IntrinsicInst *Check);
+
+public:
+  explicit ContractCheckEliminationImpl(DominatorTree &DT, LoopInfo &LI,
+                                        ScalarEvolution &SE,
+                                        LazyValueInfo &LVI,
+                                        const DataLayout &DL)
+      : DT(DT), LI(LI), SE(SE), LVI(LVI), DL(DL) {}
+
+  /// The entry point for this pass.
+  bool run();
+
+  bool changedCFG() const { return CFGChanged; }
+};
+
+}
+
+bool ContractCheckEliminationImpl::run() {
+  // Visit the checks in dominator order, so that a hoisted check can prove
+  // the checks it dominates.
+  SmallVector<IntrinsicInst *, 16> Checks;
+  for (auto *DTN : depth_first(DT.getRootNode()))
+    for (auto &I : *DTN->getBlock())
+      if (isContractCheck(&I))
+        Checks.push_back(cast<IntrinsicInst>(&I));
+
+  for (auto *Check : Checks) {
+    if (isKnownTrue(Check)) {
+      DEBUG(dbgs() << "Contract check proven: " << *Check << "\n");
+      Check->replaceAllUsesWith(ConstantInt::getTrue(Check->getContext()));
+      Check->eraseFromParent();
+      ++NumEliminated;
+      Changed = true;
+      continue;
+    }
+
+    if (hoistOutOfLoop(Check)) {
+      DEBUG(dbgs() << "Contract check hoisted: " << *Check << "\n");
+      ++NumHoisted;
+      Changed = CFGChanged = true;
+    }
+  }
+
+  return Changed;
+}
+
+bool ContractCheckEliminationImpl::isKnownTrue(IntrinsicInst *Check) {
+  Value *Cond = Check->getArgOperand(0);
+  if (auto *C = dyn_cast<ConstantInt>(Cond))
+    return C->isOne();
+
+  BasicBlock *BB = Check->getParent();
+
+  // Look for a dominating branch on a condition that implies this one.
+  DomTreeNode *Node = DT.getNode(BB)->getIDom();
+  for (unsigned N = 0; Node && N < MaxDominatingConditions;
+       Node = Node->getIDom(), ++N) {
+    BasicBlock *Pred = Node->getBlock();
+    auto *BI = dyn_cast<BranchInst>(Pred->getTerminator());
+    if (!BI || !BI->isConditional() ||
+        BI->getSuccessor(0) == BI->getSuccessor(1))
+      continue;
+
+    Value *BrCond = BI->getCondition();
+    if (isContractCheck(BrCond))
+      BrCond = cast<IntrinsicInst>(BrCond)->getArgOperand(0);
+
+    for (unsigned i = 0; i < 2; ++i)
+      if (DT.dominates(BasicBlockEdge(Pred, BI->getSuccessor(i)), BB))
+        if (Optional<bool> Implied = isImpliedCondition(BrCond, Cond, DL,
+                                                        /*LHSIsTrue=*/i == 0))
+          if (*Implied)
+            return true;
+  }
+
+  // Ask LazyValueInfo about the range of the compared value.
+  if (auto *Cmp = dyn_cast<ICmpInst>(Cond)) {
+    if (auto *C = dyn_cast<Constant>(Cmp->getOperand(1)))
+      if (LVI.getPredicateAt(Cmp->getPredicate(), Cmp->getOperand(0), C,
+                             Check) == LazyValueInfo::True)
+        return true;
+
+    // Ask ScalarEvolution, e.g. about an induction variable compared against
+    // the loop bound.
+    if (SE.isSCEVable(Cmp->getOperand(0)->getType())) {
+      Loop *L = LI.getLoopFor(BB);
+      const SCEV *LHS = SE.getSCEVAtScope(Cmp->getOperand(0), L);
+      const SCEV *RHS = SE.getSCEVAtScope(Cmp->getOperand(1), L);
+      if (SE.isKnownPredicate(Cmp->getPredicate(), LHS, RHS))
+        return true;
+    }
+  } else if (auto *C = dyn_cast_or_null<ConstantInt>(
+                 LVI.getConstant(Cond, BB, Check)))
+    return C->isOne();
+
+  return false;
+}
+
+bool ContractCheckEliminationImpl::hoistOutOfLoop(IntrinsicInst *Check) {
+  // Only the canonical form produced by the front-end is handled:
+  //   br i1 %check, label %contract.cont, label %contract.violation
+  if (!Check->hasOneUse())
+    return false;
+  auto *BI = dyn_cast<BranchInst>(Check->user_back());
+  if (!BI || !BI->isConditional())
+    return false;
+
+  BasicBlock *Header = BI->getParent();
+  Loop *L = LI.getLoopFor(Header);
+  if (!L || L->getHeader() != Header)
+    return false;
+  BasicBlock *Preheader = L->getLoopPreheader();
+  if (!Preheader)
+    return false;
+
+  BasicBlock *ViolationBB = BI->getSuccessor(1);
+  if (L->contains(ViolationBB) || BI->getSuccessor(0) == ViolationBB ||
+      !isa<UnreachableInst>(ViolationBB->getTerminator()))
+    return false;
+
+  // Evaluating the check before entering the loop is only the same as
+  // evaluating it on the first iteration if nothing observable happens in
+  // between.
+  for (auto &I : *Header) {
+    if (&I == BI)
+      break;
+    if (isa<PHINode>(I) || &I == Check)
+      continue;
+    if (I.mayHaveSideEffects() ||
+        !isGuaranteedToTransferExecutionToSuccessor(&I))
+      return false;
+  }
+
+  bool Hoisted = false;
+  auto GiveUp = [&]() {
+    if (Hoisted) {
+      SE.forgetLoopDispositions(L);
+      Changed = true;
+    }
+    return false;
+  };
+  Instruction *InsertPt = Preheader->getTerminator();
+  if (L->contains(Check) &&
+      !L->makeLoopInvariant(Check->getArgOperand(0), Hoisted, InsertPt))
+    return GiveUp();
+
+  // The violation block gains the preheader as a predecessor: the values it
+  // takes from the header must be available there too.
+  for (auto &PN : ViolationBB->phis())
+    if (!L->makeLoopInvariant(PN.getIncomingValueForBlock(Header), Hoisted,
+                              InsertPt))
+      return GiveUp();
+  for (auto &I : *ViolationBB) {
+    if (isa<PHINode>(I))
+      continue;
+    for (Value *Op : I.operands())
+      if (auto *OpI = dyn_cast<Instruction>(Op))
+        if (OpI->getParent() != ViolationBB && !DT.dominates(OpI, InsertPt))
+          return GiveUp();
+  }
+
+  if (Hoisted)
+    SE.forgetLoopDispositions(L);
+
+  // Preheader:
+  //   %check = call i1 @llvm.contract.check(...)
+  //   br i1 %check, label %NewPreheader, label %ViolationBB
+  if (L->contains(Check))
+    Check->moveBefore(InsertPt);
+  BasicBlock *NewPreheader = SplitBlock(Preheader, InsertPt, &DT, &LI);
+  auto *NewBI = BranchInst::Create(NewPreheader, ViolationBB, Check);
+  NewBI->copyMetadata(*BI);
+  ReplaceInstWithInst(Preheader->getTerminator(), NewBI);
+
+  for (auto &PN : ViolationBB->phis())
+    PN.addIncoming(PN.getIncomingValueForBlock(Header), Preheader);
+  DT.changeImmediateDominator(
+      ViolationBB, DT.findNearestCommonDominator(
+                       DT.getNode(ViolationBB)->getIDom()->getBlock(),
+                       Preheader));
+
+  // The edge from the header is dead now; leave it to SimplifyCFG.
+  BI->setCondition(ConstantInt::getTrue(BI->getContext()));
+  return true;
+}
+
+namespace {
+struct ContractCheckEliminationLegacyPass : public FunctionPass {
+  static char ID;
+
+  ContractCheckEliminationLegacyPass() : FunctionPass(ID) {
+    initializeContractCheckEliminationLegacyPassPass(
+        *PassRegistry::getPassRegistry());
+  }
+
+  bool runOnFunction(Function &F) override {
+    if (skipFunction(F))
+      return false;
+    auto *CheckDecl = F.getParent()->getFunction(
+        Intrinsic::getName(Intrinsic::contract_check));
+    if (!CheckDecl || CheckDecl->use_empty())
+      return false;
+    return ContractCheckEliminationImpl(
+               getAnalysis<DominatorTreeWrapperPass>().getDomTree(),
+               getAnalysis<LoopInfoWrapperPass>().getLoopInfo(),
+               getAnalysis<ScalarEvolutionWrapperPass>().getSE(),
+               getAnalysis<LazyValueInfoWrapperPass>().getLVI(),
+               F.getParent()->getDataLayout()).run();
+  }
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.addRequired<DominatorTreeWrapperPass>();
+    AU.addRequired<LoopInfoWrapperPass>();
+    AU.addRequired<ScalarEvolutionWrapperPass>();
+    AU.addRequired<LazyValueInfoWrapperPass>();
+    AU.addPreserved<DominatorTreeWrapperPass>();
+    AU.addPreserved<LoopInfoWrapperPass>();
+    AU.addPreserved<GlobalsAAWrapperPass>();
+  }
+};
+}
+
+PreservedAnalyses ContractCheckEliminationPass::run(Function &F,
+                                                    FunctionAnalysisManager &AM) {
+  auto *CheckDecl = F.getParent()->getFunction(
+      Intrinsic::getName(Intrinsic::contract_check));
+  if (!CheckDecl || CheckDecl->use_empty())
+    return PreservedAnalyses::all();
+
+  auto &DT = AM.getResult<DominatorTreeAnalysis>(F);
+  auto &LI = AM.getResult<LoopAnalysis>(F);
+  auto &SE = AM.getResult<ScalarEvolutionAnalysis>(F);
+  auto &LVI = AM.getResult<LazyValueAnalysis>(F);
+  ContractCheckEliminationImpl Impl(DT, LI, SE, LVI,
+                                    F.getParent()->getDataLayout());
+  if (!Impl.run())
+    return PreservedAnalyses::all();
+
+  PreservedAnalyses PA;
+  if (!Impl.changedCFG())
+    PA.preserveSet<CFGAnalyses>();
+  PA.preserve<DominatorTreeAnalysis>();
+  PA.preserve<LoopAnalysis>();
+  return PA;
+}
+
+char ContractCheckEliminationLegacyPass::ID = 0;
+
+INITIALIZE_PASS_BEGIN(ContractCheckEliminationLegacyPass, "contract-check-elim",
+                      "Eliminate redundant contract checks", false, false)
+INITIALIZE_PASS_DEPENDENCY(DominatorTreeWrapperPass)
+INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
+INITIALIZE_PASS_DEPENDENCY(ScalarEvolutionWrapperPass)
+INITIALIZE_PASS_DEPENDENCY(LazyValueInfoWrapperPass)
+INITIALIZE_PASS_END(ContractCheckEliminationLegacyPass, "contract-check-elim",
+                    "Eliminate redundant contract checks", false, false)
+
+FunctionPass *llvm::createContractCheckEliminationPass() {
+  return new ContractCheckEliminationLegacyPass();
+}
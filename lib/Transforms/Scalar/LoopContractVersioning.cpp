@@ -0,0 +1,416 @@
+//===- LoopContractVersioning.cpp - Version loops on contract checks ------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Once an accessor like
+//
+//   T &at(size_t i) [[expects: i < size()]];
+//
+// is inlined into a loop, every iteration evaluates the precondition and
+// branches to the violation handler if it fails.  The extra exit blocks the
+// vectorizer.
+//
+// For each contract check in an inner-most loop that compares an affine
+// induction variable against a loop-invariant bound, the predicate holds on
+// every iteration iff it holds on the first and on the last one (the values of
+// the induction variable in between lie on a line).  This pass emits that test
+// in the preheader and versions the loop on it:
+//
+//   - the original loop, with all the contract checks folded to true, runs if
+//     the test succeeds;
+//   - a copy of the loop with the checks in place runs otherwise, so that the
+//     violation is reported in the same iteration as before.
+//
+// The value of the induction variable in the last iteration is computed in a
+// type twice as wide, which also proves that the induction variable does not
+// wrap.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/Scalar/LoopContractVersioning.h"
+#include "llvm/ADT/DepthFirstIterator.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Analysis/AssumptionCache.h"
+#include "llvm/Analysis/GlobalsModRef.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/ScalarEvolution.h"
+#include "llvm/Analysis/ScalarEvolutionExpander.h"
+#include "llvm/Analysis/ScalarEvolutionExpressions.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/MDBuilder.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Transforms/Scalar.h"
+#include "llvm/Transforms/Utils/BasicBlockUtils.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/Local.h"
+#include "llvm/Transforms/Utils/LoopSimplify.h"
+#include "llvm/Transforms/Utils/LoopUtils.h"
+
+using namespace llvm;
+
+#define DEBUG_TYPE "loop-contract-versioning"
+
+STATISTIC(NumVersioned, "Number of loops versioned on contract checks");
+STATISTIC(NumChecksHoisted, "Number of contract checks removed from loops");
+
+static cl::opt<unsigned> MaxChecksPerLoop(
+    "loop-contract-versioning-max-checks", cl::Hidden, cl::init(8),
+    cl::desc("Maximum number of contract checks in a loop for it to be "
+             "versioned (default = 8)"));
+
+namespace {
+
+/// A contract check on an induction variable, i.e.
+///   llvm.contract.check(icmp Pred IV, Bound)
+/// where IV is an affine recurrence and Bound is loop-invariant.
+struct InductionCheck {
+  IntrinsicInst *Check;
+  ICmpInst::Predicate Pred;
+  const SCEVAddRecExpr *IV;
+  const SCEV *Bound;
+};
+
+class LoopContractVersioningImpl {
+  Loop *L;
+  LoopInfo &LI;
+  DominatorTree &DT;
+  ScalarEvolution &SE;
+
+  /// Upper bound on the number of times the backedge is taken.
+  const SCEV *MaxBackedgeCount = nullptr;
+
+  SmallVector<InductionCheck, 4> Checks;
+
+  /// Returns false if \p Check is not a check on an induction variable that
+  /// can be tested in the preheader.
+  bool analyzeCheck(IntrinsicInst *Check);
+
+  /// Emits the test that all the checks hold on every iteration before
+  /// \p InsertPt.
+  Value *expandRuntimeTest(Instruction *InsertPt);
+
+public:
+  LoopContractVersioningImpl(Loop *L, LoopInfo &LI, DominatorTree &DT,
+                             ScalarEvolution &SE)
+      : L(L), LI(LI), DT(DT), SE(SE) {}
+
+  bool processLoop();
+};
+
+} // end anonymous namespace
+
+bool LoopContractVersioningImpl::analyzeCheck(IntrinsicInst *Check) {
+  // The check must guard an exit from the loop.
+  if (!Check->hasOneUse())
+    return false;
+  auto *BI = dyn_cast<BranchInst>(Check->user_back());
+  if (!BI || !BI->isConditional() || !L->contains(BI->getSuccessor(0)) ||
+      L->contains(BI->getSuccessor(1)))
+    return false;
+
+  auto *Cmp = dyn_cast<ICmpInst>(Check->getArgOperand(0));
+  if (!Cmp || Cmp->isEquality() ||
+      !Cmp->getOperand(0)->getType()->isIntegerTy())
+    return false;
+
+  ICmpInst::Predicate Pred = Cmp->getPredicate();
+  const SCEV *LHS = SE.getSCEV(Cmp->getOperand(0));
+  const SCEV *RHS = SE.getSCEV(Cmp->getOperand(1));
+  if (!isa<SCEVAddRecExpr>(LHS)) {
+    std::swap(LHS, RHS);
+    Pred = ICmpInst::getSwappedPredicate(Pred);
+  }
+
+  auto *IV = dyn_cast<SCEVAddRecExpr>(LHS);
+  if (!IV || IV->getLoop() != L || !IV->isAffine() ||
+      !SE.isLoopInvariant(RHS, L))
+    return false;
+
+  // Keep the induction variable far from overflowing the wide type.
+  auto *Step = dyn_cast<SCEVConstant>(IV->getStepRecurrence(SE));
+  if (!Step || Step->getAPInt().getMinSignedBits() > 16)
+    return false;
+
+  if (!isSafeToExpand(IV->getStart(), SE) || !isSafeToExpand(RHS, SE))
+    return false;
+
+  Checks.push_back({Check, Pred, IV, RHS});
+  return true;
+}
+
+Value *LoopContractVersioningImpl::expandRuntimeTest(Instruction *InsertPt) {
+  const DataLayout &DL = InsertPt->getModule()->getDataLayout();
+  SCEVExpander Exp(SE, DL, "contract.check");
+  IRBuilder<> Builder(InsertPt);
+  Value *Safe = nullptr;
+
+  for (auto &C : Checks) {
+    auto *Ty = cast<IntegerType>(C.IV->getType());
+    unsigned Width =
+        std::max(Ty->getBitWidth(),
+                 (unsigned)SE.getTypeSizeInBits(MaxBackedgeCount->getType()));
+    auto *WideTy = IntegerType::get(Ty->getContext(),
+                                    std::max(64U, 2 * Width));
+    bool Signed = ICmpInst::isSigned(C.Pred);
+    auto Extend = [&](const SCEV *S) {
+      return Signed ? SE.getSignExtendExpr(S, WideTy)
+                    : SE.getZeroExtendExpr(S, WideTy);
+    };
+
+    // Start + MaxBackedgeCount * Step cannot overflow WideTy.
+    const SCEV *Start = Extend(C.IV->getStart());
+    const SCEV *Step = SE.getSignExtendExpr(C.IV->getStepRecurrence(SE),
+                                            WideTy);
+    const SCEV *Last = SE.getAddExpr(
+        Start, SE.getMulExpr(SE.getZeroExtendExpr(MaxBackedgeCount, WideTy),
+                             Step));
+
+    APInt Min = Signed ? APInt::getSignedMinValue(Ty->getBitWidth())
+                       : APInt::getMinValue(Ty->getBitWidth());
+    APInt Max = Signed ? APInt::getSignedMaxValue(Ty->getBitWidth())
+                       : APInt::getMaxValue(Ty->getBitWidth());
+    Min = Signed ? Min.sext(WideTy->getBitWidth())
+                 : Min.zext(WideTy->getBitWidth());
+    Max = Signed ? Max.sext(WideTy->getBitWidth())
+                 : Max.zext(WideTy->getBitWidth());
+
+    // All the values are sign- or zero-extended to the wide type, where they
+    // compare the same as signed integers.
+    ICmpInst::Predicate Pred = ICmpInst::getSignedPredicate(C.Pred);
+    Value *StartV = Exp.expandCodeFor(Start, WideTy, InsertPt);
+    Value *LastV = Exp.expandCodeFor(Last, WideTy, InsertPt);
+    Value *BoundV = Exp.expandCodeFor(Extend(C.Bound), WideTy, InsertPt);
+
+    Value *Tests[] = {
+        Builder.CreateICmp(Pred, StartV, BoundV),
+        Builder.CreateICmp(Pred, LastV, BoundV),
+        Builder.CreateICmpSGE(LastV, ConstantInt::get(WideTy, Min)),
+        Builder.CreateICmpSLE(LastV, ConstantInt::get(WideTy, Max))};
+    for (Value *Test : Tests)
+      Safe = Safe ? Builder.CreateAnd(Safe, Test) : Test;
+  }
+
+  Safe->setName("contract.safe");
+  return Safe;
+}
+
+bool LoopContractVersioningImpl::processLoop() {
+  DEBUG(dbgs() << "\nLoopContractVersioning: checking " << *L << "\n");
+  if (!L->isLoopSimplifyForm())
+    return false;
+
+  // Any exit that dominates the latch bounds the number of iterations.  The
+  // exits guarded by contract checks are not analyzable by SCEV.
+  SmallVector<BasicBlock *, 8> ExitingBlocks;
+  L->getExitingBlocks(ExitingBlocks);
+  for (BasicBlock *BB : ExitingBlocks) {
+    if (!DT.dominates(BB, L->getLoopLatch()))
+      continue;
+    const SCEV *Count = SE.getExitCount(L, BB);
+    if (!isa<SCEVCouldNotCompute>(Count) && isSafeToExpand(Count, SE)) {
+      MaxBackedgeCount = Count;
+      break;
+    }
+  }
+  if (!MaxBackedgeCount) {
+    DEBUG(dbgs() << "Unknown trip count.\n");
+    return false;
+  }
+
+  for (BasicBlock *BB : L->blocks())
+    for (Instruction &I : *BB)
+      if (auto *II = dyn_cast<IntrinsicInst>(&I))
+        if (II->getIntrinsicID() == Intrinsic::contract_check &&
+            !analyzeCheck(II)) {
+          // The versioned loop would still not be vectorizable.
+          DEBUG(dbgs() << "Not a check on an induction variable: " << *II
+                       << "\n");
+          return false;
+        }
+
+  if (Checks.empty())
+    return false;
+  if (Checks.size() > MaxChecksPerLoop) {
+    DEBUG(dbgs() << "Too many contract checks.\n");
+    return false;
+  }
+
+  Function *F = L->getHeader()->getParent();
+  if (F->optForSize())
+    return false;
+
+  // Point of no-return, start the transformation.
+  formLCSSA(*L, DT, &LI, &SE);
+
+  // The copy shares the exit blocks of the loop, which are no longer
+  // dedicated once it is made.
+  SmallVector<BasicBlock *, 8> ExitBlocks;
+  L->getUniqueExitBlocks(ExitBlocks);
+
+  BasicBlock *RuntimeCheckBB = L->getLoopPreheader();
+  Value *Safe = expandRuntimeTest(RuntimeCheckBB->getTerminator());
+  RuntimeCheckBB->setName(L->getHeader()->getName() + ".contract.check");
+
+  BasicBlock *PH =
+      SplitBlock(RuntimeCheckBB, RuntimeCheckBB->getTerminator(), &DT, &LI);
+  PH->setName(L->getHeader()->getName() + ".ph");
+
+  // The copy keeps the checks, and runs if any of them is going to fail.
+  ValueToValueMapTy VMap;
+  SmallVector<BasicBlock *, 8> CheckedLoopBlocks;
+  Loop *CheckedLoop =
+      cloneLoopWithPreheader(PH, RuntimeCheckBB, L, VMap, ".contract.orig",
+                             &LI, &DT, CheckedLoopBlocks);
+  remapInstructionsInBlocks(CheckedLoopBlocks, VMap);
+
+  Instruction *OrigTerm = RuntimeCheckBB->getTerminator();
+  auto *BI = BranchInst::Create(L->getLoopPreheader(),
+                                CheckedLoop->getLoopPreheader(), Safe,
+                                OrigTerm);
+  OrigTerm->eraseFromParent();
+  MDBuilder MDB(BI->getContext());
+  BI->setMetadata(LLVMContext::MD_prof,
+                  MDB.createBranchWeights((1U << 20) - 1, 1));
+
+  // The loops merge in the exit blocks.  As the loop is in LCSSA form, only
+  // the PHIs there refer to values defined in the loop.
+  for (BasicBlock *Exit : ExitBlocks)
+    for (PHINode &PN : Exit->phis())
+      for (unsigned i = 0, e = PN.getNumIncomingValues(); i != e; ++i) {
+        BasicBlock *Pred = PN.getIncomingBlock(i);
+        if (!L->contains(Pred))
+          continue;
+        // If the definition was cloned use that, otherwise use the same value.
+        Value *ClonedValue = PN.getIncomingValue(i);
+        auto Mapped = VMap.find(ClonedValue);
+        if (Mapped != VMap.end())
+          ClonedValue = Mapped->second;
+        PN.addIncoming(ClonedValue, cast<BasicBlock>(VMap[Pred]));
+      }
+
+  // Remove the checks, and the exits they guard, from the original loop.
+  for (auto &C : Checks) {
+    BasicBlock *BB = C.Check->getParent();
+    C.Check->replaceAllUsesWith(ConstantInt::getTrue(C.Check->getContext()));
+    C.Check->eraseFromParent();
+    ConstantFoldTerminator(BB);
+    MergeBlockIntoPredecessor(BB->getSingleSuccessor(), nullptr, &LI);
+  }
+  DT.recalculate(*F);
+  SE.forgetLoop(L);
+
+  DEBUG(dbgs() << "Versioned loop on " << Checks.size()
+               << " contract check(s).\n");
+  ++NumVersioned;
+  NumChecksHoisted += Checks.size();
+  return true;
+}
+
+static bool versionLoopsOnContracts(Function &F, LoopInfo &LI,
+                                    DominatorTree &DT, ScalarEvolution &SE,
+                                    AssumptionCache &AC) {
+  // Check if we can cheaply rule out the possibility of not having any work to
+  // do.
+  auto *CheckDecl = F.getParent()->getFunction(
+      Intrinsic::getName(Intrinsic::contract_check));
+  if (!CheckDecl || CheckDecl->use_empty())
+    return false;
+
+  // The loops must be in simplified form.  As in the vectorizer, this is done
+  // before looking for inner loops, as simplification may add new ones.
+  bool Changed = false;
+  for (Loop *L : LI)
+    Changed |= simplifyLoop(L, &DT, &LI, &SE, &AC, /*PreserveLCSSA=*/false);
+
+  // Build up a worklist of inner-loops to version, as versioning adds loops.
+  SmallVector<Loop *, 8> Worklist;
+  for (Loop *TopLevelLoop : LI)
+    for (Loop *L : depth_first(TopLevelLoop))
+      if (L->empty())
+        Worklist.push_back(L);
+
+  for (Loop *L : Worklist)
+    Changed |= LoopContractVersioningImpl(L, LI, DT, SE).processLoop();
+  return Changed;
+}
+
+namespace {
+class LoopContractVersioningLegacyPass : public FunctionPass {
+public:
+  static char ID;
+
+  LoopContractVersioningLegacyPass() : FunctionPass(ID) {
+    initializeLoopContractVersioningLegacyPassPass(
+        *PassRegistry::getPassRegistry());
+  }
+
+  bool runOnFunction(Function &F) override {
+    if (skipFunction(F))
+      return false;
+
+    auto &LI = getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
+    auto &DT = getAnalysis<DominatorTreeWrapperPass>().getDomTree();
+    auto &SE = getAnalysis<ScalarEvolutionWrapperPass>().getSE();
+    auto &AC = getAnalysis<AssumptionCacheTracker>().getAssumptionCache(F);
+    return versionLoopsOnContracts(F, LI, DT, SE, AC);
+  }
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.addRequired<LoopInfoWrapperPass>();
+    AU.addPreserved<LoopInfoWrapperPass>();
+    AU.addRequired<DominatorTreeWrapperPass>();
+    AU.addPreserved<DominatorTreeWrapperPass>();
+    AU.addRequired<ScalarEvolutionWrapperPass>();
+    AU.addRequired<AssumptionCacheTracker>();
+    AU.addPreserved<GlobalsAAWrapperPass>();
+  }
+};
+} // end anonymous namespace
+
+char LoopContractVersioningLegacyPass::ID = 0;
+
+INITIALIZE_PASS_BEGIN(LoopContractVersioningLegacyPass,
+                      "loop-contract-versioning",
+                      "Version loops on contract checks", false, false)
+INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
+INITIALIZE_PASS_DEPENDENCY(DominatorTreeWrapperPass)
+INITIALIZE_PASS_DEPENDENCY(ScalarEvolutionWrapperPass)
+INITIALIZE_PASS_DEPENDENCY(AssumptionCacheTracker)
+INITIALIZE_PASS_END(LoopContractVersioningLegacyPass,
+                    "loop-contract-versioning",
+                    "Version loops on contract checks", false, false)
+
+FunctionPass *llvm::createLoopContractVersioningPass() {
+  return new LoopContractVersioningLegacyPass();
+}
+
+PreservedAnalyses LoopContractVersioningPass::run(Function &F,
+                                                  FunctionAnalysisManager &AM) {
+  auto *CheckDecl = F.getParent()->getFunction(
+      Intrinsic::getName(Intrinsic::contract_check));
+  if (!CheckDecl || CheckDecl->use_empty())
+    return PreservedAnalyses::all();
+
+  auto &LI = AM.getResult<LoopAnalysis>(F);
+  auto &DT = AM.getResult<DominatorTreeAnalysis>(F);
+  auto &SE = AM.getResult<ScalarEvolutionAnalysis>(F);
+  auto &AC = AM.getResult<AssumptionAnalysis>(F);
+  if (!versionLoopsOnContracts(F, LI, DT, SE, AC))
+    return PreservedAnalyses::all();
+
+  PreservedAnalyses PA;
+  PA.preserve<LoopAnalysis>();
+  PA.preserve<DominatorTreeAnalysis>();
+  return PA;
+}
@@ -0,0 +1,93 @@
+//===- LowerContractCheckIntrinsic.cpp - Lower contract checks -----------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This pass replaces each call to llvm.contract.check by its predicate.  Once
+// this happens, the check can no longer be told apart from ordinary control
+// flow.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/Scalar/LowerContractCheckIntrinsic.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Analysis/GlobalsModRef.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Intrinsics.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Transforms/Scalar.h"
+
+using namespace llvm;
+
+namespace {
+struct LowerContractCheckIntrinsicLegacyPass : public FunctionPass {
+  static char ID;
+  LowerContractCheckIntrinsicLegacyPass() : FunctionPass(ID) {
+    initializeLowerContractCheckIntrinsicLegacyPassPass(
+        *PassRegistry::getPassRegistry());
+  }
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.setPreservesCFG();
+    AU.addPreserved<GlobalsAAWrapperPass>();
+  }
+
+  bool runOnFunction(Function &F) override;
+};
+}
+
+static bool lowerContractCheckIntrinsic(Function &F) {
+  // Check if we can cheaply rule out the possibility of not having any work to
+  // do.
+  auto *CheckDecl = F.getParent()->getFunction(
+      Intrinsic::getName(Intrinsic::contract_check));
+  if (!CheckDecl || CheckDecl->use_empty())
+    return false;
+
+  SmallVector<CallInst *, 8> ToLower;
+  for (auto &I : instructions(F))
+    if (auto *CI = dyn_cast<CallInst>(&I))
+      if (auto *F = CI->getCalledFunction())
+        if (F->getIntrinsicID() == Intrinsic::contract_check)
+          ToLower.push_back(CI);
+
+  if (ToLower.empty())
+    return false;
+
+  for (auto *CI : ToLower) {
+    CI->replaceAllUsesWith(CI->getArgOperand(0));
+    CI->eraseFromParent();
+  }
+
+  return true;
+}
+
+bool LowerContractCheckIntrinsicLegacyPass::runOnFunction(Function &F) {
+  return lowerContractCheckIntrinsic(F);
+}
+
+char LowerContractCheckIntrinsicLegacyPass::ID = 0;
+INITIALIZE_PASS(LowerContractCheckIntrinsicLegacyPass, "lower-contract-check",
+                "Lower the contract check intrinsic to its predicate", false,
+                false)
+
+FunctionPass *llvm::createLowerContractCheckIntrinsicPass() {
+  return new LowerContractCheckIntrinsicLegacyPass();
+}
+
+PreservedAnalyses
+LowerContractCheckIntrinsicPass::run(Function &F, FunctionAnalysisManager &AM) {
+  if (!lowerContractCheckIntrinsic(F))
+    return PreservedAnalyses::all();
+
+  PreservedAnalyses PA;
+  PA.preserveSet<CFGAnalyses>();
+  return PA;
+}
@@ -0,0 +1,250 @@
+/*===- contracts_decode.c - Contract violation site decoding --------------===*\
+|*
+|*                     The LLVM Compiler Infrastructure
+|*
+|* This file is distributed under the University of Illinois Open Source
+|* License. See LICENSE.TXT for details.
+|*
+\*===----------------------------------------------------------------------===*/
+
+/* Runtime support for clang -fcontract-violation-site-ids.
+ *
+ * The violation handler of such modules only gets the 32-bit site id of the
+ * violated check.  The line, file, function, comment and level of each check
+ * are in the .llvm_contract_info section, which is not loaded: on the first
+ * violation, the section is read from the files of the program and of the
+ * shared libraries it has loaded, and is kept in memory to decode the
+ * following ones.  The sites that cannot be found (e.g. the section was
+ * stripped) are reported as "??", as are the ids that several modules give to
+ * different sites (the ids are hashes, only unique within a module).
+ */
+
+#define _GNU_SOURCE
+#include <elf.h>
+#include <fcntl.h>
+#include <link.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "contracts_internal.h"
+
+#define CONTRACT_INFO_SECTION ".llvm_contract_info"
+#define CONTRACT_INFO_VERSION 1
+
+/* Blob emitted by clang in each module (see
+ * CodeGenModule::EmitContractViolationInfo), followed by NumSites sites and
+ * StrTabSize bytes of strings.  The linker concatenates those of all the
+ * modules of a file. */
+typedef struct {
+  uint32_t Version;
+  uint32_t NumSites;
+  uint32_t StrTabSize;
+} InfoHeader;
+
+/* Site id, then the entry passed to the handler: line, and offsets in the
+ * strings of the file, function, comment and level. */
+typedef uint32_t Site[6];
+
+typedef struct {
+  char *Data;
+  uint64_t Size;
+} Section;
+
+static Section *Sections;
+static uint32_t NumSections;
+static pthread_once_t LoadOnce = PTHREAD_ONCE_INIT;
+
+static const uint32_t UnknownEntry[5] = {0, 0, 0, 3, 3};
+static const char UnknownStrTab[] = "??\0";
+
+static int readAt(int Fd, void *Buf, uint64_t Size, uint64_t Offset) {
+  char *P = (char *)Buf;
+  while (Size) {
+    ssize_t N = pread(Fd, P, Size, Offset);
+    if (N <= 0)
+      return -1;
+    P += N;
+    Size -= N;
+    Offset += N;
+  }
+  return 0;
+}
+
+void __contract_read_section(const char *Path, const char *Name,
+                             uintptr_t Base, ContractSectionCallback Callback) {
+  ElfW(Ehdr) Ehdr;
+  ElfW(Shdr) *Shdrs = NULL;
+  char *Names = NULL;
+  int Fd = open(Path, O_RDONLY | O_CLOEXEC);
+  if (Fd < 0)
+    return;
+
+  if (readAt(Fd, &Ehdr, sizeof(Ehdr), 0) ||
+      memcmp(Ehdr.e_ident, ELFMAG, SELFMAG) ||
+      Ehdr.e_shentsize != sizeof(ElfW(Shdr)) || Ehdr.e_shstrndx >= Ehdr.e_shnum)
+    goto done;
+
+  Shdrs = (ElfW(Shdr) *)malloc(Ehdr.e_shnum * sizeof(ElfW(Shdr)));
+  if (!Shdrs ||
+      readAt(Fd, Shdrs, Ehdr.e_shnum * sizeof(ElfW(Shdr)), Ehdr.e_shoff))
+    goto done;
+
+  const ElfW(Shdr) *NamesHdr = &Shdrs[Ehdr.e_shstrndx];
+  Names = (char *)malloc(NamesHdr->sh_size + 1);
+  if (!Names || readAt(Fd, Names, NamesHdr->sh_size, NamesHdr->sh_offset))
+    goto done;
+  Names[NamesHdr->sh_size] = '\0';
+
+  for (unsigned I = 0; I < Ehdr.e_shnum; ++I) {
+    const ElfW(Shdr) *Shdr = &Shdrs[I];
+    if (Shdr->sh_name >= NamesHdr->sh_size ||
+        strcmp(Names + Shdr->sh_name, Name))
+      continue;
+    char *Data = (char *)malloc(Shdr->sh_size);
+    if (!Data || readAt(Fd, Data, Shdr->sh_size, Shdr->sh_offset)) {
+      free(Data);
+      break;
+    }
+    Callback(Data, Shdr->sh_size, Base);
+    break;
+  }
+
+done:
+  free(Names);
+  free(Shdrs);
+  close(Fd);
+}
+
+typedef struct {
+  const char *Name;
+  ContractSectionCallback Callback;
+} ReadRequest;
+
+/* The main program comes first, with no name. */
+static const char *getObjectPath(const struct dl_phdr_info *Info) {
+  if (!Info->dlpi_name || !*Info->dlpi_name)
+    return "/proc/self/exe";
+  return Info->dlpi_name;
+}
+
+static int readObjectSection(struct dl_phdr_info *Info, size_t Size,
+                             void *Data) {
+  const ReadRequest *Req = (const ReadRequest *)Data;
+  (void)Size;
+  __contract_read_section(getObjectPath(Info), Req->Name, Info->dlpi_addr,
+                          Req->Callback);
+  return 0;
+}
+
+void __contract_read_sections(const char *Name,
+                              ContractSectionCallback Callback) {
+  ReadRequest Req = {Name, Callback};
+  dl_iterate_phdr(readObjectSection, &Req);
+}
+
+typedef struct {
+  uintptr_t Addr;
+  const char *Path;
+  uintptr_t Base;
+} FindRequest;
+
+static int findObject(struct dl_phdr_info *Info, size_t Size, void *Data) {
+  FindRequest *Req = (FindRequest *)Data;
+  (void)Size;
+  for (unsigned I = 0; I < Info->dlpi_phnum; ++I) {
+    const ElfW(Phdr) *Phdr = &Info->dlpi_phdr[I];
+    uintptr_t Start = Info->dlpi_addr + Phdr->p_vaddr;
+    if (Phdr->p_type == PT_LOAD && Req->Addr >= Start &&
+        Req->Addr - Start < Phdr->p_memsz) {
+      Req->Path = getObjectPath(Info);
+      Req->Base = Info->dlpi_addr;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int __contract_find_object(const void *Addr, const char **Path,
+                           uintptr_t *Base) {
+  FindRequest Req = {(uintptr_t)Addr, NULL, 0};
+  if (!dl_iterate_phdr(findObject, &Req))
+    return 0;
+  *Path = Req.Path;
+  *Base = Req.Base;
+  return 1;
+}
+
+static void addSection(char *Data, uint64_t Size, uintptr_t Base) {
+  (void)Base;
+  Section *New = (Section *)realloc(Sections,
+                                    (NumSections + 1) * sizeof(Section));
+  if (!New) {
+    free(Data);
+    return;
+  }
+  Sections = New;
+  Sections[NumSections].Data = Data;
+  Sections[NumSections++].Size = Size;
+}
+
+static void loadSections(void) {
+  __contract_read_sections(CONTRACT_INFO_SECTION, addSection);
+}
+
+/* Returns true if the entries A and B, of the string tables StrTabA and
+ * StrTabB, describe the same site. */
+static int isSameSite(const uint32_t *A, const char *StrTabA,
+                      const uint32_t *B, const char *StrTabB) {
+  if (A[0] != B[0])
+    return 0;
+  for (unsigned I = 1; I < 5; ++I)
+    if (strcmp(StrTabA + A[I], StrTabB + B[I]))
+      return 0;
+  return 1;
+}
+
+/* Called by __builtin_violation_handler() with the id of the violated site;
+ * returns its entry, and sets *StrTab to the strings it refers to. */
+const uint32_t *__contract_violation_decode(uint32_t Id, const char **StrTab) {
+  pthread_once(&LoadOnce, loadSections);
+
+  /* A site checked in several modules is found in each of them. */
+  const uint32_t *Found = NULL;
+  const char *FoundStrTab = NULL;
+  for (uint32_t S = 0; S < NumSections; ++S) {
+    const char *P = Sections[S].Data, *End = P + Sections[S].Size;
+    while ((uint64_t)(End - P) >= sizeof(InfoHeader)) {
+      const InfoHeader *H = (const InfoHeader *)P;
+      uint64_t SitesSize = (uint64_t)H->NumSites * sizeof(Site);
+      if (H->Version != CONTRACT_INFO_VERSION ||
+          (uint64_t)(End - P) < sizeof(InfoHeader) + SitesSize + H->StrTabSize)
+        break;
+      const Site *Sites = (const Site *)(H + 1);
+      const char *Strings = (const char *)(Sites + H->NumSites);
+      for (uint32_t I = 0; I < H->NumSites; ++I) {
+        if (Sites[I][0] != Id)
+          continue;
+        if (!Found) {
+          Found = &Sites[I][1];
+          FoundStrTab = Strings;
+        } else if (!isSameSite(Found, FoundStrTab, &Sites[I][1], Strings)) {
+          /* Colliding ids: the violated site is ambiguous. */
+          goto unknown;
+        }
+      }
+      P += sizeof(InfoHeader) + SitesSize + H->StrTabSize;
+    }
+  }
+
+  if (Found) {
+    *StrTab = FoundStrTab;
+    return Found;
+  }
+unknown:
+  *StrTab = UnknownStrTab;
+  return UnknownEntry;
+}
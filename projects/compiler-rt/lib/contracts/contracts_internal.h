@@ -0,0 +1,40 @@
+/*===- contracts_internal.h - Contracts runtime internals -----------------===*\
+|*
+|*                     The LLVM Compiler Infrastructure
+|*
+|* This file is distributed under the University of Illinois Open Source
+|* License. See LICENSE.TXT for details.
+|*
+\*===----------------------------------------------------------------------===*/
+
+#ifndef CONTRACTS_INTERNAL_H
+#define CONTRACTS_INTERNAL_H
+
+#include <stdint.h>
+
+/* Called by __contract_read_section[s]() with the contents of a section, which
+ * it owns, and the address its file is loaded at. */
+typedef void (*ContractSectionCallback)(char *Data, uint64_t Size,
+                                        uintptr_t Base);
+
+/* Passes the contents of the section Name of the ELF file Path, loaded at
+ * Base, if any, to Callback. */
+void __contract_read_section(const char *Path, const char *Name,
+                             uintptr_t Base, ContractSectionCallback Callback);
+
+/* Reads the section Name of the files of the program and of the shared
+ * libraries it has loaded (see contracts_decode.c). */
+void __contract_read_sections(const char *Name,
+                              ContractSectionCallback Callback);
+
+/* Sets *Path to the file of the program or of the shared library that Addr
+ * is in, and *Base to the address it is loaded at.  Returns 0 if Addr is in
+ * none of them. */
+int __contract_find_object(const void *Addr, const char **Path,
+                           uintptr_t *Base);
+
+/* Returns the entry of the site Id in the .llvm_contract_info sections, and
+ * sets *StrTab to the strings it refers to (see contracts_decode.c). */
+const uint32_t *__contract_violation_decode(uint32_t Id, const char **StrTab);
+
+#endif /* CONTRACTS_INTERNAL_H */
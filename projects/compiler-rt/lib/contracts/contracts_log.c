@@ -0,0 +1,417 @@
+/*===- contracts_log.c - Contract violation logging runtime ---------------===*\
+|*
+|*                     The LLVM Compiler Infrastructure
+|*
+|* This file is distributed under the University of Illinois Open Source
+|* License. See LICENSE.TXT for details.
+|*
+\*===----------------------------------------------------------------------===*/
+
+/* Runtime support for clang -fcontract-violation-log.
+ *
+ * Each module registers its __contract_violation_tab at start-up, and
+ * __builtin_violation_handler() calls __contract_violation_log() with the
+ * index of the violated check.  The violation path neither locks nor
+ * allocates, so that it can be reached from a signal handler or a hot loop
+ * running with -fcontinue-after-violation: the record (site and timestamp) is
+ * queued in a bounded lock-free ring buffer of the calling thread, and a
+ * background thread appends the queued records to a memory-mapped binary log
+ * (see llvm/ProfileData/ContractViolationLog.h for its layout), which
+ * `llvm-profdata contract-log' decodes against the registered tables.
+ *
+ * Environment:
+ *   LLVM_CONTRACT_VIOLATION_LOG_FILE  the log file (default.contractlog); %p
+ *                                     is replaced by the process id
+ *   LLVM_CONTRACT_VIOLATION_LOG_RATE  violations logged per site and second
+ *                                     (100); the others are only counted.  0
+ *                                     disables the limit
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Per-module descriptor emitted by clang (see
+ * CodeGenModule::EmitCXXContractDependencies). */
+typedef struct __contract_log_module {
+  struct __contract_log_module *Next;
+  uint32_t NumSites;
+  /* Index of the module in the log, assigned at registration */
+  uint32_t Index;
+  /* __contract_violation_tab: line, and offsets in StrTab of the file,
+   * function, comment and level strings */
+  const uint32_t (*Table)[5];
+  const char *StrTab;
+  /* Per site: second of the last violation << 32 | violations in it */
+  uint64_t *Rate;
+} __contract_log_module;
+
+/* Log records; each of them is a multiple of 8 bytes long. */
+enum { LOG_END = 0, LOG_MODULE = 1, LOG_VIOLATION = 2, LOG_DROPPED = 3 };
+
+typedef struct {
+  char Magic[8];
+  uint32_t Version;
+  uint32_t Reserved;
+} LogHeader;
+
+/* Followed by NumSites table entries and StrTabSize bytes of strings,
+ * zero-padded to a multiple of 8 bytes. */
+typedef struct {
+  uint32_t Kind;
+  uint32_t Module;
+  uint32_t NumSites;
+  uint32_t StrTabSize;
+} ModuleRecord;
+
+/* LOG_VIOLATION: Count is 1.  LOG_DROPPED: Count violations of the site were
+ * not logged up to Time; Module and Site are ~0U for the violations lost to a
+ * full ring buffer. */
+typedef struct {
+  uint32_t Kind;
+  uint32_t Module;
+  uint32_t Site;
+  uint32_t Count;
+  uint64_t Time;
+} SiteRecord;
+
+#define LOG_VERSION 1
+#define LOG_GROWTH (1 << 20)
+#define FLUSH_INTERVAL_NS 100000000L
+
+/* Bounded multi-producer ring buffers (D. Vyukov's queue, with the sequence
+ * numbers offset so that an all-zero ring is empty).  A slot is free for the
+ * position Pos when its sequence number is the lap of Pos, i.e.
+ * Pos & ~RING_MASK, and holds a record once it is the lap plus one. Each
+ * thread is given a ring of its own, shared only when there are more threads
+ * than rings; only the thread holding FlushLock consumes. */
+#define NUM_RINGS 64
+#define RING_SIZE 256
+#define RING_MASK ((uint64_t)RING_SIZE - 1)
+
+typedef struct {
+  uint64_t Seq;
+  SiteRecord Rec;
+} Slot;
+
+typedef struct {
+  uint64_t Tail __attribute__((aligned(64)));
+  uint64_t Head __attribute__((aligned(64)));
+  Slot Slots[RING_SIZE];
+} Ring;
+
+static Ring Rings[NUM_RINGS];
+static uint32_t NextRing;
+static __thread uint32_t ThreadRing __attribute__((tls_model("initial-exec")));
+static uint64_t LostToFullRings;
+
+static __contract_log_module *Modules;
+static uint32_t NumModules;
+static uint32_t RateLimit = 100;
+
+static int FlushLock;
+static int LogFd = -1;
+static char *LogMap;
+static uint64_t LogMapSize, LogSize;
+
+static uint64_t now(void) {
+  struct timespec TS;
+  clock_gettime(CLOCK_REALTIME, &TS);
+  return (uint64_t)TS.tv_sec * 1000000000 + TS.tv_nsec;
+}
+
+static Ring *getThreadRing(void) {
+  if (!ThreadRing)
+    ThreadRing = __atomic_fetch_add(&NextRing, 1, __ATOMIC_RELAXED) %
+                     NUM_RINGS + 1;
+  return &Rings[ThreadRing - 1];
+}
+
+static int ringPush(Ring *R, const SiteRecord *Rec) {
+  uint64_t Pos = __atomic_load_n(&R->Tail, __ATOMIC_RELAXED);
+  for (;;) {
+    Slot *S = &R->Slots[Pos & RING_MASK];
+    uint64_t Lap = Pos & ~RING_MASK;
+    int64_t Diff =
+        (int64_t)(__atomic_load_n(&S->Seq, __ATOMIC_ACQUIRE) - Lap);
+    if (Diff == 0) {
+      if (__atomic_compare_exchange_n(&R->Tail, &Pos, Pos + 1, /*weak=*/1,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        S->Rec = *Rec;
+        __atomic_store_n(&S->Seq, Lap + 1, __ATOMIC_RELEASE);
+        return 1;
+      }
+    } else if (Diff < 0) {
+      /* The slot still holds a record of the previous lap. */
+      return 0;
+    } else {
+      Pos = __atomic_load_n(&R->Tail, __ATOMIC_RELAXED);
+    }
+  }
+}
+
+static void push(const SiteRecord *Rec) {
+  if (!ringPush(getThreadRing(), Rec))
+    __atomic_fetch_add(&LostToFullRings, Rec->Count, __ATOMIC_RELAXED);
+}
+
+/* Count a violation of a site in the current second; return 0 if it exceeds
+ * the rate limit.  *Dropped is set to the number of violations of the
+ * previous second that were not logged. */
+static int rateAllow(uint64_t *State, uint32_t Sec, uint32_t *Dropped) {
+  uint64_t Old = __atomic_load_n(State, __ATOMIC_RELAXED), New;
+  do {
+    uint32_t Count = (uint32_t)Old;
+    *Dropped = 0;
+    if ((uint32_t)(Old >> 32) != Sec) {
+      New = (uint64_t)Sec << 32 | 1;
+      if (Count > RateLimit)
+        *Dropped = Count - RateLimit;
+    } else if (Count == UINT32_MAX) {
+      return 0;
+    } else {
+      New = Old + 1;
+    }
+  } while (!__atomic_compare_exchange_n(State, &Old, New, /*weak=*/1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+  return (uint32_t)New <= RateLimit;
+}
+
+/* The log; only accessed with FlushLock held. */
+
+static void closeLog(void) {
+  if (LogMap)
+    munmap(LogMap, LogMapSize);
+  if (LogFd >= 0) {
+    if (ftruncate(LogFd, LogSize))
+      fprintf(stderr, "contracts: failed to truncate the log: %s\n",
+              strerror(errno));
+    close(LogFd);
+  }
+  LogMap = NULL;
+  LogMapSize = 0;
+  LogFd = -1;
+}
+
+static char *reserve(uint64_t Size) {
+  char *P;
+  if (LogFd < 0)
+    return NULL;
+  if (LogSize + Size > LogMapSize) {
+    uint64_t NewSize = (LogSize + Size + LOG_GROWTH - 1) & ~(uint64_t)(LOG_GROWTH - 1);
+    if (LogMap)
+      munmap(LogMap, LogMapSize);
+    LogMap = NULL;
+    if (ftruncate(LogFd, NewSize) ||
+        (LogMap = mmap(NULL, NewSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+                       LogFd, 0)) == MAP_FAILED) {
+      fprintf(stderr, "contracts: failed to map the log: %s\n",
+              strerror(errno));
+      LogMap = NULL;
+      closeLog();
+      return NULL;
+    }
+    LogMapSize = NewSize;
+  }
+  P = LogMap + LogSize;
+  LogSize += (Size + 7) & ~(uint64_t)7;
+  return P;
+}
+
+static void openLog(void) {
+  char Filename[1024];
+  const char *Pattern = getenv("LLVM_CONTRACT_VIOLATION_LOG_FILE");
+  LogHeader *H;
+  size_t I = 0;
+  if (!Pattern || !Pattern[0])
+    Pattern = "default.contractlog";
+  for (; *Pattern && I + 1 < sizeof(Filename); ++Pattern) {
+    if (Pattern[0] == '%' && Pattern[1] == 'p') {
+      I += snprintf(Filename + I, sizeof(Filename) - I, "%ld", (long)getpid());
+      ++Pattern;
+    } else {
+      Filename[I++] = *Pattern;
+    }
+  }
+  Filename[I < sizeof(Filename) ? I : sizeof(Filename) - 1] = '\0';
+
+  LogFd = open(Filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (LogFd < 0) {
+    fprintf(stderr, "contracts: failed to open %s: %s\n", Filename,
+            strerror(errno));
+    return;
+  }
+  if ((H = (LogHeader *)reserve(sizeof(LogHeader)))) {
+    memcpy(H->Magic, "CONTRLOG", 8);
+    H->Version = LOG_VERSION;
+  }
+}
+
+static void writeModule(const __contract_log_module *M) {
+  uint32_t StrTabSize = 0, I, F;
+  uint64_t TableSize = (uint64_t)M->NumSites * sizeof(M->Table[0]);
+  ModuleRecord *R;
+  for (I = 0; I < M->NumSites; ++I)
+    for (F = 1; F < 5; ++F) {
+      uint32_t End = M->Table[I][F] + strlen(M->StrTab + M->Table[I][F]) + 1;
+      if (End > StrTabSize)
+        StrTabSize = End;
+    }
+  if (!(R = (ModuleRecord *)reserve(sizeof(ModuleRecord) + TableSize +
+                                    StrTabSize)))
+    return;
+  R->Kind = LOG_MODULE;
+  R->Module = M->Index;
+  R->NumSites = M->NumSites;
+  R->StrTabSize = StrTabSize;
+  memcpy(R + 1, M->Table, TableSize);
+  memcpy((char *)(R + 1) + TableSize, M->StrTab, StrTabSize);
+}
+
+static void writeRecord(const SiteRecord *Rec) {
+  SiteRecord *R = (SiteRecord *)reserve(sizeof(SiteRecord));
+  if (R)
+    *R = *Rec;
+}
+
+static int lockLog(int Wait) {
+  unsigned Spins = 0;
+  while (__atomic_exchange_n(&FlushLock, 1, __ATOMIC_ACQUIRE)) {
+    /* Give up rather than deadlock if this thread already holds the lock,
+     * e.g. when a signal handler violates a contract during a flush. */
+    if (!Wait || ++Spins > 1000)
+      return 0;
+    sched_yield();
+  }
+  return 1;
+}
+
+static void unlockLog(void) {
+  __atomic_store_n(&FlushLock, 0, __ATOMIC_RELEASE);
+}
+
+/* Append the queued records to the log.  Records dropped by the rate limit
+ * are only accounted for when the site violates its contract again; with
+ * Final set, they are all written. */
+static void flushLog(int Final) {
+  unsigned I;
+  uint64_t Lost;
+  if (!lockLog(Final))
+    return;
+  for (I = 0; I < NUM_RINGS; ++I) {
+    Ring *R = &Rings[I];
+    for (;;) {
+      Slot *S = &R->Slots[R->Head & RING_MASK];
+      uint64_t Lap = R->Head & ~RING_MASK;
+      SiteRecord Rec;
+      if (__atomic_load_n(&S->Seq, __ATOMIC_ACQUIRE) != Lap + 1)
+        break;
+      Rec = S->Rec;
+      __atomic_store_n(&S->Seq, Lap + RING_SIZE, __ATOMIC_RELEASE);
+      ++R->Head;
+      writeRecord(&Rec);
+    }
+  }
+  if (Final && RateLimit) {
+    const __contract_log_module *M;
+    uint64_t Time = now();
+    for (M = __atomic_load_n(&Modules, __ATOMIC_ACQUIRE); M; M = M->Next)
+      for (I = 0; I < M->NumSites; ++I) {
+        uint64_t Old = __atomic_load_n(&M->Rate[I], __ATOMIC_RELAXED);
+        SiteRecord Rec = {LOG_DROPPED, M->Index, I, 0, Time};
+        do {
+          if ((uint32_t)Old <= RateLimit)
+            break;
+          Rec.Count = (uint32_t)Old - RateLimit;
+        } while (!__atomic_compare_exchange_n(
+            &M->Rate[I], &Old, (Old & ~(uint64_t)UINT32_MAX) | RateLimit,
+            /*weak=*/1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+        if ((uint32_t)Old > RateLimit)
+          writeRecord(&Rec);
+      }
+  }
+  if ((Lost = __atomic_exchange_n(&LostToFullRings, 0, __ATOMIC_RELAXED))) {
+    SiteRecord Rec = {LOG_DROPPED, ~0U, ~0U, (uint32_t)Lost, now()};
+    writeRecord(&Rec);
+  }
+  unlockLog();
+}
+
+static void *flusherMain(void *Arg) {
+  struct timespec Interval = {0, FLUSH_INTERVAL_NS};
+  sigset_t All;
+  (void)Arg;
+  /* Leave the signals to the threads of the program. */
+  sigfillset(&All);
+  pthread_sigmask(SIG_BLOCK, &All, NULL);
+  for (;;) {
+    nanosleep(&Interval, NULL);
+    flushLog(0);
+  }
+  return NULL;
+}
+
+static void writeLogAtExit(void) {
+  flushLog(1);
+  if (lockLog(1)) {
+    closeLog();
+    unlockLog();
+  }
+}
+
+static void initialize(void) {
+  pthread_t Flusher;
+  const char *Rate = getenv("LLVM_CONTRACT_VIOLATION_LOG_RATE");
+  if (Rate && Rate[0])
+    RateLimit = (uint32_t)strtoul(Rate, NULL, 10);
+  openLog();
+  atexit(writeLogAtExit);
+  if (pthread_create(&Flusher, NULL, flusherMain, NULL) == 0)
+    pthread_detach(Flusher);
+}
+
+void __contract_log_register(__contract_log_module *M) {
+  static pthread_once_t Once = PTHREAD_ONCE_INIT;
+  pthread_once(&Once, initialize);
+
+  M->Index = __atomic_fetch_add(&NumModules, 1, __ATOMIC_RELAXED);
+  if (lockLog(1)) {
+    writeModule(M);
+    unlockLog();
+  }
+  M->Next = __atomic_load_n(&Modules, __ATOMIC_RELAXED);
+  while (!__atomic_compare_exchange_n(&Modules, &M->Next, M, /*weak=*/1,
+                                      __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+    ;
+}
+
+/* Called by __builtin_violation_handler(); async-signal-safe. */
+void __contract_violation_log(__contract_log_module *M, uint32_t Site) {
+  int SavedErrno = errno;
+  SiteRecord Rec = {LOG_VIOLATION, M->Index, Site, 1, now()};
+  uint32_t Dropped = 0;
+  if (RateLimit && Site < M->NumSites &&
+      !rateAllow(&M->Rate[Site], (uint32_t)(Rec.Time / 1000000000), &Dropped)) {
+    errno = SavedErrno;
+    return;
+  }
+  if (Dropped) {
+    SiteRecord Drop = {LOG_DROPPED, M->Index, Site, Dropped, Rec.Time};
+    push(&Drop);
+  }
+  push(&Rec);
+  errno = SavedErrno;
+}
+
+/* Called by __builtin_violation_handler() before std::terminate(). */
+void __contract_violation_log_flush(void) { flushLog(1); }
@@ -0,0 +1,267 @@
+/*===- contracts_trap.c - Trapping contract checks ------------------------===*\
+|*
+|*                     The LLVM Compiler Infrastructure
+|*
+|* This file is distributed under the University of Illinois Open Source
+|* License. See LICENSE.TXT for details.
+|*
+\*===----------------------------------------------------------------------===*/
+
+/* Runtime support for clang -contract-violation-mode=trap.
+ *
+ * A failing check of such modules executes a ud2 instruction, and nothing
+ * else.  The address of each of these instructions and the site id of its
+ * check are in the .llvm_contract_traps section, which is not loaded.  Each
+ * module registers at start-up (or when it is dlopen'ed), which reads the
+ * section from the file the module is linked into, and installs a SIGILL
+ * handler.
+ *
+ * The signal handler only looks the faulting PC up, and makes the thread
+ * resume out of the signal context, in a stub that calls
+ * __contract_trap_resume() with the site id.  The site is then passed to the
+ * __builtin_violation_handler() of the first module built with
+ * -contract-violation-handler=, or else is reported on stderr before
+ * aborting.  If the handler returns (-fcontinue-after-violation), the stub
+ * resumes after the trap, as if the trap were a call: such modules declare
+ * the caller-saved registers clobbered by the trap.  SIGILLs raised by other
+ * instructions go to the previous disposition of the signal.
+ */
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include "contracts_internal.h"
+
+#define CONTRACT_TRAPS_SECTION ".llvm_contract_traps"
+
+/* Entries of the section (see CodeGenFunction::EmitContractViolationTrap):
+ * the link-time address of the trap, then the site id, unaligned. */
+#define TRAP_ENTRY_SIZE (sizeof(uintptr_t) + sizeof(uint32_t))
+
+/* Length of ud2 */
+#define TRAP_SIZE 2
+
+/* Room left for the frame of the signal handler below the stack pointer it
+ * runs with, when the stub gets the stack. */
+#define STUB_STACK_GAP 4096
+
+typedef void (*ViolationHandler)(uint32_t);
+
+typedef struct {
+  char *Data;
+  uint64_t Size;
+  uintptr_t Base;
+} TrapTable;
+
+/* The tables read so far.  The signal handler may look a PC up while another
+ * thread registers a module: a new list is published for each table, and the
+ * previous ones are never freed. */
+typedef struct {
+  uint32_t NumTables;
+  TrapTable Tables[];
+} TrapTableList;
+
+static TrapTableList *Tables;
+static pthread_mutex_t RegisterMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t InstallOnce = PTHREAD_ONCE_INIT;
+
+static ViolationHandler Handler;
+static struct sigaction PrevAction;
+
+/* Resumes the thread with the site id, the address after the trap and the
+ * stack pointer at the trap in the first three caller-saved registers: calls
+ * __contract_trap_resume(), then returns to the trap site. */
+void __contract_trap_stub(void) __attribute__((visibility("hidden")));
+void __contract_trap_resume(uint32_t Id)
+    __attribute__((visibility("hidden"), used));
+
+#if defined(__x86_64__)
+__asm__(".text\n"
+        ".p2align 4\n"
+        ".globl __contract_trap_stub\n"
+        ".hidden __contract_trap_stub\n"
+        ".type __contract_trap_stub,@function\n"
+        "__contract_trap_stub:\n"
+        "\t.cfi_startproc\n"
+        "\t.cfi_undefined %rip\n"
+        "\tpushq %rsi\n"
+        "\tpushq %rdx\n"
+        "\tcall __contract_trap_resume\n"
+        "\tpopq %rdx\n"
+        "\tpopq %rsi\n"
+        "\tmovq %rdx, %rsp\n"
+        "\tjmpq *%rsi\n"
+        "\t.cfi_endproc\n"
+        ".size __contract_trap_stub, .-__contract_trap_stub\n");
+#else
+__asm__(".text\n"
+        ".p2align 4\n"
+        ".globl __contract_trap_stub\n"
+        ".hidden __contract_trap_stub\n"
+        ".type __contract_trap_stub,@function\n"
+        "__contract_trap_stub:\n"
+        "\t.cfi_startproc\n"
+        "\t.cfi_undefined %eip\n"
+        "\tsubl $4, %esp\n"
+        "\tpushl %edx\n"
+        "\tpushl %ecx\n"
+        "\tpushl %eax\n"
+        "\tcall __contract_trap_resume\n"
+        "\taddl $4, %esp\n"
+        "\tpopl %ecx\n"
+        "\tpopl %edx\n"
+        "\tmovl %edx, %esp\n"
+        "\tjmp *%ecx\n"
+        "\t.cfi_endproc\n"
+        ".size __contract_trap_stub, .-__contract_trap_stub\n");
+#endif
+
+/* Called with RegisterMutex held. */
+static void addTable(char *Data, uint64_t Size, uintptr_t Base) {
+  TrapTableList *Old = Tables;
+  uint32_t NumTables = Old ? Old->NumTables : 0;
+  TrapTableList *New = (TrapTableList *)malloc(
+      sizeof(TrapTableList) + (NumTables + 1) * sizeof(TrapTable));
+  if (!New) {
+    free(Data);
+    return;
+  }
+  if (Old)
+    memcpy(New->Tables, Old->Tables, NumTables * sizeof(TrapTable));
+  New->Tables[NumTables].Data = Data;
+  New->Tables[NumTables].Size = Size;
+  New->Tables[NumTables].Base = Base;
+  New->NumTables = NumTables + 1;
+  __atomic_store_n(&Tables, New, __ATOMIC_RELEASE);
+}
+
+static int hasTable(uintptr_t Base) {
+  const TrapTableList *List = Tables;
+  for (uint32_t T = 0; List && T < List->NumTables; ++T)
+    if (List->Tables[T].Base == Base)
+      return 1;
+  return 0;
+}
+
+/* Sets *Id to the site id of the trap at PC, if any.  Async-signal-safe. */
+static int findSite(uintptr_t PC, uint32_t *Id) {
+  const TrapTableList *List = __atomic_load_n(&Tables, __ATOMIC_ACQUIRE);
+  for (uint32_t T = 0; List && T < List->NumTables; ++T) {
+    const TrapTable *Table = &List->Tables[T];
+    for (uint64_t Off = 0; Off + TRAP_ENTRY_SIZE <= Table->Size;
+         Off += TRAP_ENTRY_SIZE) {
+      uintptr_t Addr;
+      memcpy(&Addr, Table->Data + Off, sizeof(Addr));
+      if (Table->Base + Addr == PC) {
+        memcpy(Id, Table->Data + Off + sizeof(Addr), sizeof(*Id));
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+static void reportViolation(uint32_t Id) {
+  const char *StrTab;
+  const uint32_t *Entry = __contract_violation_decode(Id, &StrTab);
+  char Buf[1024];
+  int N = snprintf(Buf, sizeof(Buf),
+                   "%s:%u: %s: contract violation: %s [%s]\n",
+                   StrTab + Entry[1], (unsigned)Entry[0], StrTab + Entry[2],
+                   StrTab + Entry[3], StrTab + Entry[4]);
+  if (N > 0)
+    write(STDERR_FILENO, Buf, (size_t)N < sizeof(Buf) ? (size_t)N
+                                                      : sizeof(Buf) - 1);
+}
+
+void __contract_trap_resume(uint32_t Id) {
+  if (!Handler) {
+    reportViolation(Id);
+    abort();
+  }
+  Handler(Id);
+}
+
+static void forwardSignal(int Sig, siginfo_t *Info, void *Context) {
+  if (PrevAction.sa_flags & SA_SIGINFO) {
+    PrevAction.sa_sigaction(Sig, Info, Context);
+    return;
+  }
+  if (PrevAction.sa_handler != SIG_DFL && PrevAction.sa_handler != SIG_IGN) {
+    PrevAction.sa_handler(Sig);
+    return;
+  }
+  /* The default action terminates the program: restore it, and the
+   * instruction faults again. */
+  signal(SIGILL, SIG_DFL);
+}
+
+static void handleTrap(int Sig, siginfo_t *Info, void *Context) {
+  greg_t *Regs = ((ucontext_t *)Context)->uc_mcontext.gregs;
+  uint32_t Id;
+#if defined(__x86_64__)
+  if (!findSite((uintptr_t)Regs[REG_RIP], &Id)) {
+    forwardSignal(Sig, Info, Context);
+    return;
+  }
+  /* The stub runs below the frame of this handler, which also leaves the red
+   * zone of the trapping function alone. */
+  uintptr_t Stack =
+      ((uintptr_t)__builtin_frame_address(0) - STUB_STACK_GAP) & ~(uintptr_t)15;
+  Regs[REG_RDI] = Id;
+  Regs[REG_RSI] = Regs[REG_RIP] + TRAP_SIZE;
+  Regs[REG_RDX] = Regs[REG_RSP];
+  Regs[REG_RSP] = (greg_t)Stack;
+  Regs[REG_RIP] = (greg_t)(uintptr_t)__contract_trap_stub;
+#else
+  if (!findSite((uintptr_t)Regs[REG_EIP], &Id)) {
+    forwardSignal(Sig, Info, Context);
+    return;
+  }
+  uintptr_t Stack =
+      ((uintptr_t)__builtin_frame_address(0) - STUB_STACK_GAP) & ~(uintptr_t)15;
+  Regs[REG_EAX] = Id;
+  Regs[REG_ECX] = Regs[REG_EIP] + TRAP_SIZE;
+  Regs[REG_EDX] = Regs[REG_ESP];
+  Regs[REG_ESP] = (greg_t)Stack;
+  Regs[REG_EIP] = (greg_t)(uintptr_t)__contract_trap_stub;
+#endif
+}
+
+static void installHandler(void) {
+  struct sigaction Action;
+  memset(&Action, 0, sizeof(Action));
+  Action.sa_sigaction = handleTrap;
+  Action.sa_flags = SA_SIGINFO | SA_NODEFER;
+  sigemptyset(&Action.sa_mask);
+  sigaction(SIGILL, &Action, &PrevAction);
+}
+
+/* Called at start-up by each module built with -contract-violation-mode=trap,
+ * with its __builtin_violation_handler() if it was built with
+ * -contract-violation-handler=, and an address in the module.  The traps of
+ * all the modules linked into the same file are read at once. */
+void __contract_trap_register(ViolationHandler H, const void *Module) {
+  if (H)
+    __sync_bool_compare_and_swap(&Handler, (ViolationHandler)0, H);
+
+  const char *Path;
+  uintptr_t Base;
+  pthread_mutex_lock(&RegisterMutex);
+  if (__contract_find_object(Module, &Path, &Base) && !hasTable(Base))
+    __contract_read_section(Path, CONTRACT_TRAPS_SECTION, Base, addTable);
+  pthread_mutex_unlock(&RegisterMutex);
+
+  pthread_once(&InstallOnce, installHandler);
+}
+
+#endif /* defined(__x86_64__) || defined(__i386__) */
@@ -0,0 +1,106 @@
+/*===- ContractProfiling.c - Contract profiling runtime -------------------===*\
+|*
+|*                     The LLVM Compiler Infrastructure
+|*
+|* This file is distributed under the University of Illinois Open Source
+|* License. See LICENSE.TXT for details.
+|*
+\*===----------------------------------------------------------------------===*/
+
+/* Runtime support for clang -fcontract-profile.  Each module registers its
+ * contract site counters at start-up; at exit, a record per executed site is
+ * appended to the contract profile (see llvm/ProfileData/ContractProf.h),
+ * which is shared by all the runs and can be merged by simple concatenation.
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "InstrProfilingPort.h"
+#include "InstrProfilingUtil.h"
+
+/* Per-module descriptor emitted by clang (see
+ * CodeGenModule::EmitCXXContractDependencies). */
+typedef struct __contract_profile_module {
+  struct __contract_profile_module *Next;
+  uint32_t NumSites;
+  /* __contract_violation_tab: line, and offsets in StrTab of the file,
+   * function, comment and level strings */
+  const uint32_t (*Table)[5];
+  const char *StrTab;
+  /* Static estimate of the cost of each predicate, in cycles */
+  const uint32_t *Cost;
+  /* Number of evaluations and violations of each predicate */
+  uint64_t (*Counters)[2];
+} __contract_profile_module;
+
+static __contract_profile_module *Modules = NULL;
+
+static void writeString(FILE *File, const char *Str) {
+  for (; *Str; ++Str) {
+    switch (*Str) {
+    case '\t':
+      fputs("\\t", File);
+      break;
+    case '\n':
+      fputs("\\n", File);
+      break;
+    case '\\':
+      fputs("\\\\", File);
+      break;
+    default:
+      fputc(*Str, File);
+      break;
+    }
+  }
+}
+
+static void writeModule(FILE *File, const __contract_profile_module *M) {
+  uint32_t I;
+  for (I = 0; I < M->NumSites; ++I) {
+    const uint32_t *Entry = M->Table[I];
+    if (!M->Counters[I][0] && !M->Counters[I][1])
+      continue;
+    fprintf(File, "%" PRIu64 "\t%" PRIu64 "\t%" PRIu32 "\t%" PRIu32 "\t",
+            M->Counters[I][0], M->Counters[I][1], M->Cost[I], Entry[0]);
+    writeString(File, M->StrTab + Entry[4]);
+    fputc('\t', File);
+    writeString(File, M->StrTab + Entry[1]);
+    fputc('\t', File);
+    writeString(File, M->StrTab + Entry[2]);
+    fputc('\t', File);
+    writeString(File, M->StrTab + Entry[3]);
+    fputc('\n', File);
+  }
+}
+
+static void writeFileAtExit(void) {
+  const __contract_profile_module *M;
+  FILE *File;
+  const char *Filename = getenv("LLVM_CONTRACT_PROFILE_FILE");
+  if (!Filename || !Filename[0])
+    Filename = "default.contractprof";
+
+  /* Open with an exclusive lock; concurrent runs append in turn. */
+  File = lprofOpenFileEx(Filename);
+  if (!File) {
+    PROF_ERR("Failed to open %s: %s\n", Filename, strerror(errno));
+    return;
+  }
+  fseek(File, 0, SEEK_END);
+  for (M = Modules; M; M = M->Next)
+    writeModule(File, M);
+  fclose(File);
+}
+
+COMPILER_RT_VISIBILITY void
+__contract_profile_register(__contract_profile_module *M) {
+  if (!Modules)
+    atexit(writeFileAtExit);
+  M->Next = Modules;
+  Modules = M;
+}
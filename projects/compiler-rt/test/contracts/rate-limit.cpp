@@ -0,0 +1,27 @@
+// RUN: %clangxx_contracts -fcontinue-after-violation -o %t %s
+// RUN: env LLVM_CONTRACT_VIOLATION_LOG_FILE=%t.contractlog %run %t
+// RUN: llvm-profdata contract-log -summary %t.contractlog | FileCheck %s
+
+#include <time.h>
+
+int positive(int i) {
+  [[assert: i > 0]];
+  return i;
+}
+
+int main() {
+  // Wait for the start of a second, so that all the violations are counted
+  // against the same one.
+  time_t Start = time(nullptr);
+  while (time(nullptr) == Start)
+    ;
+  int s = 0;
+  for (int i = 0; i < 150; ++i)
+    s += positive(-1);
+  return s == 0;
+}
+
+// By default, at most 100 violations per site and second are logged; the others are
+// counted.
+// CHECK: Logged Dropped Level Site
+// CHECK-NEXT: 100 50 default {{.*}}rate-limit.cpp:8: positive: i > 0
@@ -0,0 +1,11 @@
+// RUN: %clangxx_contracts -o %t %s
+// RUN: env LLVM_CONTRACT_VIOLATION_LOG_FILE=%t.contractlog not --crash %run %t
+// RUN: llvm-profdata contract-log %t.contractlog | FileCheck %s
+
+int main(int argc, char **argv) {
+  [[assert: argc > 1]];
+  return 0;
+}
+
+// The log is written before the program terminates.
+// CHECK: violation {{.*}}terminate.cpp:6: main: argc > 1 [default]
@@ -0,0 +1,29 @@
+// RUN: %clangxx_contracts -fcontinue-after-violation -o %t %s
+// RUN: env LLVM_CONTRACT_VIOLATION_LOG_FILE=%t.contractlog LLVM_CONTRACT_VIOLATION_LOG_RATE=0 %run %t
+// RUN: llvm-profdata contract-log %t.contractlog | FileCheck %s
+// RUN: llvm-profdata contract-log -summary %t.contractlog | FileCheck %s --check-prefix=SUMMARY
+
+int get(const int *v, int n, int i) {
+  [[assert: i < n]];
+  return i < n ? v[i] : 0;
+}
+
+int main() {
+  int v[4] = {};
+  int s = 0;
+  for (int i = 0; i < 6; ++i)
+    s += get(v, 4, i);
+  [[assert: s != 0]];
+  return 0;
+}
+
+// Execution continues after each violation, which is logged.
+// CHECK: {{[0-9]+\.[0-9]{9}}}  violation  {{.*}}violation-log.cpp:7: get: i < n [default]
+// CHECK-NEXT: {{[0-9]+\.[0-9]{9}}}  violation  {{.*}}violation-log.cpp:7: get: i < n [default]
+// CHECK-NEXT: {{[0-9]+\.[0-9]{9}}}  violation  {{.*}}violation-log.cpp:16: main: s != 0 [default]
+// CHECK-NOT: violation
+
+// SUMMARY: 3 records
+// SUMMARY: Logged Dropped Level Site
+// SUMMARY-NEXT: 2 0 default {{.*}}violation-log.cpp:7: get: i < n
+// SUMMARY-NEXT: 1 0 default {{.*}}violation-log.cpp:16: main: s != 0
@@ -0,0 +1,24 @@
+// RUN: %clangxx -std=c++14 -fcontract-profile -o %t %s
+// RUN: rm -f %t.contractprof
+// RUN: env LLVM_CONTRACT_PROFILE_FILE=%t.contractprof %run %t
+// RUN: env LLVM_CONTRACT_PROFILE_FILE=%t.contractprof %run %t
+// RUN: llvm-profdata contract %t.contractprof | FileCheck %s
+
+int get(const int *v, int n, int i) {
+  [[assert: i < n]];
+  return v[i];
+}
+
+int main() {
+  int v[10] = {};
+  int s = 0;
+  for (int i = 0; i < 10; ++i)
+    s += get(v, 10, i);
+  [[assert: s == 0]];
+  return s;
+}
+
+// Both runs are merged in the profile.
+// CHECK: Contract sites: 2
+// CHECK: 20 0 default {{.*}}contract-profile.cpp:8: get: i < n
+// CHECK: 2 0 default {{.*}}contract-profile.cpp:17: main: s == 0
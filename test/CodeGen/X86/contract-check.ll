@@ -0,0 +1,23 @@
+; RUN: llc < %s -O0 -mtriple=x86_64-unknown-linux-gnu | FileCheck %s
+; RUN: llc < %s -O2 -mtriple=x86_64-unknown-linux-gnu | FileCheck %s
+
+; The intrinsic is lowered to its predicate by both instruction selectors.
+
+declare i1 @llvm.contract.check(i1, i32)
+declare void @handler(i32) noreturn
+
+define i32 @test(i32 %x) {
+; CHECK-LABEL: test:
+; CHECK: {{cmpl|testl}}
+; CHECK: handler
+  %cmp = icmp sgt i32 %x, 0
+  %c = call i1 @llvm.contract.check(i1 %cmp, i32 1)
+  br i1 %c, label %cont, label %violation
+
+cont:
+  ret i32 %x
+
+violation:
+  call void @handler(i32 1)
+  unreachable
+}
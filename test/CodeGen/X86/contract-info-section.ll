@@ -0,0 +1,10 @@
+;; Ensure that SHF_ALLOC section flag is not set for the .llvm_contract_info
+;; section, emitted by clang -fcontract-violation-site-ids.
+; RUN: llc < %s -mtriple=x86_64-unknown-linux-gnu | FileCheck %s
+
+@__contract_violation_info = private constant <{ i32, i32, i32 }> <{ i32 1, i32 0, i32 0 }>, section ".llvm_contract_info", align 4
+@llvm.used = appending global [1 x i8*] [i8* bitcast (<{ i32, i32, i32 }>* @__contract_violation_info to i8*)], section "llvm.metadata"
+
+; CHECK: .section	.llvm_contract_info,"",@progbits
+; CHECK-NEXT: .p2align	2
+; CHECK-NEXT: .L__contract_violation_info:
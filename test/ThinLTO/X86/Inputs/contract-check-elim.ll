@@ -0,0 +1,38 @@
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define i32 @at(i32 %i) {
+entry:
+  %lt16 = icmp ult i32 %i, 16
+  %check16 = call i1 @llvm.contract.check(i1 %lt16, i32 0)
+  br i1 %check16, label %cont, label %violation
+
+cont:
+  %lt8 = icmp ult i32 %i, 8
+  %check8 = call i1 @llvm.contract.check(i1 %lt8, i32 1)
+  br i1 %check8, label %ret, label %violation
+
+violation:
+  call void @violation()
+  unreachable
+
+ret:
+  ret i32 %i
+}
+
+define i32 @exported(i32 %i) {
+entry:
+  %pos = icmp sgt i32 %i, 0
+  %check = call i1 @llvm.contract.check(i1 %pos, i32 2)
+  br i1 %check, label %ret, label %violation
+
+violation:
+  call void @violation()
+  unreachable
+
+ret:
+  ret i32 %i
+}
+
+declare i1 @llvm.contract.check(i1, i32)
+declare void @violation()
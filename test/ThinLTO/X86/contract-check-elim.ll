@@ -0,0 +1,43 @@
+; RUN: opt -module-summary %s -o %t1.bc
+; RUN: opt -module-summary %p/Inputs/contract-check-elim.ll -o %t2.bc
+; RUN: llvm-bcanalyzer -dump %t1.bc | FileCheck %s --check-prefix=SUMMARY
+; RUN: llvm-lto2 run %t1.bc %t2.bc -o %t.out -save-temps \
+; RUN:   -r %t1.bc,main,plx \
+; RUN:   -r %t1.bc,at, \
+; RUN:   -r %t1.bc,exported, \
+; RUN:   -r %t2.bc,at,pl \
+; RUN:   -r %t2.bc,exported,plx \
+; RUN:   -r %t2.bc,violation,
+; RUN: llvm-bcanalyzer -dump %t.out.index.bc | FileCheck %s --check-prefix=COMBINED
+; RUN: llvm-dis < %t.out.1.1.promote.bc | FileCheck %s
+
+; The arguments of the calls to @at are in [0, 8) and 10.
+; SUMMARY: <CONTRACT_CALL_ARGS {{.*}} op1=0 op2=32 op3=0 op4=11/>
+
+; Only the first check of @at holds for [0, 11).
+; COMBINED: <CONTRACT_CHECKS op0=0 op1=32 op2=0 op3=16 op4=1 op5=0 op6=32 op7=0 op8=8 op9=0/>
+
+; CHECK-LABEL: define i32 @at(
+; CHECK-NOT: call i1 @llvm.contract.check(i1 %{{.*}}, i32 0)
+; CHECK: call i1 @llvm.contract.check(i1 %{{.*}}, i32 1)
+
+; @exported may have other callers.
+; CHECK-LABEL: define i32 @exported(
+; CHECK: call i1 @llvm.contract.check(i1 %{{.*}}, i32 2)
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define i32 @main(i32 %n) {
+entry:
+  %m = and i32 %n, 7
+  %a = call i32 @at(i32 %m)
+  %b = call i32 @at(i32 10)
+  %c = call i32 @exported(i32 1)
+  %ab = add i32 %a, %b
+  %abc = add i32 %ab, %c
+  ret i32 %abc
+}
+
+declare i32 @at(i32)
+declare i32 @exported(i32)
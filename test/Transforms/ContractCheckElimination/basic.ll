@@ -0,0 +1,121 @@
+; RUN: opt -S -contract-check-elim < %s        | FileCheck %s
+; RUN: opt -S -passes=contract-check-elim < %s | FileCheck %s
+
+declare i1 @llvm.contract.check(i1, i32)
+declare void @handler(i32) noreturn
+
+; The second check repeats the first one: it is folded.
+define void @f_0(i32 %x) {
+; CHECK-LABEL: @f_0(
+entry:
+; CHECK: %c0 = call i1 @llvm.contract.check(i1 %cmp0, i32 0)
+; CHECK: br i1 %c0, label %cont0, label %violation
+  %cmp0 = icmp sgt i32 %x, 0
+  %c0 = call i1 @llvm.contract.check(i1 %cmp0, i32 0)
+  br i1 %c0, label %cont0, label %violation
+
+cont0:
+; CHECK: cont0:
+; CHECK-NOT: @llvm.contract.check
+; CHECK: br i1 true, label %cont1, label %violation
+  %cmp1 = icmp sgt i32 %x, -1
+  %c1 = call i1 @llvm.contract.check(i1 %cmp1, i32 1)
+  br i1 %c1, label %cont1, label %violation
+
+cont1:
+  ret void
+
+violation:
+  %id = phi i32 [ 0, %entry ], [ 1, %cont0 ]
+  call void @handler(i32 %id)
+  unreachable
+}
+
+; The check is implied by the user's own branch.
+define void @f_1(i32 %x) {
+; CHECK-LABEL: @f_1(
+entry:
+  %in.range = icmp ult i32 %x, 10
+  br i1 %in.range, label %guarded, label %exit
+
+guarded:
+; CHECK: guarded:
+; CHECK-NOT: @llvm.contract.check
+; CHECK: br i1 true, label %exit, label %violation
+  %cmp = icmp slt i32 %x, 100
+  %c = call i1 @llvm.contract.check(i1 %cmp, i32 0)
+  br i1 %c, label %exit, label %violation
+
+exit:
+  ret void
+
+violation:
+  call void @handler(i32 0)
+  unreachable
+}
+
+; The range of a zero-extended value is known.
+define void @f_2(i8 %x) {
+; CHECK-LABEL: @f_2(
+entry:
+; CHECK-NOT: @llvm.contract.check
+; CHECK: br i1 true, label %exit, label %violation
+  %ext = zext i8 %x to i32
+  %cmp = icmp ult i32 %ext, 256
+  %c = call i1 @llvm.contract.check(i1 %cmp, i32 0)
+  br i1 %c, label %exit, label %violation
+
+exit:
+  ret void
+
+violation:
+  call void @handler(i32 0)
+  unreachable
+}
+
+; Nothing is known about %x: the check stays.
+define void @f_3(i32 %x) {
+; CHECK-LABEL: @f_3(
+entry:
+; CHECK: %c = call i1 @llvm.contract.check(i1 %cmp, i32 0)
+; CHECK: br i1 %c, label %exit, label %violation
+  %cmp = icmp slt i32 %x, 100
+  %c = call i1 @llvm.contract.check(i1 %cmp, i32 0)
+  br i1 %c, label %exit, label %violation
+
+exit:
+  ret void
+
+violation:
+  call void @handler(i32 0)
+  unreachable
+}
+
+; The induction variable is always below the trip count.
+define void @f_4(i32 %n) {
+; CHECK-LABEL: @f_4(
+entry:
+  %enter = icmp sgt i32 %n, 0
+  br i1 %enter, label %loop, label %exit
+
+loop:
+; CHECK: loop:
+; CHECK-NOT: @llvm.contract.check
+; CHECK: br i1 true, label %latch, label %violation
+  %i = phi i32 [ 0, %entry ], [ %i.next, %latch ]
+  %cmp = icmp sge i32 %i, 0
+  %c = call i1 @llvm.contract.check(i1 %cmp, i32 0)
+  br i1 %c, label %latch, label %violation
+
+latch:
+  %i.next = add nsw nuw i32 %i, 1
+  %again = icmp slt i32 %i.next, %n
+  br i1 %again, label %loop, label %exit
+
+exit:
+  ret void
+
+violation:
+  call void @handler(i32 0)
+  unreachable
+}
@@ -0,0 +1,105 @@
+; RUN: opt -S -contract-check-elim < %s        | FileCheck %s
+; RUN: opt -S -passes=contract-check-elim < %s | FileCheck %s
+
+declare i1 @llvm.contract.check(i1, i32)
+declare void @handler(i32) noreturn
+declare void @clobber()
+
+; A loop-invariant check in the header is evaluated once, in the preheader.
+define void @f_0(i32* %p, i32 %n, i32 %k) {
+; CHECK-LABEL: @f_0(
+entry:
+; CHECK: entry:
+; CHECK:   %cmp = icmp slt i32 %k, %n
+; CHECK:   %c = call i1 @llvm.contract.check(i1 %cmp, i32 3)
+; CHECK:   br i1 %c, label %[[PH:.*]], label %violation, !prof !0
+; CHECK: [[PH]]:
+; CHECK:   br label %loop
+; CHECK: loop:
+; CHECK-NOT: @llvm.contract.check
+; CHECK:   br i1 true, label %body, label %violation
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %body ]
+  %cmp = icmp slt i32 %k, %n
+  %c = call i1 @llvm.contract.check(i1 %cmp, i32 3)
+  br i1 %c, label %body, label %violation, !prof !0
+
+body:
+  %addr = getelementptr i32, i32* %p, i32 %i
+  store i32 %i, i32* %addr
+  %i.next = add i32 %i, 1
+  %again = icmp slt i32 %i.next, %n
+  br i1 %again, label %loop, label %exit
+
+exit:
+  ret void
+
+violation:
+; CHECK: violation:
+; CHECK:   %id = phi i32 [ 3, %loop ], [ 3, %entry ]
+  %id = phi i32 [ 3, %loop ]
+  call void @handler(i32 %id)
+  unreachable
+}
+
+; The check depends on the induction variable: it is not hoisted.
+define void @f_1(i32 %n, i32 %k) {
+; CHECK-LABEL: @f_1(
+entry:
+  br label %loop
+
+loop:
+; CHECK: loop:
+; CHECK:   %c = call i1 @llvm.contract.check(i1 %cmp, i32 0)
+; CHECK:   br i1 %c, label %body, label %violation
+  %i = phi i32 [ 0, %entry ], [ %i.next, %body ]
+  %cmp = icmp ne i32 %i, %k
+  %c = call i1 @llvm.contract.check(i1 %cmp, i32 0)
+  br i1 %c, label %body, label %violation
+
+body:
+  %i.next = add i32 %i, 1
+  %again = icmp slt i32 %i.next, %n
+  br i1 %again, label %loop, label %exit
+
+exit:
+  ret void
+
+violation:
+  call void @handler(i32 0)
+  unreachable
+}
+
+; A call in the header precedes the check: it is not hoisted.
+define void @f_2(i32 %n, i32 %k) {
+; CHECK-LABEL: @f_2(
+entry:
+  br label %loop
+
+loop:
+; CHECK: loop:
+; CHECK:   call void @clobber()
+; CHECK:   %c = call i1 @llvm.contract.check(i1 %cmp, i32 0)
+; CHECK:   br i1 %c, label %body, label %violation
+  %i = phi i32 [ 0, %entry ], [ %i.next, %body ]
+  call void @clobber()
+  %cmp = icmp slt i32 %k, %n
+  %c = call i1 @llvm.contract.check(i1 %cmp, i32 0)
+  br i1 %c, label %body, label %violation
+
+body:
+  %i.next = add i32 %i, 1
+  %again = icmp slt i32 %i.next, %n
+  br i1 %again, label %loop, label %exit
+
+exit:
+  ret void
+
+violation:
+  call void @handler(i32 0)
+  unreachable
+}
+
+!0 = !{!"branch_weights", i32 1048575, i32 1}
@@ -0,0 +1,126 @@
+; RUN: opt -S -loop-contract-versioning < %s        | FileCheck %s
+; RUN: opt -S -passes=loop-contract-versioning < %s | FileCheck %s
+
+declare i1 @llvm.contract.check(i1, i32)
+declare void @handler(i32) noreturn
+
+; The precondition of an inlined accessor, i < size, is tested once before the
+; loop.  The loop that runs when the test succeeds has no checks left.
+define void @f_0(i32* %a, i64 %n, i64 %size) {
+; CHECK-LABEL: @f_0(
+; CHECK: loop.contract.check:
+; CHECK:   %contract.safe = and i1
+; CHECK:   br i1 %contract.safe, label %loop.ph, label %loop.ph.contract.orig, !prof ![[PROF:[0-9]+]]
+; CHECK: loop.contract.orig:
+; CHECK:   %c.contract.orig = call i1 @llvm.contract.check(i1 %cmp.contract.orig, i32 0)
+; CHECK:   br i1 %c.contract.orig, label %cont.contract.orig, label %violation
+; CHECK: loop.ph:
+; CHECK: loop:
+; CHECK-NOT: @llvm.contract.check
+; CHECK:   store i32 0, i32* %addr
+; CHECK:   br i1 %again, label %loop, label %exit.loopexit
+; CHECK: violation:
+; CHECK-NEXT: call void @handler(i32 0)
+entry:
+  %enter = icmp ugt i64 %n, 0
+  br i1 %enter, label %loop.ph, label %exit
+
+loop.ph:
+  br label %loop
+
+loop:
+  %i = phi i64 [ 0, %loop.ph ], [ %i.next, %cont ]
+  %cmp = icmp ult i64 %i, %size
+  %c = call i1 @llvm.contract.check(i1 %cmp, i32 0)
+  br i1 %c, label %cont, label %violation
+
+cont:
+  %addr = getelementptr i32, i32* %a, i64 %i
+  store i32 0, i32* %addr
+  %i.next = add nuw nsw i64 %i, 1
+  %again = icmp ult i64 %i.next, %n
+  br i1 %again, label %loop, label %exit.loopexit
+
+exit.loopexit:
+  br label %exit
+
+exit:
+  ret void
+
+violation:
+  call void @handler(i32 0)
+  unreachable
+}
+
+; A check on a value loaded in the loop cannot be tested before the loop, so
+; the loop is left alone.
+define void @f_1(i32* %a, i64 %n) {
+; CHECK-LABEL: @f_1(
+; CHECK-NOT: contract.safe
+; CHECK: %c = call i1 @llvm.contract.check(i1 %cmp, i32 0)
+; CHECK-NOT: contract.orig
+entry:
+  %enter = icmp ugt i64 %n, 0
+  br i1 %enter, label %loop.ph, label %exit
+
+loop.ph:
+  br label %loop
+
+loop:
+  %i = phi i64 [ 0, %loop.ph ], [ %i.next, %cont ]
+  %addr = getelementptr i32, i32* %a, i64 %i
+  %v = load i32, i32* %addr
+  %cmp = icmp sgt i32 %v, 0
+  %c = call i1 @llvm.contract.check(i1 %cmp, i32 0)
+  br i1 %c, label %cont, label %violation
+
+cont:
+  %i.next = add nuw nsw i64 %i, 1
+  %again = icmp ult i64 %i.next, %n
+  br i1 %again, label %loop, label %exit.loopexit
+
+exit.loopexit:
+  br label %exit
+
+exit:
+  ret void
+
+violation:
+  call void @handler(i32 0)
+  unreachable
+}
+
+; A loop with no preheader and an exit shared with the entry block is put in
+; simplified form first.
+define void @f_2(i32* %a, i64 %n, i64 %size) {
+; CHECK-LABEL: @f_2(
+; CHECK: %contract.safe = and i1
+; CHECK: %c.contract.orig = call i1 @llvm.contract.check(i1 %cmp.contract.orig, i32 0)
+; CHECK-NOT: @llvm.contract.check
+; CHECK: violation:
+entry:
+  %enter = icmp ugt i64 %n, 0
+  br i1 %enter, label %loop, label %exit
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %cont ]
+  %cmp = icmp ult i64 %i, %size
+  %c = call i1 @llvm.contract.check(i1 %cmp, i32 0)
+  br i1 %c, label %cont, label %violation
+
+cont:
+  %addr = getelementptr i32, i32* %a, i64 %i
+  store i32 0, i32* %addr
+  %i.next = add nuw nsw i64 %i, 1
+  %again = icmp ult i64 %i.next, %n
+  br i1 %again, label %loop, label %exit
+
+exit:
+  ret void
+
+violation:
+  call void @handler(i32 0)
+  unreachable
+}
+
+; CHECK: ![[PROF]] = !{!"branch_weights", i32 1048575, i32 1}
@@ -0,0 +1,25 @@
+; RUN: opt -S -lower-contract-check < %s | FileCheck %s
+; RUN: opt -S -passes=lower-contract-check < %s | FileCheck %s
+
+declare i1 @llvm.contract.check(i1, i32)
+declare void @handler(i32) noreturn
+
+define void @f_0(i32 %x) {
+; CHECK-LABEL: @f_0(
+entry:
+; CHECK-NOT: @llvm.contract.check
+; CHECK: %cmp = icmp sgt i32 %x, 0
+; CHECK-NEXT: br i1 %cmp, label %cont, label %violation, !prof !0
+  %cmp = icmp sgt i32 %x, 0
+  %c = call i1 @llvm.contract.check(i1 %cmp, i32 5)
+  br i1 %c, label %cont, label %violation, !prof !0
+
+cont:
+  ret void
+
+violation:
+  call void @handler(i32 5)
+  unreachable
+}
+
+!0 = !{!"branch_weights", i32 1048575, i32 1}
@@ -36,6 +36,7 @@
 #include "clang/Basic/Module.h"
 #include "clang/Basic/OperatorKinds.h"
 #include "clang/Basic/PartialDiagnostic.h"
+#include "clang/Basic/ContractPolicy.h"
 #include "clang/Basic/SanitizerBlacklist.h"
 #include "clang/Basic/SourceLocation.h"
 #include "clang/Basic/Specifiers.h"
@@ -75,6 +76,8 @@
 namespace llvm {
 
 struct fltSemantics;
+class Timer;
+class TimerGroup;
 
 } // end namespace llvm
 
@@ -488,6 +491,22 @@ private:
   /// should be imbued with the XRay "always" or "never" attributes.
   std::unique_ptr<XRayFunctionFilter> XRayFilter;
 
+  /// \brief Build levels and axiom modes of the contracts of some functions,
+  /// overriding -build-level= and -axiom-mode= (-fcontract-policy=).
+  std::unique_ptr<ContractPolicy> ContractPolicyList;
+
+  /// \brief The build level and axiom mode of the functions looked up in
+  /// ContractPolicyList, and the mangler of their names.
+  mutable llvm::DenseMap<const FunctionDecl *, std::pair<unsigned, bool>>
+      ContractPolicyCache;
+  mutable std::unique_ptr<MangleContext> ContractPolicyMangler;
+  std::pair<unsigned, bool> lookupContractPolicy(const FunctionDecl *FD) const;
+
+  /// \brief The timers of the processing of contracts, reported by
+  /// -ftime-report (see enableContractTimers()).
+  std::unique_ptr<llvm::TimerGroup> ContractTimerGroup;
+  std::unique_ptr<llvm::Timer[]> ContractTimers;
+
   /// \brief The allocator used to create AST objects.
   ///
   /// AST objects are never destructed; rather, all memory associated with the
@@ -674,6 +693,10 @@ public:
     return *XRayFilter;
   }
 
+  const ContractPolicy &getContractPolicy() const {
+    return *ContractPolicyList;
+  }
+
   DiagnosticsEngine &getDiagnostics() const;
 
   FullSourceLoc getFullLoc(SourceLocation Loc) const {
@@ -1208,6 +1231,30 @@ public:
   void setViolationHandler(FunctionDecl *FD) { ViolationHandler = FD; }
   FunctionDecl *getViolationHandler() { return ViolationHandler; }
 
+  /// \brief Retrieve the build level (0: off, 1: default, 2: audit) of the
+  /// contracts of FD, i.e. of its [[expects]] and [[ensures]] and of the
+  /// [[assert]] in its body: the level given to its mangled name, namespace or
+  /// file by -fcontract-policy=, in this order, or -build-level=.
+  unsigned getContractBuildLevel(const FunctionDecl *FD) const;
+
+  /// \brief Are the axioms of FD assumed?  See getContractBuildLevel().
+  bool getContractAxiomMode(const FunctionDecl *FD) const;
+
+  /// \brief The phases of the processing of contracts timed by -ftime-report.
+  enum ContractTimerKind {
+    CTK_Parse,       ///< Parsing of contract attributes.
+    CTK_Instantiate, ///< Instantiation of contract conditions.
+    CTK_CodeGen,     ///< Emission of contract checks and assumptions.
+    CTK_NumTimers
+  };
+
+  /// \brief Time the processing of contracts (-ftime-report).
+  void enableContractTimers();
+
+  /// \brief Retrieve the timer of the given phase of the processing of
+  /// contracts, or null if they are not timed.  See ContractTimeRegion.
+  llvm::Timer *getContractTimer(ContractTimerKind Kind) const;
+
   /// Returns true iff we need copy/dispose helpers for the given type.
   bool BlockRequiresCopying(QualType Ty, const VarDecl *D);
 
@@ -1824,9 +1871,11 @@ public:
   /// \brief Retrieve the QualType for the __builtin_contract_violation_t (cached).
   QualType getBuiltinContractViolationType();
 
-  /// \brief Retrieve a FunctionDecl of type `void(const __builtin_contract_violation_t &)'
+  /// \brief Retrieve a FunctionDecl of type `void(const __builtin_contract_violation_t &)',
+  /// or `void(ParamTy)' if ParamTy is given
   FunctionDecl *getViolationHandlerDecl(IdentifierInfo *II, StorageClass SC = SC_None,
-                                        FunctionProtoType::ExtProtoInfo EPI = FunctionProtoType::ExtProtoInfo{});
+                                        FunctionProtoType::ExtProtoInfo EPI = FunctionProtoType::ExtProtoInfo{},
+                                        QualType ParamTy = QualType());
 
   /// \brief Retrieve the type of the \c __builtin_va_list type.
   QualType getBuiltinVaListType() const {
@@ -2794,6 +2843,21 @@ public:
   llvm::StringMap<SectionInfo> SectionInfos;
 };
 
+/// \brief Times a phase of the processing of contracts while in scope, if
+/// -ftime-report is given.  Nested regions of the same phase are only counted
+/// once, e.g. when instantiating a contract condition requires instantiating
+/// those of another function.
+class ContractTimeRegion {
+  llvm::Timer *T;
+
+public:
+  ContractTimeRegion(const ASTContext &Ctx,
+                     ASTContext::ContractTimerKind Kind);
+  ContractTimeRegion(const ContractTimeRegion &) = delete;
+  ContractTimeRegion &operator=(const ContractTimeRegion &) = delete;
+  ~ContractTimeRegion();
+};
+
 /// \brief Utility function for constructing a nullary selector.
 static inline Selector GetNullarySelector(StringRef name, ASTContext& Ctx) {
   IdentifierInfo* II = &Ctx.Idents.get(name);
@@ -0,0 +1,82 @@
+//===--- ProvenContracts.h - Preconditions proven at call sites -*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Reader and writer of the files of preconditions proven to hold at their call
+// sites, written by the optin.performance.ProvenContracts checker and read by
+// -fcontract-proven=.  Each line records one [[expects]]:
+//
+//   caller  file:line:column  callee  condition-hash
+//
+// where caller and callee are mangled names, file:line:column is the location
+// of the call, and condition-hash a hash of the text of the precondition.
+// Fields are separated by a tab; lines starting with '#' are comments.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_ANALYSIS_PROVENCONTRACTS_H
+#define LLVM_CLANG_ANALYSIS_PROVENCONTRACTS_H
+
+#include "clang/Basic/LLVM.h"
+#include "clang/Basic/SourceLocation.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+#include <set>
+#include <string>
+#include <tuple>
+
+namespace clang {
+
+class ASTContext;
+class Decl;
+class Expr;
+class MangleContext;
+class SourceManager;
+
+class ProvenContracts {
+public:
+  typedef std::tuple<std::string, std::string, std::string, std::string>
+      KeyTy;
+
+  /// \brief Merge the records in \p Buffer. On failure, returns false and
+  /// sets \p Error.
+  bool read(StringRef Buffer, std::string &Error);
+
+  /// \brief Merge the records of the file \p Path. On failure, returns false
+  /// and sets \p Error.
+  bool readFile(StringRef Path, std::string &Error);
+
+  /// \brief Write all the records to \p OS.
+  void write(raw_ostream &OS) const;
+
+  void add(StringRef Caller, StringRef CallLoc, StringRef Callee,
+           StringRef CondHash);
+  bool contains(StringRef Caller, StringRef CallLoc, StringRef Callee,
+                StringRef CondHash) const;
+  bool empty() const { return Records.empty(); }
+
+  /// \brief Return the name of the function \p D, as written in the records,
+  /// or an empty string if it has none.  Constructors and destructors are
+  /// named by their complete object variant.
+  static std::string getFunctionName(MangleContext &MC, const Decl *D);
+
+  /// \brief Return the location of a call, as written in the records.
+  static std::string getCallLocation(const SourceManager &SM,
+                                     SourceLocation Loc);
+
+  /// \brief Return the hash of the precondition \p Cond, as written in the
+  /// records.
+  static std::string getConditionHash(const ASTContext &Ctx, const Expr *Cond);
+
+private:
+  std::set<KeyTy> Records;
+};
+
+} // end namespace clang
+
+#endif // LLVM_CLANG_ANALYSIS_PROVENCONTRACTS_H
@@ -0,0 +1,62 @@
+//===--- ContractPolicy.h - Per-function contract build levels --*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// User-provided policy that overrides -build-level= and -axiom-mode= for the
+// contracts of some functions, namespaces or files.
+//
+//===----------------------------------------------------------------------===//
+#ifndef LLVM_CLANG_BASIC_CONTRACTPOLICY_H
+#define LLVM_CLANG_BASIC_CONTRACTPOLICY_H
+
+#include "clang/Basic/LLVM.h"
+#include "clang/Basic/SourceLocation.h"
+#include "clang/Basic/SourceManager.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/SpecialCaseList.h"
+#include <memory>
+
+namespace clang {
+
+/// A special case list whose sections are the build levels, [off],
+/// [default] and [audit], and the axiom modes, [axiom-on] and [axiom-off],
+/// e.g.
+/// \code
+///   [off]
+///   src:*/inner_loop/*
+///   ns:math::simd*
+///   [audit]
+///   fun:_ZN6config*
+/// \endcode
+class ContractPolicy {
+  std::unique_ptr<llvm::SpecialCaseList> Policy;
+  SourceManager &SM;
+  bool Empty;
+
+public:
+  ContractPolicy(ArrayRef<std::string> PolicyPaths, SourceManager &SM);
+
+  bool empty() const { return Empty; }
+
+  /// Returns the build level (0: off, 1: default, 2: audit) of the first
+  /// section, in this order, that has an entry Prefix:<E> matching Query.
+  Optional<unsigned> getBuildLevel(StringRef Prefix, StringRef Query) const;
+
+  /// Returns the axiom mode of the first section, [axiom-off] then
+  /// [axiom-on], that has an entry Prefix:<E> matching Query.
+  Optional<bool> getAxiomMode(StringRef Prefix, StringRef Query) const;
+
+  /// Returns the name of the file of Loc, matched by the src: entries.
+  StringRef getFilename(SourceLocation Loc) const;
+};
+
+} // namespace clang
+
+#endif
@@ -123,6 +123,19 @@ public:
   /// If none is specified, std::terminate()
   std::string ContractViolationHandler;
 
+  /// \brief Path to the contract profile (-fcontract-profile-use=) used to
+  /// demote the hottest `default' contract checks to `audit'.
+  std::string ContractProfileUsePath;
+
+  /// \brief Path to the preconditions proven to hold at their call sites
+  /// (-fcontract-proven=), whose checks are omitted.
+  std::string ContractProvenPath;
+
+  /// \brief Paths to the policy files (-fcontract-policy=) setting the build
+  /// level and axiom mode of the contracts of some functions, namespaces or
+  /// files.
+  std::vector<std::string> ContractPolicyFiles;
+
   /// \brief The name of the handler function to be called when -ftrapv is
   /// specified.
   ///
@@ -203,6 +216,11 @@ public:
   bool allowsNonTrivialObjCLifetimeQualifiers() const {
     return ObjCAutoRefCount || ObjCWeak;
   }
+
+  /// \brief Are the conditions of the contracts of the given level (default,
+  /// audit or axiom) checked or assumed in this translation?  Conservatively
+  /// true for all of them with -fcontract-policy=.
+  bool isContractConditionUsed(StringRef Level, bool Ensures) const;
 };
 
 /// \brief Floating point control options
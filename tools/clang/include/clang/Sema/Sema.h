@@ -2442,6 +2442,10 @@ public:
                               unsigned AttrSpellingListIndex);
 
   VarDecl *CXXContracts_MakeInternalReturnVarDecl(IdentifierInfo *II);
+  /// Kinds of contract, in the order of warn_contract_always_false.
+  enum ContractKind { CON_Expects, CON_Ensures, CON_Assert };
+  bool CXXContracts_IsTriviallyTrue(Expr *Cond, ContractKind Kind,
+                                    SourceLocation Loc);
   void mergeDeclAttributes(NamedDecl *New, Decl *Old,
                            AvailabilityMergeKind AMK = AMK_Redeclaration);
   void MergeTypedefNameDecl(Scope *S, TypedefNameDecl *New,
@@ -7734,6 +7738,11 @@ public:
 
   void InstantiateExceptionSpec(SourceLocation PointOfInstantiation,
                                 FunctionDecl *Function);
+  /// Instantiate the pending [[expects]] and [[ensures]] conditions of a
+  /// function template specialization that are checked or assumed at the
+  /// contract build level.
+  void InstantiateContractConditions(SourceLocation PointOfInstantiation,
+                                     FunctionDecl *Function);
   void InstantiateFunctionDefinition(SourceLocation PointOfInstantiation,
                                      FunctionDecl *Function,
                                      bool Recursive = false,
@@ -1223,6 +1223,9 @@ namespace clang {
       DECL_PRAGMA_DETECT_MISMATCH,
       /// \brief An OMPDeclareReductionDecl record.
       DECL_OMP_DECLARE_REDUCTION,
+      /// \brief A record containing the condition of an [[expects]] or
+      /// [[ensures]] attribute.
+      DECL_CONTRACT_CONDITION,
     };
 
     /// \brief Record codes for each kind of statement or expression.
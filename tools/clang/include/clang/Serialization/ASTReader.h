@@ -2157,6 +2157,10 @@ public:
   /// \brief Reads an expression.
   Expr *ReadExpr(ModuleFile &F);
 
+  /// \brief Reads the condition of an [[expects]] or [[ensures]] attribute,
+  /// stored out of line at the given bit offset of the module file.
+  Expr *ReadContractCondition(ModuleFile &F, uint64_t Offset);
+
   /// \brief Reads a sub-statement operand during statement reading.
   Stmt *ReadSubStmt() {
     assert(ReadingKind == Read_Stmt &&
@@ -2343,6 +2347,11 @@ public:
   /// \brief Reads an expression.
   Expr *readExpr() { return Reader->ReadExpr(*F); }
 
+  /// \brief Reads the condition of a contract stored at the given offset.
+  Expr *readContractCondition(uint64_t Offset) {
+    return Reader->ReadContractCondition(*F, Offset);
+  }
+
   /// \brief Reads a sub-statement operand during statement reading.
   Stmt *readSubStmt() { return Reader->ReadSubStmt(); }
 
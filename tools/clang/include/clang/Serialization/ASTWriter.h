@@ -911,6 +911,10 @@ public:
   /// \brief Emit a CXXCtorInitializer array.
   void AddCXXCtorInitializers(ArrayRef<CXXCtorInitializer*> CtorInits);
 
+  /// \brief Emit the condition of a contract in a record of its own, and
+  /// its offset.
+  void AddContractCondition(Expr *Cond);
+
   void AddCXXDefinitionData(const CXXRecordDecl *D);
 
   /// \brief Emit a string.
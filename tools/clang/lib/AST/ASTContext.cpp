@@ -38,6 +38,7 @@
 #include "llvm/ADT/Triple.h"
 #include "llvm/Support/Capacity.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include <map>
 
@@ -751,6 +752,7 @@ ASTContext::ASTContext(LangOptions &LOpts, SourceManager &SM,
       SanitizerBL(new SanitizerBlacklist(LangOpts.SanitizerBlacklistFiles, SM)),
       XRayFilter(new XRayFunctionFilter(LangOpts.XRayAlwaysInstrumentFiles,
                                         LangOpts.XRayNeverInstrumentFiles, SM)),
+      ContractPolicyList(new ContractPolicy(LangOpts.ContractPolicyFiles, SM)),
       AddrSpaceMap(nullptr), Target(nullptr), AuxTarget(nullptr),
       PrintingPolicy(LOpts), Idents(idents), Selectors(sels),
       BuiltinInfo(builtins), DeclarationNames(*this), ExternalSource(nullptr),
@@ -7057,8 +7059,10 @@ QualType ASTContext::getBuiltinContractViolationType() {
 }
 
 FunctionDecl *ASTContext::getViolationHandlerDecl(IdentifierInfo *II, StorageClass SC,
-                                                  FunctionProtoType::ExtProtoInfo EPI) {
-  QualType ParamTy = getLValueReferenceType(getConstType(getBuiltinContractViolationType()));
+                                                  FunctionProtoType::ExtProtoInfo EPI,
+                                                  QualType ParamTy) {
+  if (ParamTy.isNull())
+    ParamTy = getLValueReferenceType(getConstType(getBuiltinContractViolationType()));
   FunctionDecl *FD = FunctionDecl::Create(*this, getTranslationUnitDecl(),
                                           SourceLocation(), SourceLocation(), II,
                                           getFunctionType(VoidTy, { ParamTy }, EPI),
@@ -7069,6 +7073,100 @@ FunctionDecl *ASTContext::getViolationHandlerDecl(IdentifierInfo *II, StorageCla
   return FD;
 }
 
+std::pair<unsigned, bool>
+ASTContext::lookupContractPolicy(const FunctionDecl *FD) const {
+  std::pair<unsigned, bool> Default((unsigned)LangOpts.BuildLevel,
+                                    (bool)LangOpts.AxiomMode);
+  if (!FD || ContractPolicyList->empty())
+    return Default;
+  FD = FD->getCanonicalDecl();
+  auto Res = ContractPolicyCache.insert(std::make_pair(FD, Default));
+  if (!Res.second)
+    return Res.first->second;
+
+  // fun: entries match the mangled name of FD, which templates do not have.
+  SmallString<128> Name;
+  if (!FD->isDependentContext()) {
+    if (!ContractPolicyMangler)
+      ContractPolicyMangler.reset(const_cast<ASTContext *>(this)->createMangleContext());
+    MangleContext &MC = *ContractPolicyMangler;
+    llvm::raw_svector_ostream Out(Name);
+    if (!MC.shouldMangleDeclName(FD))
+      Out << FD->getDeclName();
+    else if (const auto *CD = dyn_cast<CXXConstructorDecl>(FD))
+      MC.mangleCXXCtor(CD, Ctor_Complete, Out);
+    else if (const auto *DD = dyn_cast<CXXDestructorDecl>(FD))
+      MC.mangleCXXDtor(DD, Dtor_Complete, Out);
+    else
+      MC.mangleName(FD, Out);
+  }
+  // ns: entries match the qualified name of the innermost enclosing namespace.
+  std::string Namespace;
+  if (const auto *NS = dyn_cast<NamespaceDecl>(
+          FD->getDeclContext()->getEnclosingNamespaceContext()))
+    Namespace = NS->getQualifiedNameAsString();
+  StringRef File = ContractPolicyList->getFilename(FD->getLocation());
+
+  const ContractPolicy &P = *ContractPolicyList;
+  Optional<unsigned> Level;
+  Optional<bool> AxiomMode;
+  if (!Name.empty()) {
+    Level = P.getBuildLevel("fun", Name);
+    AxiomMode = P.getAxiomMode("fun", Name);
+  }
+  if (!Namespace.empty()) {
+    Level = Level ? Level : P.getBuildLevel("ns", Namespace);
+    AxiomMode = AxiomMode ? AxiomMode : P.getAxiomMode("ns", Namespace);
+  }
+  if (!File.empty()) {
+    Level = Level ? Level : P.getBuildLevel("src", File);
+    AxiomMode = AxiomMode ? AxiomMode : P.getAxiomMode("src", File);
+  }
+  return Res.first->second = std::make_pair(Level.getValueOr(Default.first),
+                                            AxiomMode.getValueOr(Default.second));
+}
+
+unsigned ASTContext::getContractBuildLevel(const FunctionDecl *FD) const {
+  return lookupContractPolicy(FD).first;
+}
+
+bool ASTContext::getContractAxiomMode(const FunctionDecl *FD) const {
+  return lookupContractPolicy(FD).second;
+}
+
+void ASTContext::enableContractTimers() {
+  static const char *const Names[CTK_NumTimers][2] = {
+    {"parse", "Contract Attribute Parsing"},
+    {"instantiate", "Contract Condition Instantiation"},
+    {"codegen", "Contract Check Generation"},
+  };
+  if (ContractTimerGroup)
+    return;
+  ContractTimerGroup.reset(
+      new llvm::TimerGroup("contracts", "Contract Processing Time"));
+  ContractTimers.reset(new llvm::Timer[CTK_NumTimers]);
+  for (unsigned I = 0; I != CTK_NumTimers; ++I)
+    ContractTimers[I].init(Names[I][0], Names[I][1], *ContractTimerGroup);
+}
+
+llvm::Timer *ASTContext::getContractTimer(ContractTimerKind Kind) const {
+  return ContractTimerGroup ? &ContractTimers[Kind] : nullptr;
+}
+
+ContractTimeRegion::ContractTimeRegion(const ASTContext &Ctx,
+                                       ASTContext::ContractTimerKind Kind)
+    : T(Ctx.getContractTimer(Kind)) {
+  if (T && T->isRunning())
+    T = nullptr;
+  if (T)
+    T->startTimer();
+}
+
+ContractTimeRegion::~ContractTimeRegion() {
+  if (T)
+    T->stopTimer();
+}
+
 Decl *ASTContext::getVaListTagDecl() const {
   // Force the creation of VaListTagDecl by building the __builtin_va_list
   // declaration.
@@ -2788,8 +2788,9 @@ VarDecl *FunctionDecl::GetInternalReturnVarDecl() {
   if (________ret________)
     return ________ret________;
 
+  // The declaration may still have to be read from an AST file.
   IdentifierInfo *II = &getASTContext().Idents.get(CXX__INTERNAL_RET);
-  for (auto i : noload_decls()) {
+  for (auto i : decls()) {
     if (VarDecl *VD = dyn_cast<VarDecl>(i))
       if (VD->getDeclName() == II)
         return (________ret________ = VD);
@@ -37,6 +37,7 @@
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/ASTDiagnostic.h"
 #include "clang/AST/ASTLambda.h"
+#include "clang/AST/Attr.h"
 #include "clang/AST/CharUnits.h"
 #include "clang/AST/Expr.h"
 #include "clang/AST/RecordLayout.h"
@@ -44,6 +45,7 @@
 #include "clang/AST/TypeLoc.h"
 #include "clang/Basic/Builtins.h"
 #include "clang/Basic/TargetInfo.h"
+#include "llvm/ADT/StringSwitch.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cstring>
 #include <functional>
@@ -3714,6 +3716,51 @@ static bool EvaluateCond(EvalInfo &Info, const VarDecl *CondDecl,
   return EvaluateAsBooleanCondition(Cond, Result, Info);
 }
 
+namespace {
+/// The kinds of contract, in the order of note_constexpr_contract_violated.
+enum ContractKind { CON_Expects, CON_Ensures, CON_Assert };
+}
+
+/// Check a contract condition in the current call frame.  Only the contracts
+/// checked at the build level of the function (-build-level=,
+/// -fcontract-policy=) are evaluated.  A condition that
+/// is not a constant expression is ignored, as it will be checked at run
+/// time; a false one is diagnosed and makes the evaluation fail.
+static bool CheckContract(EvalInfo &Info, const Attr *A,
+                          const IdentifierInfo *Level, const Expr *Cond,
+                          ContractKind Kind) {
+  if (Info.checkingPotentialConstantExpression() || Cond->isValueDependent())
+    return true;
+  unsigned L = llvm::StringSwitch<unsigned>(Level ? Level->getName() : "")
+                   .Case("default", 1)
+                   .Case("audit", 2)
+                   .Default(~0U);
+  if (L > Info.Ctx.getContractBuildLevel(Info.CurrentCall ? Info.CurrentCall->Callee
+                                                          : nullptr))
+    return true;
+
+  bool Holds;
+  {
+    SpeculativeEvaluationRAII Speculate(Info);
+    if (!EvaluateAsBooleanCondition(Cond, Holds, Info))
+      return true;
+  }
+  if (Holds)
+    return true;
+  Info.FFDiag(A->getLocation(), diag::note_constexpr_contract_violated)
+      << Kind << Cond->getSourceRange();
+  return false;
+}
+
+/// Check the preconditions of the function of the current call frame.
+static bool CheckExpects(EvalInfo &Info, const FunctionDecl *Callee) {
+  for (const auto *A : Callee->specific_attrs<ExpectsAttr>())
+    if (!A->getTriviallyTrue() && !A->getPending() &&
+        !CheckContract(Info, A, A->getLevel(), A->getCond(), CON_Expects))
+      return false;
+  return true;
+}
+
 namespace {
 /// \brief A location where the result (returned value) of evaluating a
 /// statement should be stored.
@@ -4086,7 +4133,14 @@ static EvalStmtResult EvaluateStmt(StmtResult &Result, EvalInfo &Info,
 
   case Stmt::AttributedStmtClass:
     // As a general principle, C++11 attributes can be ignored without
-    // any semantic impact.
+    // any semantic impact.  Contract assertions are checked, though.
+    if (!Case)
+      for (const auto *A : cast<AttributedStmt>(S)->getAttrs())
+        if (const auto *AA = dyn_cast<AssertAttr>(A))
+          if (!AA->getTriviallyTrue() &&
+              !CheckContract(Info, AA, AA->getLevel(), AA->getCond(),
+                             CON_Assert))
+            return ESR_Failed;
     return EvaluateStmt(Result, Info, cast<AttributedStmt>(S)->getSubStmt(),
                         Case);
 
@@ -4210,6 +4264,23 @@ static bool EvaluateArgs(ArrayRef<const Expr*> Args, ArgVector &ArgValues,
   return Success;
 }
 
+/// Check the postconditions of the function of the current call frame, which
+/// returned \p Result.  The return value is bound to the ________ret________
+/// declaration of the function that the conditions refer to.
+static bool CheckEnsures(EvalInfo &Info, const FunctionDecl *Callee,
+                         const APValue &Result) {
+  if (!Callee->hasAttr<EnsuresAttr>())
+    return true;
+  if (VarDecl *RetVD = const_cast<FunctionDecl *>(Callee)
+                           ->GetInternalReturnVarDecl())
+    Info.CurrentCall->createTemporary(RetVD, true) = Result;
+  for (const auto *A : Callee->specific_attrs<EnsuresAttr>())
+    if (!A->getTriviallyTrue() && !A->getPending() &&
+        !CheckContract(Info, A, A->getLevel(), A->getCond(), CON_Ensures))
+      return false;
+  return true;
+}
+
 /// Evaluate a function call.
 static bool HandleFunctionCall(SourceLocation CallLoc,
                                const FunctionDecl *Callee, const LValue *This,
@@ -4225,6 +4296,9 @@ static bool HandleFunctionCall(SourceLocation CallLoc,
 
   CallStackFrame Frame(Info, CallLoc, Callee, This, ArgValues.data());
 
+  if (!CheckExpects(Info, Callee))
+    return false;
+
   // For a trivial copy or move assignment, perform an APValue copy. This is
   // essential for unions, where the operations performed by the assignment
   // operator cannot be represented as statements.
@@ -4258,9 +4332,11 @@ static bool HandleFunctionCall(SourceLocation CallLoc,
   EvalStmtResult ESR = EvaluateStmt(Ret, Info, Body);
   if (ESR == ESR_Succeeded) {
     if (Callee->getReturnType()->isVoidType())
-      return true;
+      return CheckEnsures(Info, Callee, Result);
     Info.FFDiag(Callee->getLocEnd(), diag::note_constexpr_no_return);
   }
+  if (ESR == ESR_Returned && !ResultSlot)
+    return CheckEnsures(Info, Callee, Result);
   return ESR == ESR_Returned;
 }
 
@@ -4283,6 +4359,9 @@ static bool HandleConstructorCall(const Expr *E, const LValue &This,
       Info, {This.getLValueBase(), This.CallIndex});
   CallStackFrame Frame(Info, CallLoc, Definition, &This, ArgValues);
 
+  if (!CheckExpects(Info, Definition))
+    return false;
+
   // FIXME: Creating an APValue just to hold a nonexistent return value is
   // wasteful.
   APValue RetVal;
@@ -5163,6 +5242,10 @@ bool LValueExprEvaluator::VisitVarDecl(const Expr *E, const VarDecl *VD) {
         Info.CurrentCall->Callee->Equals(VD->getDeclContext())) {
       Frame = Info.CurrentCall;
     }
+  } else if (Info.CurrentCall->Index > 1 && Info.CurrentCall->getTemporary(VD)) {
+    // The ________ret________ declaration of a checked function, which is bound
+    // to its return value while its postconditions are checked.
+    Frame = Info.CurrentCall;
   }
 
   if (!VD->getType()->isReferenceType()) {
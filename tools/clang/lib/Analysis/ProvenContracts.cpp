@@ -0,0 +1,114 @@
+//===--- ProvenContracts.cpp - Preconditions proven at call sites ---------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Reader and writer of the files of preconditions proven to hold at their call
+// sites.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Analysis/ProvenContracts.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/DeclCXX.h"
+#include "clang/AST/Expr.h"
+#include "clang/AST/Mangle.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Lex/Lexer.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+using namespace clang;
+
+bool ProvenContracts::read(StringRef Buffer, std::string &Error) {
+  SmallVector<StringRef, 16> Lines;
+  Buffer.split(Lines, '\n');
+  unsigned LineNo = 0;
+  for (StringRef L : Lines) {
+    ++LineNo;
+    L = L.rtrim("\r");
+    if (L.empty() || L.startswith("#"))
+      continue;
+
+    SmallVector<StringRef, 4> Fields;
+    L.split(Fields, '\t');
+    if (Fields.size() != 4) {
+      Error = (Twine("malformed record at line ") + Twine(LineNo)).str();
+      return false;
+    }
+    add(Fields[0], Fields[1], Fields[2], Fields[3]);
+  }
+  return true;
+}
+
+bool ProvenContracts::readFile(StringRef Path, std::string &Error) {
+  auto BufferOrErr = llvm::MemoryBuffer::getFile(Path);
+  if (std::error_code EC = BufferOrErr.getError()) {
+    Error = EC.message();
+    return false;
+  }
+  return read((*BufferOrErr)->getBuffer(), Error);
+}
+
+void ProvenContracts::write(raw_ostream &OS) const {
+  for (const KeyTy &K : Records)
+    OS << std::get<0>(K) << '\t' << std::get<1>(K) << '\t' << std::get<2>(K)
+       << '\t' << std::get<3>(K) << '\n';
+}
+
+void ProvenContracts::add(StringRef Caller, StringRef CallLoc,
+                          StringRef Callee, StringRef CondHash) {
+  Records.insert(KeyTy(Caller, CallLoc, Callee, CondHash));
+}
+
+bool ProvenContracts::contains(StringRef Caller, StringRef CallLoc,
+                               StringRef Callee, StringRef CondHash) const {
+  return Records.count(KeyTy(Caller, CallLoc, Callee, CondHash));
+}
+
+std::string ProvenContracts::getFunctionName(MangleContext &MC,
+                                             const Decl *D) {
+  const auto *FD = dyn_cast_or_null<FunctionDecl>(D);
+  if (!FD)
+    return std::string();
+  std::string Name;
+  llvm::raw_string_ostream OS(Name);
+  if (const auto *CD = dyn_cast<CXXConstructorDecl>(FD))
+    MC.mangleCXXCtor(CD, Ctor_Complete, OS);
+  else if (const auto *DD = dyn_cast<CXXDestructorDecl>(FD))
+    MC.mangleCXXDtor(DD, Dtor_Complete, OS);
+  else if (MC.shouldMangleDeclName(FD))
+    MC.mangleName(FD, OS);
+  else if (const IdentifierInfo *II = FD->getIdentifier())
+    OS << II->getName();
+  return OS.str();
+}
+
+std::string ProvenContracts::getCallLocation(const SourceManager &SM,
+                                             SourceLocation Loc) {
+  FullSourceLoc FSL = FullSourceLoc(Loc, SM).getExpansionLoc();
+  const FileEntry *FE = FSL.getFileEntry();
+  if (!FE)
+    return std::string();
+  return (Twine(FE->getName()) + ":" + Twine(FSL.getLineNumber()) + ":" +
+          Twine(FSL.getColumnNumber()))
+      .str();
+}
+
+std::string ProvenContracts::getConditionHash(const ASTContext &Ctx,
+                                              const Expr *Cond) {
+  StringRef Text = Lexer::getSourceText(
+      CharSourceRange::getTokenRange(Cond->getSourceRange()),
+      Ctx.getSourceManager(), Ctx.getLangOpts());
+  llvm::MD5 Hash;
+  Hash.update(Text);
+  llvm::MD5::MD5Result Result;
+  Hash.final(Result);
+  return Result.digest().str();
+}
@@ -0,0 +1,50 @@
+//===--- ContractPolicy.cpp - Per-function contract build levels ----------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// User-provided policy that overrides -build-level= and -axiom-mode= for the
+// contracts of some functions, namespaces or files.
+//
+//===----------------------------------------------------------------------===//
+#include "clang/Basic/ContractPolicy.h"
+#include "llvm/ADT/STLExtras.h"
+
+using namespace clang;
+
+ContractPolicy::ContractPolicy(ArrayRef<std::string> PolicyPaths,
+                               SourceManager &SM)
+    : Policy(llvm::SpecialCaseList::createOrDie(PolicyPaths)), SM(SM),
+      Empty(PolicyPaths.empty()) {}
+
+Optional<unsigned> ContractPolicy::getBuildLevel(StringRef Prefix,
+                                                 StringRef Query) const {
+  static const char *const Levels[] = {"off", "default", "audit"};
+  if (Empty)
+    return None;
+  for (unsigned Level = 0; Level != llvm::array_lengthof(Levels); ++Level)
+    if (Policy->inSection(Levels[Level], Prefix, Query))
+      return Level;
+  return None;
+}
+
+Optional<bool> ContractPolicy::getAxiomMode(StringRef Prefix,
+                                            StringRef Query) const {
+  if (Empty)
+    return None;
+  if (Policy->inSection("axiom-off", Prefix, Query))
+    return false;
+  if (Policy->inSection("axiom-on", Prefix, Query))
+    return true;
+  return None;
+}
+
+StringRef ContractPolicy::getFilename(SourceLocation Loc) const {
+  if (Loc.isInvalid())
+    return StringRef();
+  return SM.getFilename(SM.getFileLoc(Loc));
+}
@@ -12,6 +12,7 @@
 //===----------------------------------------------------------------------===//
 #include "clang/Basic/LangOptions.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/StringSwitch.h"
 
 using namespace clang;
 
@@ -44,3 +45,15 @@ bool LangOptions::isNoBuiltinFunc(StringRef FuncName) const {
       return true;
   return false;
 }
+
+bool LangOptions::isContractConditionUsed(StringRef Level, bool Ensures) const {
+  if ((Ensures && ContractTrustEnsures) || !ContractPolicyFiles.empty())
+    return true;
+  unsigned L = llvm::StringSwitch<unsigned>(Level)
+                   .Case("default", 1)
+                   .Case("audit", 2)
+                   .Default(3 /*axiom*/);
+  if (L == 3)
+    return AxiomMode;
+  return L <= BuildLevel || ContractAssumeUnchecked;
+}
@@ -443,6 +443,12 @@ public:
   virtual void setThunkLinkage(llvm::Function *Thunk, bool ForVTable,
                                GlobalDecl GD, bool ReturnAdjustment) = 0;
 
+  /// Returns true if the preconditions of virtual member functions can be
+  /// checked by thunks in the vtables, and at their non-virtual call sites,
+  /// instead of by the functions, with -fcontract-vtable-thunks (see
+  /// CodeGenModule::hasContractVTableThunk()).
+  virtual bool canCheckContractsInVTableThunks() const { return false; }
+
   virtual llvm::Value *performThisAdjustment(CodeGenFunction &CGF,
                                              Address This,
                                              const ThisAdjustment &TA) = 0;
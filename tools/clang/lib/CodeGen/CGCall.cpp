@@ -33,10 +33,12 @@
 #include "llvm/IR/Attributes.h"
 #include "llvm/IR/CallingConv.h"
 #include "llvm/IR/CallSite.h"
+#include "llvm/IR/ConstantRange.h"
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/InlineAsm.h"
 #include "llvm/IR/Intrinsics.h"
 #include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/MDBuilder.h"
 #include "llvm/Transforms/Utils/Local.h"
 using namespace clang;
 using namespace CodeGen;
@@ -1774,6 +1776,172 @@ void CodeGenModule::AddDefaultFnAttrs(llvm::Function &F) {
   F.addAttributes(llvm::AttributeList::FunctionIndex, FuncAttrs);
 }
 
+namespace {
+/// Facts about a pointer stated by a contract condition.
+struct ContractPointerFacts {
+  bool NonNull = false;
+  unsigned Align = 0;
+};
+} // end anonymous namespace
+
+/// Returns the declaration of the pointer that E names, or nullptr.
+static const ValueDecl *getContractPointer(const Expr *E) {
+  if (const auto *DRE = dyn_cast<DeclRefExpr>(E->IgnoreParenImpCasts()))
+    if (DRE->getType()->isPointerType())
+      return DRE->getDecl();
+  return nullptr;
+}
+
+/// Collects the facts stated by Cond about pointers, when it is a conjunction
+/// of `p', `p != nullptr', `(uintptr_t)p % A == 0' or `((uintptr_t)p & (A-1))
+/// == 0'; any other conjunct is ignored.
+static void collectContractPointerFacts(
+    ASTContext &Ctx, const Expr *Cond,
+    llvm::DenseMap<const ValueDecl *, ContractPointerFacts> &Facts) {
+  Cond = Cond->IgnoreParens();
+  if (const ValueDecl *VD = getContractPointer(Cond)) {
+    Facts[VD].NonNull = true;
+    return;
+  }
+  const auto *BO = dyn_cast<BinaryOperator>(Cond);
+  if (!BO)
+    return;
+  const Expr *LHS = BO->getLHS(), *RHS = BO->getRHS();
+
+  switch (BO->getOpcode()) {
+  case BO_LAnd:
+    collectContractPointerFacts(Ctx, LHS, Facts);
+    collectContractPointerFacts(Ctx, RHS, Facts);
+    return;
+
+  case BO_NE: {
+    auto IsNull = [&](const Expr *E) {
+      return E->isNullPointerConstant(Ctx, Expr::NPC_ValueDependentIsNotNull) !=
+             Expr::NPCK_NotNull;
+    };
+    if (IsNull(LHS))
+      std::swap(LHS, RHS);
+    if (const ValueDecl *VD = getContractPointer(LHS))
+      if (IsNull(RHS))
+        Facts[VD].NonNull = true;
+    return;
+  }
+
+  case BO_EQ: {
+    auto IsZero = [&](const Expr *E) {
+      llvm::APSInt V;
+      return E->getType()->isIntegerType() && E->EvaluateAsInt(V, Ctx) &&
+             V == 0;
+    };
+    if (IsZero(LHS))
+      std::swap(LHS, RHS);
+    const auto *Mask = dyn_cast<BinaryOperator>(LHS->IgnoreParenImpCasts());
+    llvm::APSInt A;
+    if (!IsZero(RHS) || !Mask || !Mask->getRHS()->EvaluateAsInt(A, Ctx))
+      return;
+    if (Mask->getOpcode() == BO_And)
+      ++A;
+    else if (Mask->getOpcode() != BO_Rem)
+      return;
+    // Only the bits kept by the cast of the pointer are known
+    const auto *CE = dyn_cast<CastExpr>(Mask->getLHS()->IgnoreParenImpCasts());
+    if (!CE || CE->getCastKind() != CK_PointerToIntegral || !A.isPowerOf2() ||
+        A.logBase2() > Ctx.getTypeSize(CE->getType()))
+      return;
+    if (const ValueDecl *VD = getContractPointer(CE->getSubExpr())) {
+      unsigned &Align = Facts[VD].Align;
+      Align = std::max<unsigned>(
+          Align, A.getLimitedValue(llvm::Value::MaximumAlignment));
+    }
+    return;
+  }
+
+  default:
+    return;
+  }
+}
+
+/// Returns the conditions of the postconditions of FD that its callers may
+/// rely on: those assumed to hold, or all of them with -contract-trust-ensures.
+static SmallVector<const Expr *, 2>
+getTrustedContractEnsures(CodeGenModule &CGM, const FunctionDecl *FD) {
+  SmallVector<const Expr *, 2> Conds;
+  for (const EnsuresAttr *A : CGM.getContractEnsures(FD)) {
+    unsigned Level = CodeGenModule::getContractLevel(A->getLevel());
+    if ((CGM.getLangOpts().ContractTrustEnsures ||
+         CGM.isContractAssumed(Level, FD)) &&
+        !A->getPending() && !A->getCond()->isValueDependent())
+      Conds.push_back(A->getCond());
+  }
+  return Conds;
+}
+
+/// Returns true if VD names the value returned by FD in its postconditions.
+static bool isContractReturnVar(const ValueDecl *VD, const FunctionDecl *FD) {
+  const auto *DC = dyn_cast<FunctionDecl>(VD->getDeclContext());
+  return isa<VarDecl>(VD) && DC &&
+         DC->getCanonicalDecl() == FD->getCanonicalDecl() &&
+         VD->getIdentifier() &&
+         VD->getIdentifier()->getName() == FunctionDecl::CXX__INTERNAL_RET;
+}
+
+/// Narrows Range to the values returned by FD that satisfy Cond, when it is a
+/// conjunction of comparisons of the returned value with constants; any other
+/// conjunct is ignored.
+static void collectContractReturnRange(ASTContext &Ctx, const Expr *Cond,
+                                       const FunctionDecl *FD,
+                                       llvm::ConstantRange &Range) {
+  const auto *BO = dyn_cast<BinaryOperator>(Cond->IgnoreParens());
+  if (!BO)
+    return;
+  if (BO->getOpcode() == BO_LAnd) {
+    collectContractReturnRange(Ctx, BO->getLHS(), FD, Range);
+    collectContractReturnRange(Ctx, BO->getRHS(), FD, Range);
+    return;
+  }
+  if (!BO->isRelationalOp() && BO->getOpcode() != BO_EQ)
+    return;
+
+  // The comparison must not promote the returned value
+  auto IsReturnVar = [&](const Expr *E) {
+    const auto *DRE = dyn_cast<DeclRefExpr>(E->IgnoreParenImpCasts());
+    return DRE && isContractReturnVar(DRE->getDecl(), FD) &&
+           Ctx.hasSameUnqualifiedType(E->getType(), DRE->getType());
+  };
+  const Expr *LHS = BO->getLHS(), *RHS = BO->getRHS();
+  BinaryOperatorKind Op = BO->getOpcode();
+  if (IsReturnVar(RHS)) {
+    std::swap(LHS, RHS);
+    Op = BinaryOperator::reverseComparisonOp(Op);
+  }
+  llvm::APSInt C;
+  if (!IsReturnVar(LHS) || !LHS->getType()->isIntegerType() ||
+      !RHS->EvaluateAsInt(C, Ctx) || C.getBitWidth() != Range.getBitWidth())
+    return;
+
+  bool Signed = LHS->getType()->isSignedIntegerOrEnumerationType();
+  llvm::CmpInst::Predicate Pred;
+  switch (Op) {
+  case BO_LT:
+    Pred = Signed ? llvm::CmpInst::ICMP_SLT : llvm::CmpInst::ICMP_ULT;
+    break;
+  case BO_GT:
+    Pred = Signed ? llvm::CmpInst::ICMP_SGT : llvm::CmpInst::ICMP_UGT;
+    break;
+  case BO_LE:
+    Pred = Signed ? llvm::CmpInst::ICMP_SLE : llvm::CmpInst::ICMP_ULE;
+    break;
+  case BO_GE:
+    Pred = Signed ? llvm::CmpInst::ICMP_SGE : llvm::CmpInst::ICMP_UGE;
+    break;
+  default:
+    Pred = llvm::CmpInst::ICMP_EQ;
+    break;
+  }
+  Range =
+      Range.intersectWith(llvm::ConstantRange::makeExactICmpRegion(Pred, C));
+}
+
 void CodeGenModule::ConstructAttributeList(
     StringRef Name, const CGFunctionInfo &FI, CGCalleeInfo CalleeInfo,
     llvm::AttributeList &AttrList, unsigned &CallingConv, bool AttrOnCallSite) {
@@ -1949,6 +2117,26 @@ void CodeGenModule::ConstructAttributeList(
       RetAttrs.addAttribute(llvm::Attribute::NonNull);
   }
 
+  // The postconditions that callers rely on may state that the returned
+  // pointer is nonnull or aligned. They are only given to call sites, lest
+  // the checks in the called function be folded.
+  const auto *TargetFD = dyn_cast_or_null<FunctionDecl>(TargetDecl);
+  if (AttrOnCallSite && TargetFD && RetTy->isPointerType() &&
+      RetAI.isDirect() && RetAI.getCoerceToType()->isPointerTy()) {
+    llvm::DenseMap<const ValueDecl *, ContractPointerFacts> Facts;
+    for (const Expr *Cond : getTrustedContractEnsures(*this, TargetFD))
+      collectContractPointerFacts(getContext(), Cond, Facts);
+    for (const auto &F : Facts) {
+      if (!isContractReturnVar(F.first, TargetFD))
+        continue;
+      if (F.second.NonNull &&
+          getContext().getTargetAddressSpace(RetTy->getPointeeType()) == 0)
+        RetAttrs.addAttribute(llvm::Attribute::NonNull);
+      if (F.second.Align > 1)
+        RetAttrs.addAlignmentAttr(F.second.Align);
+    }
+  }
+
   bool hasUsedSRet = false;
   SmallVector<llvm::AttributeSet, 4> ArgAttrs(IRFunctionArgs.totalIRArgs());
 
@@ -1971,6 +2159,34 @@ void CodeGenModule::ConstructAttributeList(
         llvm::AttributeSet::get(getLLVMContext(), Attrs);
   }
 
+  // The preconditions assumed to hold may state that pointer parameters are
+  // nonnull or aligned; parameters of FD are ParamFacts[ArgNo - FirstParam].
+  SmallVector<ContractPointerFacts, 4> ParamFacts;
+  unsigned FirstParam = 0;
+  if (const FunctionDecl *FD = TargetFD) {
+    llvm::DenseMap<const ValueDecl *, ContractPointerFacts> Facts;
+    for (const ExpectsAttr *A : getContractExpects(FD))
+      if (isContractAssumed(getContractLevel(A->getLevel()), FD) &&
+          !A->getPending() && !A->getCond()->isValueDependent())
+        collectContractPointerFacts(getContext(), A->getCond(), Facts);
+
+    const auto *MD = dyn_cast<CXXMethodDecl>(FD);
+    FirstParam = MD && MD->isInstance() ? 1 : 0;
+    // Skip functions with implicit or pass_object_size arguments
+    if (!Facts.empty() && !FI.isChainCall() &&
+        FI.arg_size() == FirstParam + FD->getNumParams()) {
+      ParamFacts.resize(FD->getNumParams());
+      for (const auto &F : Facts) {
+        const auto *PVD = dyn_cast<ParmVarDecl>(F.first);
+        const auto *DC = PVD ? dyn_cast<FunctionDecl>(PVD->getDeclContext())
+                             : nullptr;
+        if (DC && DC->getCanonicalDecl() == FD->getCanonicalDecl() &&
+            PVD->getFunctionScopeIndex() < ParamFacts.size())
+          ParamFacts[PVD->getFunctionScopeIndex()] = F.second;
+      }
+    }
+  }
+
   unsigned ArgNo = 0;
   for (CGFunctionInfo::const_arg_iterator I = FI.arg_begin(),
                                           E = FI.arg_end();
@@ -2062,6 +2278,17 @@ void CodeGenModule::ConstructAttributeList(
         Attrs.addAttribute(llvm::Attribute::NonNull);
     }
 
+    if (ArgNo >= FirstParam && ArgNo - FirstParam < ParamFacts.size() &&
+        ParamType->isPointerType() && AI.isDirect() &&
+        AI.getCoerceToType()->isPointerTy()) {
+      const ContractPointerFacts &F = ParamFacts[ArgNo - FirstParam];
+      if (F.NonNull &&
+          getContext().getTargetAddressSpace(ParamType->getPointeeType()) == 0)
+        Attrs.addAttribute(llvm::Attribute::NonNull);
+      if (F.Align > 1)
+        Attrs.addAlignmentAttr(F.Align);
+    }
+
     switch (FI.getExtParameterInfo(ArgNo).getABI()) {
     case ParameterABI::Ordinary:
       break;
@@ -3706,11 +3933,19 @@ RValue CodeGenFunction::EmitCall(const CGFunctionInfo &CallInfo,
                                  const CGCallee &Callee,
                                  ReturnValueSlot ReturnValue,
                                  const CallArgList &CallArgs,
-                                 llvm::Instruction **callOrInvoke) {
+                                 llvm::Instruction **callOrInvoke,
+                                 SourceLocation Loc) {
   // FIXME: We no longer need the types from CallArgs; lift up and simplify.
 
   assert(Callee.isOrdinary());
 
+  // P0542R5: if -contract-check-site=caller, check the preconditions of the
+  // callee here, once all the arguments have been evaluated.  Virtual calls
+  // load the callee from the vtable.
+  if (const auto *FD = dyn_cast_or_null<FunctionDecl>(
+          Callee.getAbstractInfo().getCalleeDecl()))
+    EmitCallSiteContractChecks(FD, CallArgs, Loc, Callee.isVirtual());
+
   // Handle struct-return functions by passing a pointer to the
   // location that we would like to return into.
   QualType RetTy = CallInfo.getReturnType();
@@ -4195,6 +4430,22 @@ RValue CodeGenFunction::EmitCall(const CGFunctionInfo &CallInfo,
   CS.setAttributes(Attrs);
   CS.setCallingConv(static_cast<llvm::CallingConv::ID>(CallingConv));
 
+  // The postconditions that callers rely on may bound the returned integer.
+  if (const auto *FD = dyn_cast_or_null<FunctionDecl>(
+          Callee.getAbstractInfo().getCalleeDecl())) {
+    auto *IntTy = dyn_cast<llvm::IntegerType>(CI->getType());
+    if (IntTy && RetTy->isIntegerType() && !RetTy->isBooleanType() &&
+        getContext().getTypeSize(RetTy) == IntTy->getBitWidth()) {
+      llvm::ConstantRange Range(IntTy->getBitWidth(), /*isFullSet=*/true);
+      for (const Expr *Cond : getTrustedContractEnsures(CGM, FD))
+        collectContractReturnRange(getContext(), Cond, FD, Range);
+      if (!Range.isFullSet() && !Range.isEmptySet())
+        CI->setMetadata(llvm::LLVMContext::MD_range,
+                        llvm::MDBuilder(getLLVMContext())
+                            .createRange(Range.getLower(), Range.getUpper()));
+    }
+  }
+
   // Apply various metadata.
 
   if (!CI->getType()->isVoidTy())
@@ -87,6 +87,9 @@ public:
       PseudoDestructorInfoStorage PseudoDestructorInfo;
     };
 
+    /// True if the function pointer was loaded from a vtable.
+    bool Virtual = false;
+
     explicit CGCallee(SpecialKind kind) : KindOrFunctionPointer(kind) {}
 
     CGCallee(const FunctionDecl *builtinDecl, unsigned builtinID)
@@ -127,6 +130,15 @@ public:
       return CGCallee(abstractInfo, functionPtr);
     }
 
+    /// Construct the callee of a virtual call, of which the function pointer
+    /// was loaded from a vtable.
+    static CGCallee forVirtual(const CGCalleeInfo &abstractInfo,
+                               llvm::Value *functionPtr) {
+      CGCallee result(abstractInfo, functionPtr);
+      result.Virtual = true;
+      return result;
+    }
+
     bool isBuiltin() const {
       return KindOrFunctionPointer == SpecialKind::Builtin;
     }
@@ -147,6 +159,10 @@ public:
       return PseudoDestructorInfo.Expr;
     }
 
+    bool isVirtual() const {
+      return Virtual;
+    }
+
     bool isOrdinary() const {
       return uintptr_t(KindOrFunctionPointer) > uintptr_t(SpecialKind::Last);
     }
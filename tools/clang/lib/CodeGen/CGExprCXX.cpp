@@ -89,7 +89,8 @@ RValue CodeGenFunction::EmitCXXMemberOrOperatorCall(
       *this, MD, This, ImplicitParam, ImplicitParamTy, CE, Args, RtlArgs);
   auto &FnInfo = CGM.getTypes().arrangeCXXMethodCall(
       Args, FPT, CallInfo.ReqArgs, CallInfo.PrefixSize);
-  return EmitCall(FnInfo, Callee, ReturnValue, Args);
+  return EmitCall(FnInfo, Callee, ReturnValue, Args, nullptr,
+                  CE ? CE->getExprLoc() : SourceLocation());
 }
 
 RValue CodeGenFunction::EmitCXXDestructorCall(
@@ -375,6 +376,8 @@ RValue CodeGenFunction::EmitCXXMemberOrOperatorMemberCallExpr(
 
     if (getLangOpts().AppleKext && MD->isVirtual() && HasQualifier)
       Callee = BuildAppleKextVirtualCall(MD, Qualifier, Ty);
+    else if (!DevirtualizedMethod && callsContractUncheckedEntry(MD))
+      Callee = CGCallee::forDirect(CGM.GetAddrOfContractUnchecked(MD, Ty), MD);
     else if (!DevirtualizedMethod)
       Callee = CGCallee::forDirect(CGM.GetAddrOfFunction(MD, Ty), MD);
     else {
@@ -22,6 +22,7 @@
 #include "clang/Lex/Lexer.h"
 #include "clang/Sema/LoopHint.h"
 #include "clang/Sema/SemaDiagnostic.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/IR/CallSite.h"
 #include "llvm/IR/DataLayout.h"
@@ -32,6 +33,11 @@
 using namespace clang;
 using namespace CodeGen;
 
+#define DEBUG_TYPE "contracts"
+
+STATISTIC(NumContractAssumptions,
+          "The # of contract conditions emitted as assumptions");
+
 //===----------------------------------------------------------------------===//
 //                              Statement Emission
 //===----------------------------------------------------------------------===//
@@ -555,76 +561,226 @@ void CodeGenFunction::EmitLabelStmt(const LabelStmt &S) {
   EmitStmt(S.getSubStmt());
 }
 
+/// Rough static estimate of the cycles taken to evaluate a contract predicate,
+/// reported by -fcontract-profile: calls are assumed to cost 5 cycles, and
+/// loads and operators 1.
+static unsigned estimateContractCost(const Stmt *S) {
+  unsigned Cost = 0;
+  if (isa<CallExpr>(S))
+    Cost = 5;
+  else if (isa<BinaryOperator>(S) || isa<UnaryOperator>(S) ||
+           isa<ArraySubscriptExpr>(S) || isa<MemberExpr>(S))
+    Cost = 1;
+  else if (auto *ICE = dyn_cast<ImplicitCastExpr>(S))
+    Cost = ICE->getCastKind() == CK_LValueToRValue;
+  for (const Stmt *Child : S->children())
+    if (Child)
+      Cost += estimateContractCost(Child);
+  return Cost;
+}
+
 void CodeGenFunction::EmitAssertAttr(const AssertAttr *_Attr,
-                                     SourceLocation Loc) {
-  unsigned Level = llvm::StringSwitch<unsigned>(_Attr->getLevel()->getName())
-      .Case("default", 1)
-      .Case("audit", 2)
-      .Case("axiom", 3)
-      .Default(~0U);
+                                     SourceLocation Loc,
+                                     const FunctionDecl *FD) {
+  // Sema proved that the condition always holds; nothing to check or assume.
+  if (_Attr->getTriviallyTrue())
+    return;
+
+  ContractTimeRegion Timer(getContext(), ASTContext::CTK_CodeGen);
+
+  unsigned Level = CodeGenModule::getContractLevel(_Attr->getLevel());
   auto &C = getContext();
   Expr *_Expr = _Attr->getCond();
+  // The function the contract belongs to, whose build level applies
+  const FunctionDecl *Owner = FD ? FD : dyn_cast_or_null<FunctionDecl>(CurFuncDecl);
+  unsigned BuildLevel = C.getContractBuildLevel(Owner);
 
-  if (Level == 3/*axiom*/ && CGM.getLangOpts().AxiomMode
-      && !_Expr->HasSideEffects(C)) {
-    // LLVM intrinsic used by __builtin_assume()
-    (void)RValue::get(Builder.CreateCall(CGM.getIntrinsic(llvm::Intrinsic::assume),
-					 EmitScalarExpr(_Expr)));
-  }
+  if (CGM.isContractAssumed(Level, Owner) && !_Expr->HasSideEffects(C))
+    EmitContractAssumption(EmitScalarExpr(_Expr));
 
-  if (CGM.getLangOpts().BuildLevel < Level
+  if (BuildLevel < Level
       || !HaveInsertPoint()) // do not generate unreachable code; -Wunreachable-code enables warning.
     return;
 
+  // __comment is the expression as written in the source code
+  auto &SM = C.getSourceManager();
+  const char *S = SM.getCharacterData(SM.getSpellingLoc(
+					    _Expr->getLocStart())),
+    *E = SM.getCharacterData(Lexer::getLocForEndOfToken(SM.getSpellingLoc(
+					    _Expr->getLocEnd()),
+                                        /*Offset=*/0, SM, CGM.getLangOpts()));
+  StringRef __comment(S, E-S);
+  std::string __func = (FD ? FD : cast<FunctionDecl>(CurFuncDecl))->getNameAsString();
+
+  // -fcontract-profile-use= may demote hot `default' checks to `audit'
+  if (Level == 1/*default*/ && BuildLevel < 2
+      && CGM.isContractCheckDemoted(_Attr->getLocation(), __func, __comment))
+    return;
+
+  // If we're optimizing and the handler does not return, collapse all the
+  // calls to the violation handler down to just one per function (see
+  // EmitTrapCheck()). The landing block can only be shared if no EH cleanups
+  // are active, as the call would otherwise need a site-specific invoke.
+  // -contract-violation-mode=trap: each check has its own trap, which is
+  // all the violation path runs.
+  bool Trap = CGM.getLangOpts().ContractViolationMode == 1 /*trap*/;
+  bool ShareViolationBB = CGM.getCodeGenOpts().OptimizationLevel
+                          && !CGM.getLangOpts().EnableContinueAfterViolation
+                          && !getInvokeDest() && !Trap;
   SmallVector<Expr *, 1> Args;
+  llvm::APInt I;
+  OpaqueValueExpr *OVE = nullptr;
+  bool HaveHandler = !CGM.getLangOpts().ContractViolationHandler.empty()
+                     || CGM.getLangOpts().ContractViolationLog;
+  bool Profile = CGM.getLangOpts().ContractProfile;
+
+  if (HaveHandler || Profile || Trap) {
+    // Register a std::contract_violation object in `__contract_violation_tab[]';
+    // __builtin_violation_handler() takes its index, and the trap its site id
+    I = CGM.Register_contract_violation(_Attr->getLocation(), __func,
+					__comment, Level,
+                                        Profile ? std::max(estimateContractCost(_Expr), 1U) : 0);
+    // The shared landing block takes the index through a PHI node, which is
+    // bound to this OpaqueValueExpr.
+    if (HaveHandler && ShareViolationBB)
+      Args.push_back(OVE = new (C) OpaqueValueExpr(SourceLocation(), C.UnsignedIntTy,
+                                                   VK_RValue));
+    else if (HaveHandler && !Trap)
+      Args.push_back(IntegerLiteral::Create(C, I, C.UnsignedIntTy, SourceLocation()));
+  }
+  bool NeedID = HaveHandler || Profile;
+
+  // Give hint that we very much don't expect to call the violation handler.
+  // Value chosen to match UR_NONTAKEN_WEIGHT, see BranchProbabilityInfo.cpp
+  llvm::MDBuilder MDHelper(getLLVMContext());
+  llvm::MDNode *Weights = MDHelper.createBranchWeights((1U << 20) - 1, 1);
+  llvm::BasicBlock *Cont = createBasicBlock("contract.cont");
+
+  // -contract-sampling=N: only one in N evaluations of `default' checks runs
+  // the predicate, as counted by a thread-local countdown
+  unsigned Sampling = CGM.getLangOpts().ContractSampling;
+  if (Level == 1/*default*/ && Sampling > 1) {
+    Address Countdown(CGM.getContractSamplingCountdown(), CharUnits::fromQuantity(4));
+    llvm::Value *Count = Builder.CreateSub(Builder.CreateLoad(Countdown, "contract.countdown"),
+                                           Builder.getInt32(1));
+    Builder.CreateStore(Count, Countdown);
+    llvm::BasicBlock *SampleBB = createBasicBlock("contract.sample");
+    Builder.CreateCondBr(Builder.CreateICmpSLE(Count, Builder.getInt32(0)), SampleBB, Cont,
+                         MDHelper.createBranchWeights(1, Sampling - 1));
+    EmitBlock(SampleBB);
+    Builder.CreateStore(Builder.getInt32(Sampling), Countdown);
+  }
+
+  if (Profile)
+    EmitContractProfileIncrement(Builder.getInt(I), 0);
+
+  // Mark the predicate so that the optimizer can tell the check apart from
+  // the user's own control flow; see ContractCheckElimination.cpp.
+  llvm::Value *Cond = Builder.CreateCall(
+      CGM.getIntrinsic(llvm::Intrinsic::contract_check),
+      {EvaluateExprAsBool(_Expr), Builder.getInt32(I.getZExtValue())});
+
+  if (ShareViolationBB && ContractViolationBB) {
+    if (NeedID)
+      ContractViolationID->addIncoming(Builder.getInt(I),
+                                       Builder.GetInsertBlock());
+    Builder.CreateCondBr(Cond, Cont, ContractViolationBB, Weights);
+    EmitBlock(Cont);
+    return;
+  }
 
-  if (!CGM.getLangOpts().ContractViolationHandler.empty()) {
-    // __comment is the expression as written in the source code
-    auto &SM = C.getSourceManager();
-    const char *S = SM.getCharacterData(SM.getSpellingLoc(
-					      _Expr->getLocStart())),
-      *E = SM.getCharacterData(Lexer::getLocForEndOfToken(SM.getSpellingLoc(
-					      _Expr->getLocEnd()),
-                                          /*Offset=*/0, SM, CGM.getLangOpts()));
-    StringRef __comment(S, E-S);
-
-    // Register a std::contract_violation object in `__contract_violation_tab[]'
-    llvm::APInt I
-      = CGM.Register_contract_violation(_Attr->getLocation(),
-                                        cast<FunctionDecl>(CurFuncDecl)->getNameAsString(),
-					__comment, Level);
-    IntegerLiteral *IL = IntegerLiteral::Create(C, I,C.IntTy, SourceLocation());
-
-    // Add argument of type `const __builtin_contract_violation&' to
-    // the Args vector
-    DeclRefExpr *__contract_violation_tab
-      = new (C) DeclRefExpr(CGM.getContractViolationTab(),
-                            /*RefersToEnclosingVariableOrCapture=*/false,
-                            CGM.getContractViolationTab()->getType(),
-                            VK_LValue, SourceLocation());
-
-    QualType Ty = C.getConstType(C.getBuiltinContractViolationType());
-    ImplicitCastExpr *ICE = ImplicitCastExpr::Create(C, C.getPointerType(Ty),
-						     CK_ArrayToPointerDecay,
-                                                     __contract_violation_tab,
-						     /*BasePath=*/nullptr,
-						     VK_RValue);
-    Args.push_back(new (C) ArraySubscriptExpr(ICE, IL, Ty, VK_LValue,
-					      OK_Ordinary, SourceLocation()));
+  llvm::BasicBlock *ViolationBB = createBasicBlock("contract.violation");
+  llvm::BasicBlock *From = Builder.GetInsertBlock();
+  Builder.CreateCondBr(Cond, Cont, ViolationBB, Weights);
+  EmitBlock(ViolationBB);
+
+  if (Trap) {
+    EmitContractViolationTrap(I.getZExtValue());
+    // The runtime resumes after the trap if the handler returns.
+    if (!CGM.getLangOpts().EnableContinueAfterViolation)
+      Builder.CreateUnreachable();
+    EmitBlock(Cont);
+    return;
+  }
+
+  llvm::Value *ID = NeedID ? Builder.getInt(I) : nullptr;
+  if (ShareViolationBB) {
+    ContractViolationBB = ViolationBB;
+    if (NeedID) {
+      ContractViolationID = Builder.CreatePHI(Int32Ty, 2, "contract.id");
+      ContractViolationID->addIncoming(Builder.getInt(I), From);
+      ID = ContractViolationID;
+    }
   }
 
+  if (Profile)
+    EmitContractProfileIncrement(ID, 1);
+
   CallExpr *CE = CGM.SynthesizeCallToFunctionDecl(&C, C.getViolationHandler(),
 						  llvm::makeArrayRef(Args));
+  if (OVE) {
+    OpaqueValueMapping OVM(*this, OVE, RValue::get(ContractViolationID));
+    EmitCallExpr(CE);
+  } else
+    EmitCallExpr(CE);
+  // The shared landing block is only entered from the checks; the handler
+  // does not return, so it must not fall through to the first of them.
+  if (ShareViolationBB && HaveInsertPoint())
+    Builder.CreateUnreachable();
+  EmitBlock(Cont);
+}
 
-  // negate expression
-  ParenExpr *PE = new (C) ParenExpr(SourceLocation(), SourceLocation(), _Expr);
-  UnaryOperator *UO = new (C) UnaryOperator(PE, UO_LNot, PE->getType(),
-					    VK_RValue, OK_Ordinary,
-					    SourceLocation());
+void CodeGenFunction::EmitContractAssumption(llvm::Value *Cond) {
+  // LLVM intrinsic used by __builtin_assume()
+  Builder.CreateCall(CGM.getIntrinsic(llvm::Intrinsic::assume), Cond);
+  ++NumContractAssumptions;
+}
+
+void CodeGenFunction::EmitContractViolationTrap(uint32_t SiteId) {
+  // The address of the ud2 is recorded with the site id in the non-loaded
+  // .llvm_contract_traps section; the local label keeps its entry right if
+  // the optimizer duplicates the trap.
+  StringRef AddrDirective =
+      CGM.getDataLayout().getPointerSize() == 8 ? ".quad" : ".long";
+  std::string Asm = (Twine("1:\n"
+                            "\tud2\n"
+                            "\t.pushsection .llvm_contract_traps,\"\",@progbits\n"
+                            "\t") + AddrDirective + " 1b\n"
+                     "\t.long ${0:c}\n"
+                     "\t.popsection").str();
+  // If the handler returns, the runtime calls it out of the signal context
+  // and resumes after the trap: the registers a call does not preserve are
+  // then lost.
+  std::string Constraints = "i";
+  if (CGM.getLangOpts().EnableContinueAfterViolation) {
+    const TargetInfo &Target = getTarget();
+    unsigned NumXMM = 8;
+    if (Target.getTriple().getArch() == llvm::Triple::x86_64) {
+      Constraints += ",~{rax},~{rcx},~{rdx},~{rsi},~{rdi},~{r8},~{r9},~{r10},"
+                     "~{r11}";
+      NumXMM = Target.hasFeature("avx512f") ? 32 : 16;
+    } else
+      Constraints += ",~{eax},~{ecx},~{edx}";
+    for (unsigned I = 0; I != NumXMM; ++I)
+      Constraints += ",~{xmm" + llvm::utostr(I) + "}";
+    Constraints += ",";
+    Constraints += Target.getClobbers();
+  }
+  llvm::InlineAsm *IA = llvm::InlineAsm::get(
+      llvm::FunctionType::get(VoidTy, Int32Ty, /*isVarArg=*/false), Asm,
+      Constraints, /*hasSideEffects=*/true);
+  llvm::CallInst *Call = Builder.CreateCall(IA, Builder.getInt32(SiteId));
+  Call->setDoesNotThrow();
+}
 
-  auto _S = new (C) IfStmt(C, Loc, false, nullptr, nullptr, UO, CE);
-  // TODO: optimize: "if.end" branch is more likely
-  EmitIfStmt(*_S);
+void CodeGenFunction::EmitContractProfileIncrement(llvm::Value *ID,
+                                                   unsigned Counter) {
+  llvm::Value *Ptr = Builder.CreateGEP(CGM.getContractProfileCounters(),
+                                       {Builder.getInt32(0), ID,
+                                        Builder.getInt32(Counter)});
+  Address Addr(Ptr, CharUnits::fromQuantity(8));
+  llvm::Value *Count = Builder.CreateLoad(Addr, "contract.count");
+  Builder.CreateStore(Builder.CreateAdd(Count, Builder.getInt64(1)), Addr);
 }
 
 void CodeGenFunction::EmitAttributedStmt(const AttributedStmt &S) {
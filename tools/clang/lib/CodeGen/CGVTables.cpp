@@ -19,6 +19,7 @@
 #include "clang/AST/RecordLayout.h"
 #include "clang/CodeGen/CGFunctionInfo.h"
 #include "clang/Frontend/CodeGenOptions.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/Format.h"
 #include "llvm/Transforms/Utils/Cloning.h"
 #include <algorithm>
@@ -27,6 +28,11 @@
 using namespace clang;
 using namespace CodeGen;
 
+#define DEBUG_TYPE "contracts"
+
+STATISTIC(NumContractVTableThunks,
+          "The # of thunks emitted that check contracts");
+
 CodeGenVTables::CodeGenVTables(CodeGenModule &CGM)
     : CGM(CGM), VTContext(CGM.getContext().getVTableContext()) {}
 
@@ -483,6 +489,9 @@ void CodeGenVTables::emitThunk(GlobalDecl GD, const ThunkInfo &Thunk,
     // Normal thunk body generation.
     CodeGenFunction(CGM).generateThunk(ThunkFn, FnInfo, GD, Thunk);
   }
+  // All the thunks of such functions check their preconditions.
+  if (CGM.hasContractVTableThunk(cast<CXXMethodDecl>(GD.getDecl())))
+    ++NumContractVTableThunks;
 
   setThunkProperties(CGM, Thunk, ThunkFn, ForVTable, GD);
 }
@@ -515,6 +524,11 @@ void CodeGenVTables::EmitThunks(GlobalDecl GD)
   if (isa<CXXDestructorDecl>(MD) && GD.getDtorType() == Dtor_Base)
     return;
 
+  // The thunk that checks the preconditions of MD in the slots that need no
+  // adjustment.
+  if (CGM.hasContractVTableThunk(MD))
+    emitThunk(GD, ThunkInfo(), /*ForVTable=*/false);
+
   const VTableContextBase::ThunkInfoVectorTy *ThunkInfoVector =
       VTContext->getThunkInfo(GD);
 
@@ -619,6 +633,12 @@ void CodeGenVTables::addVTableComponent(
       nextVTableThunkIndex++;
       fnPtr = CGM.GetAddrOfThunk(GD, thunkInfo);
 
+    // Functions of which the preconditions are checked by a thunk (see
+    // EmitCallSiteContractChecks()).
+    } else if (CGM.hasContractVTableThunk(GD.getDecl()->getAsFunction())) {
+      maybeEmitThunkForVTable(GD, ThunkInfo());
+      fnPtr = CGM.GetAddrOfThunk(GD, ThunkInfo());
+
     // Otherwise we can use the method definition directly.
     } else {
       llvm::Type *fnTy = CGM.getTypes().GetFunctionTypeForVTable(GD);
@@ -13,6 +13,7 @@
 
 #include "CodeGenFunction.h"
 #include "CGBlocks.h"
+#include "CGCall.h"
 #include "CGCleanup.h"
 #include "CGCUDARuntime.h"
 #include "CGCXXABI.h"
@@ -32,6 +33,7 @@
 #include "clang/CodeGen/CGFunctionInfo.h"
 #include "clang/Frontend/CodeGenOptions.h"
 #include "clang/Sema/SemaDiagnostic.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/Intrinsics.h"
 #include "llvm/IR/MDBuilder.h"
@@ -39,6 +41,11 @@
 using namespace clang;
 using namespace CodeGen;
 
+#define DEBUG_TYPE "contracts"
+
+STATISTIC(NumContractUncheckedEntries,
+          "The # of unchecked entry points emitted for contracts");
+
 /// shouldEmitLifetimeMarkers - Decide whether we need emit the life-time
 /// markers.
 static bool shouldEmitLifetimeMarkers(const CodeGenOptions &CGOpts,
@@ -80,6 +87,8 @@ CodeGenFunction::CodeGenFunction(CodeGenModule &cgm, bool suppressNewContext)
       CXXStructorImplicitParamValue(nullptr), OutermostConditional(nullptr),
       CurLexicalScope(nullptr), TerminateLandingPad(nullptr),
       TerminateHandler(nullptr), TrapBB(nullptr),
+      ContractViolationBB(nullptr), ContractViolationID(nullptr),
+      ContractEnsuresFD(nullptr),
       ShouldEmitLifetimeMarkers(
           shouldEmitLifetimeMarkers(CGM.getCodeGenOpts(), CGM.getLangOpts())) {
   if (!suppressNewContext)
@@ -344,6 +353,10 @@ void CodeGenFunction::FinishFunction(SourceLocation EndLoc) {
   // Emit function epilog (to return).
   llvm::DebugLoc Loc = EmitReturnBlock();
 
+  // Check the postconditions on the way out, once the return value is set.
+  if (ContractEnsuresFD)
+    EmitFunctionEnsuresChecks(ContractEnsuresFD);
+
   if (ShouldInstrumentFunction())
     EmitFunctionInstrumentation("__cyg_profile_func_exit");
 
@@ -1217,113 +1230,260 @@ shouldUseUndefinedBehaviorReturnOptimization(const FunctionDecl *FD,
   return !T.isTriviallyCopyableType(Context);
 }
 
-/// SynthesizeCheckedFunctionBody - generates the body of a function that checks
-/// the preconditions(expects)/postconditions(ensures) and calls the '__unchk' function
-static Stmt *
-SynthesizeCheckedFunctionBody(CodeGenModule &CGM, FunctionDecl *D_body, FunctionDecl *D_chk) {
-  ASTContext &Context = CGM.getContext();
-  SourceLocation ISL;
-  SmallVector<Attr*, 8> AS_expects, AS_ensures;
-  VarDecl *________ret________ = D_chk->GetInternalReturnVarDecl();
-
-  // translate 'expects'/'ensures' attributes into 'assert'
-  for (const auto *Attr : D_chk->getAttrs()) {
-    if (const ExpectsAttr *_Attr = dyn_cast<ExpectsAttr>(Attr)) {
-      AS_expects.push_back(AssertAttr::CreateImplicit(Context, _Attr->getLevel(), _Attr->getCond(),
-                                                    _Attr->getLocation()));
-    } else if (const EnsuresAttr *_Attr = dyn_cast<EnsuresAttr>(Attr)) {
-      AS_ensures.push_back(AssertAttr::CreateImplicit(Context, _Attr->getLevel(), _Attr->getCond(),
-                                                    _Attr->getLocation()));
+/// hasContractChecks - returns true if FD has contracts of kind AttrT that were
+/// not folded by Sema (see Sema::CXXContracts_IsTriviallyTrue()).  Conditions
+/// left pending by template instantiation are not used at this build level.
+template <typename AttrT>
+static bool hasContractChecks(const FunctionDecl *FD) {
+  return llvm::any_of(FD->specific_attrs<AttrT>(), [](const AttrT *A) {
+    return !A->getTriviallyTrue() && !A->getPending();
+  });
+}
+
+/// canEvaluateExpectsAtCallSite - returns true if the preconditions of FD can
+/// be evaluated by its callers. Constructors and destructors (which take
+/// implicit arguments) and functions with pass_object_size parameters can't.
+static bool canEvaluateExpectsAtCallSite(const FunctionDecl *FD) {
+  if (isa<CXXConstructorDecl>(FD) || isa<CXXDestructorDecl>(FD))
+    return false;
+  return llvm::none_of(FD->parameters(), [](const ParmVarDecl *P) {
+    return P->hasAttr<PassObjectSizeAttr>();
+  });
+}
+
+/// checkExpectsAtCallSite - returns true if the preconditions of FD are checked
+/// by its callers (-contract-check-site=caller) instead of by FD itself.
+static bool checkExpectsAtCallSite(const LangOptions &LangOpts,
+                                   const FunctionDecl *FD) {
+  return LangOpts.ContractCheckSite == 1 /*caller*/
+         && canEvaluateExpectsAtCallSite(FD);
+}
+
+/// delegatesToOtherVariant - returns true if GD, a constructor or destructor
+/// variant, calls another variant instead of emitting the body of the function
+/// (see EmitConstructorBody() and EmitDestructorBody()).  The contracts are
+/// only checked by the variant that emits the body.
+static bool delegatesToOtherVariant(CodeGenFunction &CGF, GlobalDecl GD) {
+  if (const auto *Ctor = dyn_cast<CXXConstructorDecl>(GD.getDecl()))
+    return GD.getCtorType() == Ctor_Complete
+           && CodeGenFunction::IsConstructorDelegationValid(Ctor)
+           && CGF.CGM.getTarget().getCXXABI().hasConstructorVariants();
+  if (const auto *Dtor = dyn_cast<CXXDestructorDecl>(GD.getDecl())) {
+    if (GD.getDtorType() == Dtor_Base)
+      return false;
+    return GD.getDtorType() == Dtor_Deleting || Dtor->getParent()->isAbstract()
+           || !(Dtor->getBody() && isa<CXXTryStmt>(Dtor->getBody()));
+  }
+  return false;
+}
+
+void CodeGenFunction::EmitFunctionExpectsChecks(const FunctionDecl *FD) {
+  for (const ExpectsAttr *A : FD->specific_attrs<ExpectsAttr>())
+    if (!A->getTriviallyTrue() && !A->getPending())
+      EmitAssertAttr(AssertAttr::CreateImplicit(getContext(), A->getLevel(),
+                                                A->getCond(), A->getLocation()),
+                     SourceLocation(), FD);
+}
+
+/// collectContractParams - adds the parameters S refers to to Params.
+static void
+collectContractParams(const Stmt *S,
+                      llvm::SmallPtrSetImpl<const ParmVarDecl *> &Params) {
+  if (!S)
+    return;
+  if (const auto *DRE = dyn_cast<DeclRefExpr>(S))
+    if (const auto *P = dyn_cast<ParmVarDecl>(DRE->getDecl()))
+      Params.insert(P);
+  for (const Stmt *SubStmt : S->children())
+    collectContractParams(SubStmt, Params);
+}
+
+void CodeGenFunction::EmitContractEnsuresParamCopies(const FunctionDecl *FD) {
+  llvm::SmallPtrSet<const ParmVarDecl *, 4> Used;
+  for (const EnsuresAttr *A : FD->specific_attrs<EnsuresAttr>())
+    if (!A->getTriviallyTrue() && !A->getPending())
+      collectContractParams(A->getCond(), Used);
+
+  // A type that is not trivially copyable can't be copied without side
+  // effects; such parameters are read on exit, which is diagnosed unless they
+  // can't be modified.
+  for (const ParmVarDecl *P : FD->parameters()) {
+    QualType Ty = P->getType();
+    if (!Used.count(P) || Ty->isReferenceType())
+      continue;
+    if (Ty.isVolatileQualified() || !Ty.isTriviallyCopyableType(getContext())) {
+      if (!Ty.isConstQualified())
+        CGM.getDiags().Report(P->getLocation(),
+                              diag::warn_contract_ensures_param_not_copied)
+            << P;
+      continue;
     }
+    Address Addr = GetAddrOfLocalVar(P);
+    Address Copy = CreateMemTemp(Ty, P->getName() + ".entry");
+    if (hasScalarEvaluationKind(Ty))
+      EmitStoreOfScalar(EmitLoadOfScalar(MakeAddrLValue(Addr, Ty),
+                                         P->getLocation()),
+                        MakeAddrLValue(Copy, Ty));
+    else
+      EmitAggregateCopy(Copy, Addr, Ty);
+    ContractEnsuresParams.push_back(std::make_pair(P, Copy));
   }
+}
 
-  // build the parameter list for function call
-  SmallVector<Expr*, 8> Args;
-  for (auto &P : D_body->parameters()) {
-    QualType T = P->getType();
-    QualType NRT = T->isReferenceType() ? T.getNonReferenceType() : T;
-
-    Expr *DRE = new (Context) DeclRefExpr(P, false, NRT, VK_LValue, ISL);
-    if (!T->isReferenceType()) // reference types do not require this ImplicitCastExpr
-      DRE = ImplicitCastExpr::Create(Context, NRT, CK_LValueToRValue, DRE, nullptr, VK_RValue);
-
-    Args.push_back(DRE);
-  }
-  CallExpr *CE = CGM.SynthesizeCallToFunctionDecl(&Context, D_body, Args);
-  ________ret________->setInit(CE);
-  ________ret________->setInitStyle(VarDecl::CInit);
-
-  // build the return statement
-  QualType T = ________ret________->getType();
-  QualType NRT = T->isReferenceType() ? T.getNonReferenceType() : T;
-
-  Expr *DRE = new (Context) DeclRefExpr(________ret________, false, NRT,
-					VK_LValue, ISL);
-  if (!T->isReferenceType()) // Fixes issue #10.  RATIONALE: see above
-    DRE = ImplicitCastExpr::Create(Context, NRT, CK_LValueToRValue, DRE, nullptr,
-				   VK_RValue);
-  // VarDecl::isNRVOVariable() documentation excerpt: "The named return value
-  // optimization (NRVO) works by marking certain non-volatile local variables
-  // of class type as NRVO objects. [...]"
-  ________ret________->setNRVOVariable(!T.isVolatileQualified() && T->isClassType());
-  ReturnStmt *RS = new (Context) ReturnStmt(ISL, DRE, /*NRVOCandidate=*/________ret________);
-
-  // return the body: precondition checks + call __unchk function (inlined) + postcondition checks
-  SmallVector<Stmt *, 4> S;
-  if (AS_expects.size())
-    S.push_back(AttributedStmt::Create(Context, ISL, AS_expects,
-                                       new (Context) NullStmt(ISL)));
-
-  S.push_back(D_body->getReturnType() != Context.VoidTy
-	                           ? static_cast<Stmt *>(new (Context) DeclStmt(
-					DeclGroupRef(________ret________), ISL, ISL))
-                                   : static_cast<Stmt *>(CE));
-
-  if (AS_ensures.size())
-    S.push_back(AttributedStmt::Create(Context, ISL, AS_ensures,
-                                       new (Context) NullStmt(ISL)));
-
-  if (D_body->getReturnType() != Context.VoidTy)
-    S.push_back(RS);
-  return new (Context) CompoundStmt(Context, S, ISL, ISL);
-}
-
-/// \brief Make a (partial) copy of the original CXXMethodDecl/FunctionDecl. For
-///  CXXMethodDecl, don't care if it is a CXX{Constructor,Destructor}Decl.
-static FunctionDecl *
-PartialCopyFunctionDecl(ASTContext &Context, FunctionDecl *FD) {
-  // If this name is a simple identifier, reuse the DeclarationName. Otherwise,
-  // (for a constructor, destructor, or conversion function) construct a non-
-  // special name (required).
-  auto DN_FD = FD->getDeclName();
-  auto DN_ret = DN_FD.isIdentifier() ? DN_FD
-    : DeclarationName{&Context.Idents.get(DN_FD.getAsString())};
-  DeclarationNameInfo NI_ret{DN_ret, SourceLocation{}};
-
-  FunctionDecl *ret;
-  if (isa<CXXMethodDecl>(FD)) {
-    ret = CXXMethodDecl::Create(Context, cast<CXXRecordDecl>(FD->getDeclContext()),
-				SourceLocation{}, NI_ret, FD->getType(),
-				FD->getTypeSourceInfo(), FD->getStorageClass(),
-				FD->isInlineSpecified(), FD->isConstexpr(),
-				SourceLocation{});
-  } else {
-    ret = FunctionDecl::Create(Context, FD->getDeclContext(), SourceLocation{},
-			       NI_ret, FD->getType(), FD->getTypeSourceInfo(),
-			       FD->getStorageClass(), FD->isInlineSpecified(),
-			       FD->hasWrittenPrototype(), FD->isConstexpr());
+void CodeGenFunction::EmitFunctionEnsuresChecks(const FunctionDecl *FD) {
+  // The postconditions refer to the return value as ________ret________.
+  if (VarDecl *RetVD = const_cast<FunctionDecl *>(FD)->GetInternalReturnVarDecl())
+    if (ReturnValue.isValid())
+      setAddrOfLocalVar(RetVD, ReturnValue);
+
+  // ... and to the parameters as they were on entry.
+  for (const auto &Param : ContractEnsuresParams) {
+    LocalDeclMap.erase(Param.first);
+    setAddrOfLocalVar(Param.first, Param.second);
   }
 
-  ret->setImplicit();
-  ret->setParams(FD->parameters());
-  ret->setBody(FD->getBody());
-  if (FD->getPrimaryTemplate())
-    ret->setFunctionTemplateSpecialization(FD->getPrimaryTemplate(),
-					   FD->getTemplateSpecializationArgs(),
-					   nullptr);
-  ret->setAccess(FD->getAccess());
+  for (const EnsuresAttr *A : FD->specific_attrs<EnsuresAttr>())
+    if (!A->getTriviallyTrue() && !A->getPending())
+      EmitAssertAttr(AssertAttr::CreateImplicit(getContext(), A->getLevel(),
+                                                A->getCond(), A->getLocation()),
+                     SourceLocation(), FD);
+}
 
-  return ret;
+void CodeGenFunction::EmitCallSiteContractChecks(const FunctionDecl *FD,
+                                                 const CallArgList &CallArgs,
+                                                 SourceLocation Loc,
+                                                 bool Virtual) {
+  if (!canEvaluateExpectsAtCallSite(FD))
+    return;
+  // The preconditions of a virtual function with a checked vtable thunk are
+  // checked by the thunk if it is called virtually, and here otherwise.
+  bool AtCallSite = CGM.hasContractVTableThunk(FD)
+                        ? !Virtual
+                        : checkExpectsAtCallSite(getLangOpts(), FD);
+  // Otherwise, the callee checks its own preconditions, but those assumed to
+  // hold are still of use to the optimizer in the caller.
+  bool Check = getContext().getContractBuildLevel(FD) > 0 /*off*/ && AtCallSite
+               && !isContractTrustedCaller();
+  if (!Check && !CGM.getCodeGenOpts().OptimizationLevel)
+    return;
+
+  // Checks proven redundant by the static analyzer (-fcontract-proven=) or
+  // folded by Sema are omitted.
+  SmallVector<const ExpectsAttr *, 4> Expects;
+  for (const ExpectsAttr *A : CGM.getContractExpects(FD)) {
+    unsigned Level = CodeGenModule::getContractLevel(A->getLevel());
+    if (!A->getTriviallyTrue() && !A->getPending()
+        && (Check ? !CGM.isContractProven(CurCodeDecl, Loc, FD, A)
+                  : (CGM.isContractAssumed(Level, FD)
+                     && !A->getCond()->HasSideEffects(getContext()))))
+      Expects.push_back(A);
+  }
+  if (Expects.empty())
+    return;
+
+  ContractTimeRegion Timer(getContext(), ASTContext::CTK_CodeGen);
+
+  // [[expects]] may have been merged into a later redeclaration; conditions
+  // refer to the parameters of the redeclaration that holds them.
+  FD = FD->getMostRecentDecl();
+
+  const auto *MD = dyn_cast<CXXMethodDecl>(FD);
+  unsigned FirstArg = (MD && MD->isInstance()) ? 1 : 0;
+  if (CallArgs.size() < FirstArg + FD->getNumParams())
+    return;
+
+  // Bind the parameters of FD (and `this') to the arguments of this call, so
+  // that the conditions can be evaluated in the caller.  Scalars are spilled
+  // to temporaries, which are promoted to registers by SROA.
+  DeclMapTy SavedLocals;
+  for (unsigned I = 0, E = FD->getNumParams(); I != E; ++I) {
+    const ParmVarDecl *PVD = FD->getParamDecl(I);
+    const CallArg &Arg = CallArgs[FirstArg + I];
+
+    Address Addr = Address::invalid();
+    if (Arg.RV.isAggregate())
+      Addr = Arg.RV.getAggregateAddress();
+    else {
+      Addr = CreateMemTemp(PVD->getType(), "contract.arg");
+      EmitStoreThroughLValue(Arg.RV, MakeAddrLValue(Addr, PVD->getType()),
+                             /*isInit=*/true);
+    }
+
+    auto It = LocalDeclMap.find(PVD);
+    if (It != LocalDeclMap.end()) { // e.g. a recursive call
+      SavedLocals.insert(*It);
+      It->second = Addr;
+    } else
+      LocalDeclMap.insert({PVD, Addr});
+  }
+  llvm::Value *SavedThis = CXXThisValue;
+  if (FirstArg)
+    CXXThisValue = Builder.CreateBitCast(CallArgs[0].RV.getScalarVal(),
+                                         ConvertType(MD->getThisType(getContext())));
+
+  for (const ExpectsAttr *A : Expects) {
+    if (Check)
+      EmitAssertAttr(AssertAttr::CreateImplicit(getContext(), A->getLevel(),
+                                                A->getCond(), A->getLocation()),
+                     SourceLocation(), FD);
+    else
+      EmitContractAssumption(EvaluateExprAsBool(A->getCond()));
+  }
+
+  CXXThisValue = SavedThis;
+  for (const ParmVarDecl *PVD : FD->parameters()) {
+    auto It = SavedLocals.find(PVD);
+    if (It != SavedLocals.end())
+      LocalDeclMap.find(PVD)->second = It->second;
+    else
+      LocalDeclMap.erase(PVD);
+  }
+}
+
+bool CodeGenFunction::isContractTrustedCaller() const {
+  if (getContext().getContractBuildLevel(
+          dyn_cast_or_null<FunctionDecl>(CurFuncDecl)) == 0 /*off*/)
+    return true;
+  // A thunk checks the contracts of the function it calls.
+  if (CurFuncIsThunk)
+    return false;
+  return CurFuncDecl && CurFuncDecl->hasAttr<ContractTrustedAttr>();
+}
+
+bool CodeGenFunction::callsContractUncheckedEntry(const FunctionDecl *FD) {
+  return isContractTrustedCaller() && CGM.hasContractUncheckedEntry(FD);
+}
+
+void CodeGenFunction::EmitForwardingCallToUnchecked(
+    const FunctionDecl *Unchecked) {
+  CallArgList CallArgs;
+  if (const auto *MD = dyn_cast<CXXMethodDecl>(Unchecked))
+    if (MD->isInstance())
+      CallArgs.add(RValue::get(LoadCXXThis()), MD->getThisType(getContext()));
+  // Unchecked shares the parameters of the current function.
+  for (const ParmVarDecl *Param : Unchecked->parameters())
+    EmitDelegateCallArg(CallArgs, Param, Param->getLocStart());
+
+  // The result is stored straight into the return value, sret or local, where
+  // the [[ensures]] of the current function are checked in the epilogue;
+  // aggregates returned directly need no temporary either.
+  QualType ResultType = Unchecked->getReturnType();
+  ReturnValueSlot ReturnSlot;
+  if (!ResultType->isVoidType() &&
+      (hasAggregateEvaluationKind(ResultType) ||
+       (CurFnInfo->getReturnInfo().getKind() == ABIArgInfo::Indirect &&
+        !hasScalarEvaluationKind(ResultType))))
+    ReturnSlot = ReturnValueSlot(ReturnValue, ResultType.isVolatileQualified());
+
+  llvm::Constant *CalleePtr = CGM.GetAddrOfFunction(GlobalDecl(Unchecked),
+                                                    CurFn->getFunctionType());
+  RValue RV = EmitCall(*CurFnInfo, CGCallee::forDirect(CalleePtr, Unchecked),
+                       ReturnSlot, CallArgs);
+
+  if (!ResultType->isVoidType() && ReturnSlot.isNull())
+    EmitReturnOfRValue(RV, ResultType);
+  else
+    EmitBranchThroughCleanup(ReturnBlock);
 }
 
 void CodeGenFunction::GenerateCode(GlobalDecl GD, llvm::Function *Fn,
@@ -1334,40 +1494,26 @@ void CodeGenFunction::GenerateCode(GlobalDecl GD, llvm::Function *Fn,
   FunctionArgList Args;
   QualType ResTy = BuildFunctionArgList(GD, Args);
 
-  if (getLangOpts().BuildLevel > 0 // off
-      && (FD->hasAttr<ExpectsAttr>() || FD->hasAttr<EnsuresAttr>())) {
-    // Make a partial copy (unchk_FD) of the original (FD) function; the copy
-    // has the `P0542R5_Unchecked' bit set, which alters name mangling -see
-    // tools/clang/lib/AST/{Itanium,Microsoft}Mangle.cpp. This symbol is usually
-    // private and is always_inline as part of FD.
-    //
-    //                                      (1)    ,----------.  EmitGlobal()
-    //                                          ,--| unchk_FD |-------------->
-    //                                         ,   `----------'
-    // ,-----------------.                    ,  
-    // | FD (has expects | GenerateCode()    ,     ,----.
-    // |    /ensures)    |--------------->--+--->--| FD |-------->
-    // `-----------------'                    (2)  `----'
-    //                                        Here, FD body has been replaced
-    //                                        by {pre,post}condition checks
-    //                                        and a call to unchk_FD, which is
-    //                                        always_inline. 
-    auto unchk_FD = PartialCopyFunctionDecl(getContext(), FD);
-
-    //FD->getParent()->addDecl(unchk_FD);
-    unchk_FD->setP0542R5_Unchecked();
-    CGM.EmitGlobal(unchk_FD);
-
-    // (2) Replaces the body of FD
-    FD->setBody(SynthesizeCheckedFunctionBody(CGM, unchk_FD, FD));
-    FD->dropAttr<ExpectsAttr>(), FD->dropAttr<EnsuresAttr>();
-  }
-
-  // Sets the AlwaysInline attribute for unchecked functions, so that they
-  // are inlined as part of the function that checks pre/post-conditions.
-  // Additionally, InternalLinkage causes the function to be hidden from the IR.
-  if (FD->isP0542R5_Unchecked())
-    Fn->addFnAttr(llvm::Attribute::AlwaysInline), Fn->setLinkage(llvm::Function::InternalLinkage);
+  // The contracts of FD are checked around its body, which is emitted once:
+  // [[expects]] in the prologue, unless they are checked by the callers
+  // (-contract-check-site=caller, see EmitCallSiteContractChecks()) or by the
+  // vtable thunks of a virtual function, and
+  // [[ensures]] in the epilogue (see FinishFunction()).
+  bool CheckContracts = getContext().getContractBuildLevel(FD) > 0 // off
+                        && !delegatesToOtherVariant(*this, GD);
+  bool CheckExpects = CheckContracts && hasContractChecks<ExpectsAttr>(FD)
+                      && !checkExpectsAtCallSite(getLangOpts(), FD)
+                      && !CGM.hasContractVTableThunk(FD);
+  if (CheckContracts && hasContractChecks<EnsuresAttr>(FD))
+    ContractEnsuresFD = FD;
+
+  // With -fcontract-export-unchecked, the body of FD is emitted as its
+  // unchecked entry point, and FD calls it between its checks.
+  const FunctionDecl *UncheckedFD = nullptr;
+  if (CGM.hasContractUncheckedEntry(FD)) {
+    UncheckedFD = CGM.getContractUncheckedDecl(FD);
+    CGM.EmitGlobal(GlobalDecl(UncheckedFD));
+  }
 
   // Check if we should generate debug info for this function.
   if (FD->hasAttr<NoDebugAttr>())
@@ -1407,6 +1553,10 @@ void CodeGenFunction::GenerateCode(GlobalDecl GD, llvm::Function *Fn,
 
   // Generate the body of the function.
   PGO.assignRegionCounters(GD, CurFn);
+  if (ContractEnsuresFD)
+    EmitContractEnsuresParamCopies(ContractEnsuresFD);
+  if (CheckExpects)
+    EmitFunctionExpectsChecks(FD);
   if (isa<CXXDestructorDecl>(FD))
     EmitDestructorBody(Args);
   else if (isa<CXXConstructorDecl>(FD))
@@ -1426,6 +1576,9 @@ void CodeGenFunction::GenerateCode(GlobalDecl GD, llvm::Function *Fn,
     // Implicit copy-assignment gets the same special treatment as implicit
     // copy-constructors.
     emitImplicitAssignmentOperatorBody(Args);
+  } else if (UncheckedFD) {
+    EmitForwardingCallToUnchecked(UncheckedFD);
+    ++NumContractUncheckedEntries;
   } else if (Body) {
     EmitFunctionBody(Args, Body);
   } else
@@ -1425,6 +1425,21 @@ private:
   llvm::BasicBlock *TerminateHandler;
   llvm::BasicBlock *TrapBB;
 
+  /// Shared landing block for contract violations (if optimizing) and the PHI
+  /// node that selects the failing entry of __contract_violation_tab[].  See
+  /// EmitAssertAttr().
+  llvm::BasicBlock *ContractViolationBB;
+  llvm::PHINode *ContractViolationID;
+
+  /// The function of which the [[ensures]] are checked in the epilogue of the
+  /// current function, if any.  See FinishFunction().
+  const FunctionDecl *ContractEnsuresFD;
+
+  /// The copies, made on entry, of the parameters used by those [[ensures]].
+  /// See EmitContractEnsuresParamCopies().
+  SmallVector<std::pair<const ParmVarDecl *, Address>, 2>
+      ContractEnsuresParams;
+
   /// True if we need emit the life-time markers.
   const bool ShouldEmitLifetimeMarkers;
 
@@ -3216,10 +3231,12 @@ public:
 
   /// EmitCall - Generate a call of the given function, expecting the given
   /// result type, and using the given argument list which specifies both the
-  /// LLVM arguments and the types they were derived from.
+  /// LLVM arguments and the types they were derived from.  Loc is the
+  /// location of the call expression, if any.
   RValue EmitCall(const CGFunctionInfo &CallInfo, const CGCallee &Callee,
                   ReturnValueSlot ReturnValue, const CallArgList &Args,
-                  llvm::Instruction **callOrInvoke = nullptr);
+                  llvm::Instruction **callOrInvoke = nullptr,
+                  SourceLocation Loc = SourceLocation());
 
   RValue EmitCall(QualType FnType, const CGCallee &Callee, const CallExpr *E,
                   ReturnValueSlot ReturnValue,
@@ -3580,9 +3597,62 @@ public:
   //===--------------------------------------------------------------------===//
 
 
-  /// EmitAssertAttr - for AssertAttr support.  See EmitAttributedStmt
+  /// EmitAssertAttr - for AssertAttr support.  See EmitAttributedStmt.  FD is
+  /// the function reported to the violation handler (CurFuncDecl if null).
   void EmitAssertAttr(const AssertAttr *_Attr,
-                      SourceLocation Loc = SourceLocation());
+                      SourceLocation Loc = SourceLocation(),
+                      const FunctionDecl *FD = nullptr);
+
+  /// EmitFunctionExpectsChecks - checks the preconditions of FD in the prologue
+  /// of the current function.
+  void EmitFunctionExpectsChecks(const FunctionDecl *FD);
+
+  /// EmitFunctionEnsuresChecks - checks the postconditions of FD in the
+  /// epilogue of the current function, where ________ret________ is bound to
+  /// the return value.
+  void EmitFunctionEnsuresChecks(const FunctionDecl *FD);
+
+  /// EmitContractEnsuresParamCopies - copies, in the prologue of the current
+  /// function, the parameters the postconditions of FD refer to, as the body
+  /// may modify them before they are checked.
+  void EmitContractEnsuresParamCopies(const FunctionDecl *FD);
+
+  /// EmitContractProfileIncrement - for -fcontract-profile; increment the
+  /// evaluation (Counter = 0) or violation (Counter = 1) count of the entry ID
+  /// of __contract_violation_tab[].
+  void EmitContractProfileIncrement(llvm::Value *ID, unsigned Counter);
+
+  /// EmitContractViolationTrap - for -contract-violation-mode=trap; emits the
+  /// trap of a failing check of the given site id.
+  void EmitContractViolationTrap(uint32_t SiteId);
+
+  /// EmitContractAssumption - emits an llvm.assume of Cond, the condition of a
+  /// contract assumed to hold.
+  void EmitContractAssumption(llvm::Value *Cond);
+
+  /// EmitCallSiteContractChecks - for -contract-check-site=caller, emits the
+  /// [[expects]] checks of FD for a call with the given arguments, as well as
+  /// for the non-virtual calls (Virtual = false) to a virtual function with a
+  /// checked vtable thunk. Otherwise, emits an llvm.assume for those assumed
+  /// to hold if optimizing.  Loc is the location of the call, for
+  /// -fcontract-proven=.
+  void EmitCallSiteContractChecks(const FunctionDecl *FD,
+                                  const CallArgList &CallArgs,
+                                  SourceLocation Loc, bool Virtual);
+
+  /// isContractTrustedCaller - returns true if the calls from the current
+  /// function skip the contract checks of the called functions: if it is
+  /// marked [[clang::contract_trusted]], or with -build-level=off.
+  bool isContractTrustedCaller() const;
+
+  /// callsContractUncheckedEntry - returns true if the current function calls
+  /// the unchecked entry point of FD (see
+  /// CodeGenModule::hasContractUncheckedEntry()) instead of FD itself.
+  bool callsContractUncheckedEntry(const FunctionDecl *FD);
+
+  /// EmitForwardingCallToUnchecked - emits the body of a function with an
+  /// unchecked entry point: a call to Unchecked with the same arguments.
+  void EmitForwardingCallToUnchecked(const FunctionDecl *Unchecked);
 
   /// ContainsLabel - Return true if the statement contains a label in it.  If
   /// this statement is not executed normally, it not containing a label means
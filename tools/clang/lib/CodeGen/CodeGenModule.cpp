@@ -21,12 +21,14 @@
 #include "CGOpenCLRuntime.h"
 #include "CGOpenMPRuntime.h"
 #include "CGOpenMPRuntimeNVPTX.h"
+#include "CGRecordLayout.h"
 #include "CodeGenFunction.h"
 #include "CodeGenPGO.h"
 #include "ConstantEmitter.h"
 #include "CoverageMappingGen.h"
 #include "TargetInfo.h"
 #include "clang/AST/ASTContext.h"
+#include "clang/AST/ASTLambda.h"
 #include "clang/AST/CharUnits.h"
 #include "clang/AST/DeclCXX.h"
 #include "clang/AST/DeclObjC.h"
@@ -44,6 +46,9 @@
 #include "clang/CodeGen/ConstantInitBuilder.h"
 #include "clang/Frontend/CodeGenOptions.h"
 #include "clang/Sema/SemaDiagnostic.h"
+#include "llvm/ADT/ScopeExit.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/IR/CallSite.h"
@@ -60,6 +65,11 @@
 using namespace clang;
 using namespace CodeGen;
 
+#define DEBUG_TYPE "contracts"
+
+STATISTIC(NumContractViolationEntries,
+          "The # of contract violation table entries registered");
+
 static llvm::cl::opt<bool> LimitedCoverage(
     "limited-coverage-experimental", llvm::cl::ZeroOrMore,
     llvm::cl::desc("Emit limited coverage mapping information (experimental)"),
@@ -169,16 +179,10 @@ CodeGenModule::CodeGenModule(ASTContext &C, const HeaderSearchOptions &HSO,
   if (CodeGenOpts.CoverageMapping)
     CoverageMapping.reset(new CoverageMappingModuleGen(*this, *CoverageInfo));
 
-  // Cached StringLiteral instances for contract-level strings
-  StringRef SR_contract_level[] = { "always"/* P0542R5: deprecated*/,
-				    "default", "audit" };
-  for (auto &i : SR_contract_level) {
-    __contract_violation_SL.push_back(StringLiteral::Create(C, i, StringLiteral::Ascii, false,
-                                                            C.getConstantArrayType(C.getConstType(C.CharTy),
-                                                                                   llvm::APInt(32, i.size()+1),
-                                                                                   ArrayType::Normal, 0),
-                                                            SourceLocation()));
-  }
+  if (!LangOpts.ContractProfileUsePath.empty())
+    loadContractProfile();
+  if (!LangOpts.ContractProvenPath.empty())
+    loadProvenContracts();
 }
 
 CodeGenModule::~CodeGenModule() {}
@@ -1447,10 +1451,7 @@ void CodeGenModule::EmitDeferred() {
     // up with definitions in unusual ways (e.g. by an extern inline
     // function acquiring a strong function redefinition).  Just
     // ignore these cases.
-    //
-    // __contract_violation_tab is emitted manually after deferred decls
-    // have been emitted.
-    if (!GV->isDeclaration() || D.getDecl() == __contract_violation_tab)
+    if (!GV->isDeclaration())
       continue;
 
     // Otherwise, emit the definition and move on to the next one.
@@ -1467,47 +1468,317 @@ void CodeGenModule::EmitDeferred() {
 }
 
 void CodeGenModule::EmitCXXContractDependencies() {
-  /// __contract_violation_tab will not be emitted in EmitDeferred(); fix initializer-list
-  /// and emit it manually
-  if (!__contract_violation_tab)
+  /// The violation handler is only reached on the failure path of a contract
+  /// check (see CodeGenFunction::EmitAssertAttr); mark it cold and noinline.
+  /// This is done on exit, as emitting __builtin_violation_handler() below
+  /// resets the attributes of the llvm::Function.
+  auto MarkHandlerCold = llvm::make_scope_exit([&] {
+    FunctionDecl *FD = Context.getViolationHandler();
+    if (!FD)
+      return;
+    // Don't mangle it if it is not used: the declarations with a mangled
+    // name are expected to be emitted (see EmitTargetMetadata()).
+    StringRef Name =
+        MangledDeclNames.lookup(GlobalDecl(FD->getCanonicalDecl()));
+    if (Name.empty())
+      return;
+    if (auto *F = dyn_cast_or_null<llvm::Function>(GetGlobalValue(Name))) {
+      F->addFnAttr(llvm::Attribute::Cold);
+      F->addFnAttr(llvm::Attribute::NoInline);
+    }
+  });
+
+  if (__contract_violation_tab.empty())
     return;
-  auto ACV_Ty = Context.getConstantArrayType(Context.getConstType(Context.getBuiltinContractViolationType()),
-                                             llvm::APInt(32, __contract_violation_ILE.size()),
-                                             ArrayType::Normal, 0);
-  InitListExpr *ILE = new (Context) InitListExpr(Context, SourceLocation(),
-                                                 llvm::makeArrayRef(__contract_violation_ILE),
-                                                 SourceLocation());
-  ILE->setType(ACV_Ty);
-  __contract_violation_tab->setInit(ILE);
-  __contract_violation_tab->setInitStyle(VarDecl::CInit);
-  __contract_violation_tab->setType(ACV_Ty);
-
-  EmitGlobalVarDefinition(__contract_violation_tab, !__contract_violation_tab->hasDefinition());
+
+  /// __contract_violation_strtab holds all the strings referenced by the table
+  /// below, each of them only once.
+  llvm::Constant *StrTabInit = llvm::ConstantDataArray::getString(
+      getLLVMContext(), __contract_violation_strtab, /*AddNull=*/false);
+
+  /// __contract_violation_tab[] refers to strings by their offset in
+  /// __contract_violation_strtab; it needs no relocations.
+  llvm::StructType *EntryTy = llvm::StructType::get(
+      getLLVMContext(), {Int32Ty, Int32Ty, Int32Ty, Int32Ty, Int32Ty});
+  SmallVector<llvm::Constant *, 16> Entries;
+  for (const auto &E : __contract_violation_tab) {
+    llvm::Constant *Fields[5];
+    for (unsigned i = 0; i < 5; ++i)
+      Fields[i] = llvm::ConstantInt::get(Int32Ty, E[i]);
+    Entries.push_back(llvm::ConstantStruct::get(EntryTy, Fields));
+  }
+
+  /// -fcontract-violation-site-ids: nothing is loaded but the code; the
+  /// handler looks the site id up in the sections of the program (see
+  /// compiler-rt/lib/contracts/contracts_decode.c).  -fcontract-profile and
+  /// -fcontract-violation-log, which register the table, are not allowed.
+  llvm::GlobalVariable *StrTab = nullptr, *Tab = nullptr;
+  if (getLangOpts().ContractViolationSiteIds)
+    EmitContractViolationInfo(EntryTy, Entries, StrTabInit);
+  else {
+    StrTab = new llvm::GlobalVariable(getModule(), StrTabInit->getType(),
+                                      /*isConstant=*/true,
+                                      llvm::GlobalValue::PrivateLinkage,
+                                      StrTabInit, "__contract_violation_strtab");
+    StrTab->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+    StrTab->setAlignment(1);
+
+    llvm::ArrayType *TabTy = llvm::ArrayType::get(EntryTy, Entries.size());
+    Tab = new llvm::GlobalVariable(getModule(), TabTy, /*isConstant=*/true,
+                                   llvm::GlobalValue::PrivateLinkage,
+                                   llvm::ConstantArray::get(TabTy, Entries),
+                                   "__contract_violation_tab");
+    Tab->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+  }
+
+  /// -fcontract-profile: give the counters their final size and register them
+  /// with the runtime (see compiler-rt/lib/profile/ContractProfiling.c).
+  if (ContractProfileCounters) {
+    llvm::ArrayType *CountersTy = llvm::ArrayType::get(
+        llvm::ArrayType::get(Int64Ty, 2), Entries.size());
+    auto *Counters = new llvm::GlobalVariable(getModule(), CountersTy, /*isConstant=*/false,
+                                              llvm::GlobalValue::PrivateLinkage,
+                                              llvm::ConstantAggregateZero::get(CountersTy));
+    Counters->setAlignment(8);
+    Counters->takeName(ContractProfileCounters);
+    ContractProfileCounters->replaceAllUsesWith(
+        llvm::ConstantExpr::getBitCast(Counters, ContractProfileCounters->getType()));
+    ContractProfileCounters->eraseFromParent();
+    ContractProfileCounters = Counters;
+
+    llvm::Constant *CostInit = llvm::ConstantDataArray::get(getLLVMContext(),
+                                                            __contract_profile_cost);
+    auto *Cost = new llvm::GlobalVariable(getModule(), CostInit->getType(), /*isConstant=*/true,
+                                          llvm::GlobalValue::PrivateLinkage, CostInit,
+                                          "__contract_profile_cost");
+    Cost->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+
+    // struct __contract_profile_module { Next, NumSites, Table, StrTab, Cost, Counters }
+    llvm::StructType *ModuleTy = llvm::StructType::get(
+        getLLVMContext(), {Int8PtrTy, Int32Ty, Int8PtrTy, Int8PtrTy, Int8PtrTy, Int8PtrTy});
+    llvm::Constant *Fields[] = {
+      llvm::Constant::getNullValue(Int8PtrTy),
+      llvm::ConstantInt::get(Int32Ty, Entries.size()),
+      llvm::ConstantExpr::getBitCast(Tab, Int8PtrTy),
+      llvm::ConstantExpr::getBitCast(StrTab, Int8PtrTy),
+      llvm::ConstantExpr::getBitCast(Cost, Int8PtrTy),
+      llvm::ConstantExpr::getBitCast(Counters, Int8PtrTy),
+    };
+    auto *Desc = new llvm::GlobalVariable(getModule(), ModuleTy, /*isConstant=*/false,
+                                          llvm::GlobalValue::PrivateLinkage,
+                                          llvm::ConstantStruct::get(ModuleTy, Fields),
+                                          "__contract_profile_module");
+
+    llvm::Function *Init = llvm::Function::Create(
+        llvm::FunctionType::get(VoidTy, /*isVarArg=*/false),
+        llvm::GlobalValue::InternalLinkage, "__contract_profile_init", &getModule());
+    Init->addFnAttr(llvm::Attribute::NoUnwind);
+    CGBuilderTy Builder(*this, llvm::BasicBlock::Create(getLLVMContext(), "entry", Init));
+    Builder.CreateCall(CreateRuntimeFunction(llvm::FunctionType::get(VoidTy, Int8PtrTy,
+                                                                     /*isVarArg=*/false),
+                                             "__contract_profile_register"),
+                       llvm::ConstantExpr::getBitCast(Desc, Int8PtrTy));
+    Builder.CreateRetVoid();
+    AddGlobalCtor(Init);
+  }
+
+  /// -fcontract-violation-log: register the table with the contracts runtime
+  /// (see compiler-rt/lib/contracts/contracts_log.c), along with the per-site
+  /// state it uses for rate limiting.
+  llvm::GlobalVariable *LogModule = nullptr;
+  if (getLangOpts().ContractViolationLog) {
+    llvm::ArrayType *RateTy = llvm::ArrayType::get(Int64Ty, Entries.size());
+    auto *Rate = new llvm::GlobalVariable(getModule(), RateTy, /*isConstant=*/false,
+                                          llvm::GlobalValue::PrivateLinkage,
+                                          llvm::ConstantAggregateZero::get(RateTy),
+                                          "__contract_log_rate");
+    Rate->setAlignment(8);
+
+    // struct __contract_log_module { Next, NumSites, Index, Table, StrTab, Rate }
+    llvm::StructType *ModuleTy = llvm::StructType::get(
+        getLLVMContext(), {Int8PtrTy, Int32Ty, Int32Ty, Int8PtrTy, Int8PtrTy, Int8PtrTy});
+    llvm::Constant *Fields[] = {
+      llvm::Constant::getNullValue(Int8PtrTy),
+      llvm::ConstantInt::get(Int32Ty, Entries.size()),
+      llvm::ConstantInt::get(Int32Ty, 0),
+      llvm::ConstantExpr::getBitCast(Tab, Int8PtrTy),
+      llvm::ConstantExpr::getBitCast(StrTab, Int8PtrTy),
+      llvm::ConstantExpr::getBitCast(Rate, Int8PtrTy),
+    };
+    LogModule = new llvm::GlobalVariable(getModule(), ModuleTy, /*isConstant=*/false,
+                                         llvm::GlobalValue::PrivateLinkage,
+                                         llvm::ConstantStruct::get(ModuleTy, Fields),
+                                         "__contract_log_module");
+
+    llvm::Function *Init = llvm::Function::Create(
+        llvm::FunctionType::get(VoidTy, /*isVarArg=*/false),
+        llvm::GlobalValue::InternalLinkage, "__contract_log_init", &getModule());
+    Init->addFnAttr(llvm::Attribute::NoUnwind);
+    CGBuilderTy Builder(*this, llvm::BasicBlock::Create(getLLVMContext(), "entry", Init));
+    Builder.CreateCall(CreateRuntimeFunction(llvm::FunctionType::get(VoidTy, Int8PtrTy,
+                                                                     /*isVarArg=*/false),
+                                             "__contract_log_register"),
+                       llvm::ConstantExpr::getBitCast(LogModule, Int8PtrTy));
+    Builder.CreateRetVoid();
+    AddGlobalCtor(Init);
+  }
+
+  /// -contract-violation-mode=trap: the checks only trap; register with the
+  /// contracts runtime, which looks the traps up in a SIGILL handler (see
+  /// compiler-rt/lib/contracts/contracts_trap.c), and passes their site id to
+  /// __builtin_violation_handler() if there is a user-defined handler.  The
+  /// address of the initializer tells the runtime which file to read the
+  /// traps from.
+  if (getLangOpts().ContractViolationMode == 1 /*trap*/) {
+    llvm::Constant *Handler = llvm::Constant::getNullValue(Int8PtrTy);
+    if (!getLangOpts().ContractViolationHandler.empty())
+      Handler = llvm::ConstantExpr::getBitCast(
+          GetAddrOfFunction(GlobalDecl(Context.getViolationHandler())), Int8PtrTy);
+
+    llvm::Function *Init = llvm::Function::Create(
+        llvm::FunctionType::get(VoidTy, /*isVarArg=*/false),
+        llvm::GlobalValue::InternalLinkage, "__contract_trap_init", &getModule());
+    Init->addFnAttr(llvm::Attribute::NoUnwind);
+    CGBuilderTy Builder(*this, llvm::BasicBlock::Create(getLLVMContext(), "entry", Init));
+    llvm::Type *Params[] = {Int8PtrTy, Int8PtrTy};
+    Builder.CreateCall(CreateRuntimeFunction(llvm::FunctionType::get(VoidTy, Params,
+                                                                     /*isVarArg=*/false),
+                                             "__contract_trap_register"),
+                       {Handler, llvm::ConstantExpr::getBitCast(Init, Int8PtrTy)});
+    Builder.CreateRetVoid();
+    AddGlobalCtor(Init);
+  }
 
   /// Sema::Initialize: __builtin_violation_handler() was forward declared; emit definition if required
-  if (getLangOpts().ContractViolationHandler.empty())
+  if (getLangOpts().ContractViolationHandler.empty() && !LogModule)
     return;
 
-  FunctionProtoType::ExtProtoInfo EPI;
-  EPI.ExtInfo = EPI.ExtInfo.withNoReturn(!getLangOpts().EnableContinueAfterViolation);
-  auto FD_vh = Context.getViolationHandlerDecl(&Context.Idents.get(
-                                                "__builtin_violation_handler"), SC_Static, EPI);
-  ParmVarDecl *__parm0 = FD_vh->getParamDecl(0);
-  __parm0->setDeclName(&Context.Idents.get("__parm0"));
-
-  SmallVector<Stmt *,2> CE;
-  CE.push_back(SynthesizeCallToFunctionDecl(&Context, const_cast<FunctionDecl *>( // user-defined handler
-                                             GetRuntimeFunctionDecl(Context,
-                                                                    getLangOpts().ContractViolationHandler)),
-                                            { new (Context) DeclRefExpr(__parm0, false,
-                                                                        __parm0->getType().getNonReferenceType(),
-                                                                        VK_LValue, SourceLocation()) }));
+  /// __builtin_violation_handler(unsigned __id) logs the violation, then
+  /// rebuilds the __builtin_contract_violation_t object for
+  /// __contract_violation_tab[__id] (or for the site id __id) and passes it to
+  /// the user-defined handler.
+  FunctionDecl *FD_vh = Context.getViolationHandler();
+  auto *Fn = cast<llvm::Function>(GetAddrOfFunction(GlobalDecl(FD_vh), /*Ty=*/nullptr,
+                                                    /*ForVTable=*/false, /*DontDefer=*/true,
+                                                    ForDefinition));
+  setFunctionLinkage(GlobalDecl(FD_vh), Fn);
+  SetLLVMFunctionAttributesForDefinition(FD_vh, Fn);
   if (!getLangOpts().EnableContinueAfterViolation)
-    CE.push_back(SynthesizeCallToFunctionDecl(&Context, const_cast<FunctionDecl *>( // _ZSt9terminatev
-                                               GetRuntimeFunctionDecl(Context, "_ZSt9terminatev")), {}));
-  FD_vh->setBody(new (Context) CompoundStmt(Context, CE, SourceLocation(), SourceLocation()));
-
-  EmitGlobalDefinition(FD_vh);
+    Fn->setDoesNotReturn();
+
+  CGBuilderTy Builder(*this, llvm::BasicBlock::Create(getLLVMContext(), "entry", Fn));
+  llvm::Value *Id = &*Fn->arg_begin();
+
+  // Log first: the record is queued without locks, and survives a user
+  // handler that does not return.
+  if (LogModule)
+    Builder.CreateCall(CreateRuntimeFunction(llvm::FunctionType::get(VoidTy,
+                                                                     {Int8PtrTy, Int32Ty},
+                                                                     /*isVarArg=*/false),
+                                             "__contract_violation_log"),
+                       {llvm::ConstantExpr::getBitCast(LogModule, Int8PtrTy), Id});
+
+  if (!getLangOpts().ContractViolationHandler.empty() && Tab)
+    EmitUserViolationHandlerCall(
+        Builder, Builder.CreateInBoundsGEP(Tab->getValueType(), Tab, {Builder.getInt32(0), Id}),
+        EntryTy, llvm::ConstantExpr::getInBoundsGetElementPtr(
+                     StrTab->getValueType(), StrTab,
+                     ArrayRef<llvm::Constant *>{Builder.getInt32(0), Builder.getInt32(0)}));
+  else if (!getLangOpts().ContractViolationHandler.empty()) {
+    // __contract_violation_decode() returns the entry of the site id, and the
+    // strings it refers to.
+    Address StrTabAddr(Builder.CreateAlloca(Int8PtrTy, nullptr, "__strtab"),
+                       getPointerAlign());
+    llvm::Value *Entry = Builder.CreateCall(
+        CreateRuntimeFunction(llvm::FunctionType::get(Int32Ty->getPointerTo(),
+                                                      {Int32Ty, Int8PtrTy->getPointerTo()},
+                                                      /*isVarArg=*/false),
+                              "__contract_violation_decode"),
+        {Id, StrTabAddr.getPointer()});
+    EmitUserViolationHandlerCall(Builder, Builder.CreateBitCast(Entry, EntryTy->getPointerTo()),
+                                 EntryTy, Builder.CreateLoad(StrTabAddr));
+  }
+
+  if (!getLangOpts().EnableContinueAfterViolation) {
+    // The program is about to terminate; write out the queued records.
+    if (LogModule)
+      Builder.CreateCall(CreateRuntimeFunction(llvm::FunctionType::get(VoidTy,
+                                                                       /*isVarArg=*/false),
+                                               "__contract_violation_log_flush"));
+    // _ZSt9terminatev
+    FunctionDecl *FD_terminate = const_cast<FunctionDecl *>(
+        GetRuntimeFunctionDecl(Context, "_ZSt9terminatev"));
+    llvm::CallInst *Call = Builder.CreateCall(GetAddrOfFunction(FD_terminate));
+    Call->setDoesNotReturn();
+    Builder.CreateUnreachable();
+  } else
+    Builder.CreateRetVoid();
+}
+
+void CodeGenModule::EmitUserViolationHandlerCall(CGBuilderTy &Builder, llvm::Value *Entry,
+                                                 llvm::StructType *EntryTy,
+                                                 llvm::Value *StrTab) {
+  const RecordDecl *RD =
+      Context.getBuiltinContractViolationType()->castAs<RecordType>()->getDecl();
+  const CGRecordLayout &RL = getTypes().getCGRecordLayout(RD);
+  llvm::Type *CV_Ty = getTypes().ConvertTypeForMem(Context.getRecordType(RD));
+
+  Address CV(Builder.CreateAlloca(CV_Ty, nullptr, "__violation"),
+             Context.getTypeAlignInChars(Context.getRecordType(RD)));
+  // Fields are laid out in the same order as the entry: __line, __file,
+  // __func, __comment, __level
+  unsigned i = 0;
+  for (const FieldDecl *Field : RD->fields()) {
+    llvm::Value *V = Builder.CreateAlignedLoad(
+        Builder.CreateStructGEP(EntryTy, Entry, i), CharUnits::fromQuantity(4));
+    if (i++ != 0)
+      V = Builder.CreateInBoundsGEP(Int8Ty, StrTab, V);
+    Builder.CreateStore(V, Builder.CreateStructGEP(CV, RL.getLLVMFieldNo(Field),
+                                                   Context.toCharUnitsFromBits(
+                                                     Context.getFieldOffset(Field))));
+  }
+
+  // Call the user-defined handler
+  FunctionDecl *FD_user = const_cast<FunctionDecl *>(
+      GetRuntimeFunctionDecl(Context, getLangOpts().ContractViolationHandler));
+  auto *UserFn = cast<llvm::Function>(GetAddrOfFunction(FD_user));
+  Builder.CreateCall(UserFn, Builder.CreateBitCast(CV.getPointer(),
+                                                   UserFn->getFunctionType()->getParamType(0)));
+}
+
+void CodeGenModule::EmitContractViolationInfo(llvm::StructType *EntryTy,
+                                              ArrayRef<llvm::Constant *> Entries,
+                                              llvm::Constant *StrTabInit) {
+  // struct { Version, NumSites, StrTabSize, { SiteId, Entry } [NumSites],
+  //          StrTab } in a section that is not loaded.  The linker concatenates
+  // those of all the modules; the strings are padded so that they stay aligned.
+  std::string Str = __contract_violation_strtab;
+  Str.resize(llvm::alignTo(Str.size(), 4), '\0');
+  StrTabInit = llvm::ConstantDataArray::getString(getLLVMContext(), Str,
+                                                  /*AddNull=*/false);
+
+  llvm::StructType *SiteTy = llvm::StructType::get(getLLVMContext(), {Int32Ty, EntryTy});
+  SmallVector<llvm::Constant *, 16> Sites;
+  for (unsigned i = 0, e = Entries.size(); i != e; ++i)
+    Sites.push_back(llvm::ConstantStruct::get(
+        SiteTy, {llvm::ConstantInt::get(Int32Ty, __contract_violation_site_ids[i]),
+                 Entries[i]}));
+  llvm::ArrayType *SitesTy = llvm::ArrayType::get(SiteTy, Sites.size());
+
+  llvm::Constant *Fields[] = {
+    llvm::ConstantInt::get(Int32Ty, 1),
+    llvm::ConstantInt::get(Int32Ty, Sites.size()),
+    llvm::ConstantInt::get(Int32Ty, Str.size()),
+    llvm::ConstantArray::get(SitesTy, Sites),
+    StrTabInit,
+  };
+  llvm::Constant *Init = llvm::ConstantStruct::getAnon(Fields, /*Packed=*/true);
+  auto *Info = new llvm::GlobalVariable(getModule(), Init->getType(), /*isConstant=*/true,
+                                        llvm::GlobalValue::PrivateLinkage, Init,
+                                        "__contract_violation_info");
+  Info->setSection(".llvm_contract_info");
+  Info->setAlignment(4);
+  addUsedGlobal(Info);
 }
 
 void CodeGenModule::EmitVTablesOpportunistically() {
@@ -4460,65 +4731,308 @@ bool CodeGenModule::lookupRepresentativeDecl(StringRef MangledName,
   return true;
 }
 
+unsigned CodeGenModule::internContractViolationString(StringRef Str) {
+  auto Res = __contract_violation_str.insert(
+      std::make_pair(Str, __contract_violation_strtab.size()));
+  if (Res.second) {
+    __contract_violation_strtab.append(Str.begin(), Str.end());
+    __contract_violation_strtab.push_back('\0');
+  }
+  return Res.first->getValue();
+}
+
 llvm::APInt CodeGenModule::Register_contract_violation(SourceLocation Loc, StringRef Func,
-                                                       StringRef Comment, unsigned Level) {
-  auto CV_Ty = Context.getConstType(Context.getBuiltinContractViolationType());
-  QualType CChar_Ty = Context.getConstType(Context.CharTy);
-  QualType PCChar_Ty = Context.getPointerType(CChar_Ty);
+                                                       StringRef Comment, unsigned Level,
+                                                       unsigned Cost) {
+  static const char *const LevelName[] = { "always"/* P0542R5: deprecated*/,
+                                           "default", "audit" };
+  assert(Level < llvm::array_lengthof(LevelName) && "invalid contract level");
 
-  SourceLocation InvalidLoc;
+  FullSourceLoc FSL = Context.getFullLoc(Loc).getExpansionLoc();
+  ContractViolationEntry Entry = {{
+    FSL.getLineNumber(),                                        // __line
+    internContractViolationString(FSL.getFileEntry()->getName()), // __file
+    internContractViolationString(Func),                        // __func
+    internContractViolationString(Comment),                     // __comment
+    internContractViolationString(LevelName[Level]),            // __level
+  }};
+
+  /// identical violations (e.g. the same contract checked at several call
+  /// sites, or in several instantiations of a template) share an entry
+  auto Res = __contract_violation_idx.insert(
+      std::make_pair(Entry, (unsigned)__contract_violation_tab.size()));
+  if (Res.second) {
+    ++NumContractViolationEntries;
+    __contract_violation_tab.push_back(Entry);
+    __contract_profile_cost.push_back(Cost);
+    /// -fcontract-violation-site-ids: the id only depends on the text of the
+    /// entry, so that the same site has the same id in every module.  The
+    /// entries of a module have different ids: on a collision, the hash is
+    /// salted until it is unique in the module.  The runtime reports the ids
+    /// shared by different entries of several modules as unknown.
+    if (getLangOpts().ContractViolationSiteIds) {
+      std::string Text = (FSL.getFileEntry()->getName() + StringRef("", 1) +
+                          Func + StringRef("", 1) + Comment +
+                          StringRef("", 1) + LevelName[Level] +
+                          StringRef("", 1) + llvm::utostr(Entry[0])).str();
+      uint32_t Id;
+      unsigned Salt = 0;
+      do {
+        llvm::MD5 Hash;
+        Hash.update(Text);
+        if (Salt) {
+          Hash.update(StringRef("", 1));
+          Hash.update(llvm::utostr(Salt));
+        }
+        llvm::MD5::MD5Result Result;
+        Hash.final(Result);
+        Id = (uint32_t)Result.low();
+        ++Salt;
+      } while (!__contract_violation_used_site_ids.insert(Id).second);
+      __contract_violation_site_ids.push_back(Id);
+    }
+  } else
+    __contract_profile_cost[Res.first->second] =
+        std::max(__contract_profile_cost[Res.first->second], Cost);
+
+  /// return the argument of __builtin_violation_handler(): the index of the
+  /// entry, or its site id
+  if (getLangOpts().ContractViolationSiteIds)
+    return llvm::APInt(32, __contract_violation_site_ids[Res.first->second]);
+  return llvm::APInt(32, Res.first->second);
+}
+
+void CodeGenModule::loadContractProfile() {
+  StringRef Path = getLangOpts().ContractProfileUsePath;
+  llvm::ContractProfile Profile;
+  if (auto E = Profile.readFile(Path)) {
+    unsigned DiagID = Diags.getCustomDiagID(DiagnosticsEngine::Error,
+                                            "Could not read profile %0: %1");
+    llvm::handleAllErrors(std::move(E), [&](const llvm::ErrorInfoBase &EI) {
+      getDiags().Report(DiagID) << Path << EI.message();
+    });
+    return;
+  }
 
-  /// first reference to __contract_violation_tab[]
-  if (!__contract_violation_tab) {
-    __contract_violation_tab = VarDecl::Create(Context, Context.getTranslationUnitDecl(),
-                                               InvalidLoc, InvalidLoc, &Context.Idents.get("__contract_violation_tab"),
-                                               Context.getIncompleteArrayType(CV_Ty, ArrayType::Normal, 0),
-                                               nullptr, SC_Static);
-    __contract_violation_tab->setConstexpr(true);
+  /// Demote the hottest `default' checks, i.e. those with the largest
+  /// estimated cycles, until the -fcontract-profile-top= first ones are demoted
+  /// and the rest take at most -fcontract-profile-budget=% of the cycles.
+  auto Ranking = Profile.getRanking();
+  uint64_t Total = 0;
+  for (const llvm::ContractProfRecord *R : Ranking)
+    Total = llvm::SaturatingAdd(Total, R->getEstimatedCycles());
+  uint64_t Kept = Total;
+  uint64_t Budget = Total / 100 * getLangOpts().ContractProfileBudget
+                    + Total % 100 * getLangOpts().ContractProfileBudget / 100;
+  unsigned TopN = getLangOpts().ContractProfileTopN;
+
+  for (const llvm::ContractProfRecord *R : Ranking) {
+    if (Kept <= Budget && DemotedContractChecks.size() >= TopN)
+      break;
+    if (R->Level != "default" || !R->getEstimatedCycles())
+      continue;
+    DemotedContractChecks.insert(llvm::ContractProfile::KeyTy(
+        R->File, R->Line, R->Function, R->Comment));
+    Kept -= std::min(Kept, R->getEstimatedCycles());
+  }
+}
 
-    EmitGlobal(__contract_violation_tab); // delayed until EmitDeferred() is called
+bool CodeGenModule::isContractCheckDemoted(SourceLocation Loc, StringRef Func,
+                                           StringRef Comment) const {
+  if (DemotedContractChecks.empty())
+    return false;
+  FullSourceLoc FSL = Context.getFullLoc(Loc).getExpansionLoc();
+  return DemotedContractChecks.count(llvm::ContractProfile::KeyTy(
+      FSL.getFileEntry()->getName(), FSL.getLineNumber(), Func, Comment));
+}
+
+void CodeGenModule::loadProvenContracts() {
+  StringRef Path = getLangOpts().ContractProvenPath;
+  std::string Error;
+  if (!ProvenContractChecks.readFile(Path, Error)) {
+    unsigned DiagID = Diags.getCustomDiagID(DiagnosticsEngine::Error,
+                                            "Could not read %0: %1");
+    getDiags().Report(DiagID) << Path << Error;
   }
+}
 
-  /// construct InitListExpr for a __builtin_contract_violation_t object
-  SmallVector<Expr *, 5> Vec;
+bool CodeGenModule::isContractProven(const Decl *Caller, SourceLocation Loc,
+                                     const FunctionDecl *Callee,
+                                     const ExpectsAttr *A) const {
+  if (ProvenContractChecks.empty() || !Caller)
+    return false;
+  /// the keys are those of the optin.performance.ProvenContracts checker
+  MangleContext &MC = getCXXABI().getMangleContext();
+  std::string CallerName = ProvenContracts::getFunctionName(MC, Caller);
+  std::string CalleeName =
+      ProvenContracts::getFunctionName(MC, Callee->getMostRecentDecl());
+  std::string CallLoc =
+      ProvenContracts::getCallLocation(Context.getSourceManager(), Loc);
+  return !CallerName.empty() && !CalleeName.empty() && !CallLoc.empty() &&
+         ProvenContractChecks.contains(
+             CallerName, CallLoc, CalleeName,
+             ProvenContracts::getConditionHash(Context, A->getCond()));
+}
 
-  FullSourceLoc FSL = Context.getFullLoc(Loc).getExpansionLoc();
-  StringRef File = FSL.getFileEntry()->getName();
-  // __line
-  Vec.push_back(IntegerLiteral::Create(Context, llvm::APInt(32, FSL.getLineNumber()), Context.IntTy,
-                                       InvalidLoc));
-
-  StringLiteral *Str[] = {
-    // __file
-    StringLiteral::Create(Context, File, StringLiteral::Ascii, false,
-                          Context.getConstantArrayType(CChar_Ty, llvm::APInt(32, File.size()+1),
-                                                       ArrayType::Normal, 0),
-                          InvalidLoc),
-    // __func
-    StringLiteral::Create(Context, Func, StringLiteral::Ascii, false,
-                          Context.getConstantArrayType(CChar_Ty, llvm::APInt(32, Func.size()+1),
-                                                       ArrayType::Normal, 0),
-                          InvalidLoc),
-    // __comment
-    StringLiteral::Create(Context, Comment, StringLiteral::Ascii, false,
-                          Context.getConstantArrayType(CChar_Ty, llvm::APInt(32, Comment.size()+1),
-                                                       ArrayType::Normal, 0),
-                          InvalidLoc),
-    // __level (cached)
-    __contract_violation_SL[Level],
-  };
-  for (auto &i : Str)
-    Vec.push_back(ImplicitCastExpr::Create(Context, PCChar_Ty, CK_ArrayToPointerDecay, i,
-                                           nullptr, VK_RValue));
-
-  InitListExpr *ILE = new (Context) InitListExpr(Context, InvalidLoc, Vec, InvalidLoc);
-  ILE->setType(CV_Ty);
-
-  /// register and return a llvm::APInt that can be used as RHS for a ArraySubscriptExpr
-  /// e.g. __contract_violation_tab[1]
-  ///                               ^
-  __contract_violation_ILE.push_back(ILE);
-  return std::move(llvm::APInt(32, __contract_violation_ILE.size()-1));
+llvm::GlobalVariable *CodeGenModule::getContractSamplingCountdown() {
+  if (!ContractSamplingCountdown) {
+    ContractSamplingCountdown = new llvm::GlobalVariable(
+        getModule(), Int32Ty, /*isConstant=*/false,
+        llvm::GlobalValue::InternalLinkage, llvm::ConstantInt::get(Int32Ty, 0),
+        "__contract_sampling_countdown");
+    ContractSamplingCountdown->setAlignment(4);
+    if (getTarget().isTLSSupported())
+      ContractSamplingCountdown->setThreadLocalMode(
+          GetLLVMTLSModel(CodeGenOpts.getDefaultTLSModel()));
+  }
+  return ContractSamplingCountdown;
+}
+
+unsigned CodeGenModule::getContractLevel(const IdentifierInfo *Level) {
+  return llvm::StringSwitch<unsigned>(Level->getName())
+      .Case("default", 1)
+      .Case("audit", 2)
+      .Case("axiom", 3)
+      .Default(~0U);
+}
+
+bool CodeGenModule::isContractAssumed(unsigned Level, const FunctionDecl *FD) const {
+  if (Level == 3/*axiom*/)
+    return Context.getContractAxiomMode(FD);
+  return LangOpts.ContractAssumeUnchecked && Level > Context.getContractBuildLevel(FD);
+}
+
+CodeGenModule::ContractExpectsRange
+CodeGenModule::getContractExpects(const FunctionDecl *FD) {
+  return FD->getMostRecentDecl()->specific_attrs<ExpectsAttr>();
+}
+
+CodeGenModule::ContractEnsuresRange
+CodeGenModule::getContractEnsures(const FunctionDecl *FD) {
+  return FD->getMostRecentDecl()->specific_attrs<EnsuresAttr>();
+}
+
+bool CodeGenModule::hasContractUncheckedEntry(const FunctionDecl *FD) {
+  if (!LangOpts.ContractExportUnchecked || FD->isP0542R5_Unchecked())
+    return false;
+  // Constructors and destructors have several variants, and the arguments of
+  // variadic functions can't be forwarded.  Unmangled (e.g. extern "C")
+  // functions can't have a second entry point.
+  if (isa<CXXConstructorDecl>(FD) || isa<CXXDestructorDecl>(FD) ||
+      FD->isVariadic() || isLambdaCallOperator(FD) ||
+      FD->hasAttr<AliasAttr>() || FD->hasAttr<IFuncAttr>() ||
+      FD->hasAttr<WeakRefAttr>() ||
+      !getCXXABI().getMangleContext().shouldMangleDeclName(FD))
+    return false;
+  // In the Microsoft ABI, virtual methods take `this' adjusted to the class
+  // that introduced them.
+  if (const auto *MD = dyn_cast<CXXMethodDecl>(FD))
+    if (MD->isVirtual() && getTarget().getCXXABI().isMicrosoft())
+      return false;
+  if (llvm::any_of(FD->parameters(), [](const ParmVarDecl *P) {
+        return P->hasAttr<PassObjectSizeAttr>();
+      }))
+    return false;
+  // Contracts folded by Sema are not checked anyway.  Pending conditions
+  // (not instantiated, or not read from an AST file) count, so that the entry
+  // points don't depend on the build level.
+  return llvm::any_of(getContractExpects(FD),
+                      [](const ExpectsAttr *A) { return !A->getTriviallyTrue(); })
+         || llvm::any_of(getContractEnsures(FD),
+                      [](const EnsuresAttr *A) { return !A->getTriviallyTrue(); });
+}
+
+bool CodeGenModule::hasContractVTableThunk(const FunctionDecl *FD) {
+  const auto *MD = dyn_cast<CXXMethodDecl>(FD);
+  // This changes the ABI of the functions: they no longer check their
+  // preconditions themselves.
+  if (!LangOpts.ContractVTableThunks || !MD || !MD->isVirtual() ||
+      isa<CXXDestructorDecl>(MD) ||
+      !getCXXABI().canCheckContractsInVTableThunks())
+    return false;
+  // Variadic thunks are clones of the function, and the callers can't pass
+  // pass_object_size arguments to the conditions.
+  if (MD->isVariadic() ||
+      llvm::any_of(MD->parameters(), [](const ParmVarDecl *P) {
+        return P->hasAttr<PassObjectSizeAttr>();
+      }))
+    return false;
+  return llvm::any_of(getContractExpects(MD), [](const ExpectsAttr *A) {
+    return !A->getTriviallyTrue();
+  });
+}
+
+FunctionDecl *CodeGenModule::getContractUncheckedDecl(const FunctionDecl *FD) {
+  FunctionDecl *&Unchecked = ContractUncheckedDecls[FD->getCanonicalDecl()];
+  if (!Unchecked) {
+    // The copy has the name, type and context of FD, so that it is mangled
+    // as FD with the U9unchecked qualifier, but none of its contracts.
+    ASTContext &Context = getContext();
+    FD = FD->getMostRecentDecl();
+    DeclarationNameInfo NameInfo(FD->getDeclName(), FD->getLocation());
+    if (const auto *MD = dyn_cast<CXXMethodDecl>(FD))
+      Unchecked = CXXMethodDecl::Create(
+          Context, const_cast<CXXRecordDecl *>(MD->getParent()),
+          FD->getLocStart(), NameInfo, FD->getType(), FD->getTypeSourceInfo(),
+          FD->getStorageClass(), FD->isInlineSpecified(), FD->isConstexpr(),
+          FD->getLocEnd());
+    else
+      Unchecked = FunctionDecl::Create(
+          Context, const_cast<DeclContext *>(FD->getDeclContext()),
+          FD->getLocStart(), NameInfo, FD->getType(), FD->getTypeSourceInfo(),
+          FD->getStorageClass(), FD->isInlineSpecified(),
+          FD->hasWrittenPrototype(), FD->isConstexpr());
+    // The mangler looks at the parameters; they are replaced by those of the
+    // definition below.
+    Unchecked->setParams(FD->parameters());
+    Unchecked->setImplicit();
+    Unchecked->setAccess(FD->getAccess());
+    Unchecked->setP0542R5_Unchecked();
+    for (const Attr *A : FD->attrs())
+      if (!isa<ExpectsAttr>(A) && !isa<EnsuresAttr>(A))
+        Unchecked->addAttr(A->clone(Context));
+    // Keep the linkage of template instantiations.
+    if (FunctionTemplateDecl *Template = FD->getPrimaryTemplate())
+      Unchecked->setFunctionTemplateSpecialization(
+          Template, FD->getTemplateSpecializationArgs(), /*InsertPos=*/nullptr,
+          FD->getTemplateSpecializationKind());
+    else if (FunctionDecl *Pattern = FD->getInstantiatedFromMemberFunction())
+      Unchecked->setInstantiationOfMemberFunction(
+          Pattern, FD->getTemplateSpecializationKind());
+  }
+
+  // FD may be used before it is defined.
+  const FunctionDecl *Def;
+  if (!Unchecked->doesThisDeclarationHaveABody() && FD->hasBody(Def)) {
+    std::copy(Def->param_begin(), Def->param_end(),
+              Unchecked->param_begin());
+    Unchecked->setBody(Def->getBody());
+    if (Def->isInlined())
+      Unchecked->setImplicitlyInline();
+    if (Unchecked->getTemplateSpecializationKind() != TSK_Undeclared)
+      Unchecked->setTemplateSpecializationKind(
+          Def->getTemplateSpecializationKind());
+  }
+  return Unchecked;
+}
+
+llvm::Constant *
+CodeGenModule::GetAddrOfContractUnchecked(const FunctionDecl *FD,
+                                          llvm::Type *Ty) {
+  // Referring to FD makes sure that it is emitted if it is defined in this
+  // translation unit, and FD emits its unchecked entry point (see
+  // CodeGenFunction::GenerateCode()).
+  GetAddrOfFunction(GlobalDecl(FD), Ty);
+  return GetAddrOfFunction(GlobalDecl(getContractUncheckedDecl(FD)), Ty);
+}
+
+llvm::GlobalVariable *CodeGenModule::getContractProfileCounters() {
+  if (!ContractProfileCounters)
+    ContractProfileCounters = new llvm::GlobalVariable(
+        getModule(), llvm::ArrayType::get(llvm::ArrayType::get(Int64Ty, 2), 0),
+        /*isConstant=*/false, llvm::GlobalValue::ExternalLinkage,
+        /*Initializer=*/nullptr, "__contract_profile_counters");
+  return ContractProfileCounters;
 }
 
 /// Emits metadata nodes associating all the global values in the
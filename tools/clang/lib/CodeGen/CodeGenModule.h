@@ -24,6 +24,7 @@
 #include "clang/AST/DeclOpenMP.h"
 #include "clang/AST/GlobalDecl.h"
 #include "clang/AST/Mangle.h"
+#include "clang/Analysis/ProvenContracts.h"
 #include "clang/Basic/ABI.h"
 #include "clang/Basic/LangOptions.h"
 #include "clang/Basic/Module.h"
@@ -35,7 +36,11 @@
 #include "llvm/ADT/StringMap.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/ValueHandle.h"
+#include "llvm/ProfileData/ContractProf.h"
 #include "llvm/Transforms/Utils/SanitizerStats.h"
+#include <array>
+#include <map>
+#include <set>
 
 namespace llvm {
 class Module;
@@ -94,6 +99,7 @@ class BlockFieldFlags;
 class FunctionArgList;
 class CoverageMappingModuleGen;
 class TargetCodeGenInfo;
+class CGBuilderTy;
 
 enum ForDefinition_t : bool {
   NotForDefinition = false,
@@ -279,9 +285,32 @@ private:
   std::unique_ptr<CGCXXABI> ABI;
   llvm::LLVMContext &VMContext;
 
-  VarDecl *__contract_violation_tab = nullptr;
-  std::vector<Expr *> __contract_violation_ILE; // InitListExpr of type __builtin_contract_violation_t for each emitted `assert'
-  llvm::SmallVector<StringLiteral *, 3> __contract_violation_SL;
+  /// Entries of __contract_violation_tab[]: line, and offsets of the file,
+  /// function, comment and level strings in __contract_violation_strtab.
+  typedef std::array<unsigned, 5> ContractViolationEntry;
+  std::vector<ContractViolationEntry> __contract_violation_tab;
+  std::map<ContractViolationEntry, unsigned> __contract_violation_idx;
+  std::string __contract_violation_strtab;
+  llvm::StringMap<unsigned> __contract_violation_str;
+  unsigned internContractViolationString(StringRef Str);
+  /// -fcontract-violation-site-ids: the id of each entry, a hash of its text.
+  std::vector<uint32_t> __contract_violation_site_ids;
+  llvm::DenseSet<uint32_t> __contract_violation_used_site_ids;
+  /// -fcontract-profile: estimated cost of each entry of
+  /// __contract_violation_tab[], and the counters indexed by it.
+  std::vector<unsigned> __contract_profile_cost;
+  llvm::GlobalVariable *ContractProfileCounters = nullptr;
+  /// -contract-sampling=: thread-local countdown to the next sampled check.
+  llvm::GlobalVariable *ContractSamplingCountdown = nullptr;
+  /// -fcontract-profile-use: `default' checks demoted to `audit'.
+  std::set<llvm::ContractProfile::KeyTy> DemotedContractChecks;
+  void loadContractProfile();
+  /// -fcontract-proven=: preconditions proven to hold at their call sites.
+  ProvenContracts ProvenContractChecks;
+  void loadProvenContracts();
+  /// -fcontract-export-unchecked: unchecked entry point of each function with
+  /// contracts (by canonical declaration).
+  llvm::DenseMap<const FunctionDecl *, FunctionDecl *> ContractUncheckedDecls;
 
   std::unique_ptr<CodeGenTBAA> TBAA;
   
@@ -637,9 +666,74 @@ public:
   CGCXXABI &getCXXABI() const { return *ABI; }
   llvm::LLVMContext &getLLVMContext() { return VMContext; }
 
-  VarDecl *getContractViolationTab() { return __contract_violation_tab; }
   llvm::APInt Register_contract_violation(SourceLocation Loc, StringRef Func,
-                                          StringRef Comment, unsigned Level);
+                                          StringRef Comment, unsigned Level,
+                                          unsigned Cost = 0);
+
+  /// Return the -fcontract-profile counters: an array of {evaluations,
+  /// violations} pairs of i64, indexed by the value returned by
+  /// Register_contract_violation().  The returned global is a placeholder,
+  /// replaced when the size of the table is known.
+  llvm::GlobalVariable *getContractProfileCounters();
+
+  /// Return true if the profile given by -fcontract-profile-use= demotes the
+  /// `default' contract check at Loc in Func to `audit'.
+  bool isContractCheckDemoted(SourceLocation Loc, StringRef Func,
+                              StringRef Comment) const;
+
+  /// Return true if the file given by -fcontract-proven= records the
+  /// precondition A of Callee as proven to hold at the call at Loc in Caller.
+  bool isContractProven(const Decl *Caller, SourceLocation Loc,
+                        const FunctionDecl *Callee,
+                        const ExpectsAttr *A) const;
+
+  /// Return the i32 countdown to the next `default' contract check evaluated
+  /// with -contract-sampling=; thread-local if the target supports it.
+  llvm::GlobalVariable *getContractSamplingCountdown();
+
+  /// Return the level of a contract: 1 for `default', 2 for `audit' and 3 for
+  /// `axiom'.
+  static unsigned getContractLevel(const IdentifierInfo *Level);
+
+  /// Return true if the contracts of FD of the given level are assumed to
+  /// hold, i.e. axioms with -axiom-mode=on, and contracts that are not checked
+  /// with -contract-assume-unchecked.  -fcontract-policy= may set the axiom
+  /// mode and build level of FD.
+  bool isContractAssumed(unsigned Level, const FunctionDecl *FD) const;
+
+  typedef llvm::iterator_range<specific_attr_iterator<ExpectsAttr>>
+      ContractExpectsRange;
+  typedef llvm::iterator_range<specific_attr_iterator<EnsuresAttr>>
+      ContractEnsuresRange;
+
+  /// Return the preconditions of FD, which may have been merged into a later
+  /// redeclaration.
+  ContractExpectsRange getContractExpects(const FunctionDecl *FD);
+
+  /// Return the postconditions of FD, which may have been merged into a later
+  /// redeclaration.
+  ContractEnsuresRange getContractEnsures(const FunctionDecl *FD);
+
+  /// Return true if FD has an unchecked entry point (-fcontract-export-unchecked):
+  /// a copy of FD without contract checks, mangled with the U9unchecked
+  /// qualifier, which FD calls once its preconditions are checked and which
+  /// trusted callers call directly.
+  bool hasContractUncheckedEntry(const FunctionDecl *FD);
+
+  /// Return true if the [[expects]] of FD, a virtual member function, are
+  /// checked by the thunks in the vtables when it is called virtually, and by
+  /// the callers when it is called directly, instead of by FD itself
+  /// (-fcontract-vtable-thunks).
+  bool hasContractVTableThunk(const FunctionDecl *FD);
+
+  /// Return the declaration of the unchecked entry point of FD, which gets the
+  /// body of FD once its definition is known.
+  FunctionDecl *getContractUncheckedDecl(const FunctionDecl *FD);
+
+  /// Return the address of the unchecked entry point of FD.  It is emitted
+  /// along with FD if FD is defined in this translation unit.
+  llvm::Constant *GetAddrOfContractUnchecked(const FunctionDecl *FD,
+                                             llvm::Type *Ty = nullptr);
 
   bool shouldUseTBAA() const { return TBAA != nullptr; }
 
@@ -1295,6 +1389,19 @@ private:
   /// Emit required definitions for C++ D0542R2 support, e.g. __contract_violation_tab
   void EmitCXXContractDependencies();
 
+  /// Emit in __builtin_violation_handler() the call to the handler given by
+  /// -contract-violation-handler= for the violation described by Entry, whose
+  /// strings are at the given offsets of StrTab.
+  void EmitUserViolationHandlerCall(CGBuilderTy &Builder, llvm::Value *Entry,
+                                    llvm::StructType *EntryTy,
+                                    llvm::Value *StrTab);
+
+  /// -fcontract-violation-site-ids: emit the entries and their strings to the
+  /// non-loaded .llvm_contract_info section.
+  void EmitContractViolationInfo(llvm::StructType *EntryTy,
+                                 ArrayRef<llvm::Constant *> Entries,
+                                 llvm::Constant *StrTabInit);
+
   /// Try to emit external vtables as available_externally if they have emitted
   /// all inlined virtual functions.  It runs after EmitDeferred() and therefore
   /// is not allowed to create new references to things that need to be emitted
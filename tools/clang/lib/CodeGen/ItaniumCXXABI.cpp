@@ -310,6 +310,13 @@ public:
       Thunk->setDLLStorageClass(llvm::GlobalValue::DLLExportStorageClass);
   }
 
+  bool canCheckContractsInVTableThunks() const override {
+    // A vtable slot of which the function has preconditions points to a
+    // thunk that checks them, mangled as a thunk with no adjustment
+    // (_ZTh0_...) if the slot does not need one otherwise.
+    return true;
+  }
+
   llvm::Value *performThisAdjustment(CodeGenFunction &CGF, Address This,
                                      const ThisAdjustment &TA) override;
 
@@ -1684,7 +1691,7 @@ CGCallee ItaniumCXXABI::getVirtualFunctionPointer(CodeGenFunction &CGF,
     VFunc = VFuncLoad;
   }
 
-  CGCallee Callee(MethodDecl, VFunc);
+  CGCallee Callee = CGCallee::forVirtual(MethodDecl, VFunc);
   return Callee;
 }
 
@@ -568,7 +568,17 @@ void ToolChain::addClangWarningOptions(ArgStringList &CC1Args) const {}
 
 void ToolChain::addProfileRTLibs(const llvm::opt::ArgList &Args,
                                  llvm::opt::ArgStringList &CmdArgs) const {
-  if (!needsProfileRT(Args)) return;
+  // The contract violation logging runtime starts a flusher thread.
+  if (Args.hasArg(options::OPT_fcontract_violation_log) ||
+      Args.hasArg(options::OPT_fcontract_violation_site_ids) ||
+      Args.getLastArgValue(options::OPT_contract_violation_mode_EQ) == "trap") {
+    CmdArgs.push_back(getCompilerRTArgString(Args, "contracts"));
+    if (!getTriple().isOSWindows())
+      CmdArgs.push_back("-lpthread");
+  }
+
+  if (!needsProfileRT(Args) && !Args.hasArg(options::OPT_fcontract_profile))
+    return;
 
   CmdArgs.push_back(getCompilerRTArgString(Args, "profile"));
 }
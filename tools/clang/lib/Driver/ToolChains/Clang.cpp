@@ -3643,6 +3643,44 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
     A->render(Args, CmdArgs);
   if (Arg *A = Args.getLastArg(options::OPT_fcontinue_after_violation))
     A->render(Args, CmdArgs);
+  if (Arg *A = Args.getLastArg(options::OPT_contract_check_site_EQ))
+    A->render(Args, CmdArgs);
+  if (Arg *A = Args.getLastArg(options::OPT_fcontract_profile))
+    A->render(Args, CmdArgs);
+  if (Arg *A = Args.getLastArg(options::OPT_contract_sampling_EQ))
+    A->render(Args, CmdArgs);
+  if (Arg *A = Args.getLastArg(options::OPT_fcontract_profile_use_EQ))
+    A->render(Args, CmdArgs);
+  if (Arg *A = Args.getLastArg(options::OPT_fcontract_profile_top_EQ))
+    A->render(Args, CmdArgs);
+  if (Arg *A = Args.getLastArg(options::OPT_fcontract_profile_budget_EQ))
+    A->render(Args, CmdArgs);
+  if (Arg *A = Args.getLastArg(options::OPT_fcontract_proven_EQ))
+    A->render(Args, CmdArgs);
+  if (Arg *A = Args.getLastArg(options::OPT_contract_assume_unchecked))
+    A->render(Args, CmdArgs);
+  if (Arg *A = Args.getLastArg(options::OPT_contract_trust_ensures))
+    A->render(Args, CmdArgs);
+  if (Arg *A = Args.getLastArg(options::OPT_fcontract_violation_log))
+    A->render(Args, CmdArgs);
+  if (Arg *A = Args.getLastArg(options::OPT_fcontract_violation_site_ids))
+    A->render(Args, CmdArgs);
+  if (Arg *A = Args.getLastArg(options::OPT_contract_violation_mode_EQ))
+    A->render(Args, CmdArgs);
+  if (Arg *A = Args.getLastArg(options::OPT_fcontract_export_unchecked))
+    A->render(Args, CmdArgs);
+  if (Arg *A = Args.getLastArg(options::OPT_fcontract_vtable_thunks))
+    A->render(Args, CmdArgs);
+  // The -fcontract-policy= files are also dependencies.
+  for (const Arg *A : Args.filtered(options::OPT_fcontract_policy_EQ)) {
+    A->claim();
+    if (!llvm::sys::fs::exists(A->getValue())) {
+      D.Diag(diag::err_drv_no_such_file) << A->getValue();
+      continue;
+    }
+    A->render(Args, CmdArgs);
+    CmdArgs.push_back(Args.MakeArgString(Twine("-fdepfile-entry=") + A->getValue()));
+  }
 
   // GCC's behavior for -Wwrite-strings is a bit strange:
   //  * In C, this "warning flag" changes the types of string literals from
@@ -988,7 +988,14 @@ StringRef Darwin::getOSLibraryNameSuffix() const {
 
 void Darwin::addProfileRTLibs(const ArgList &Args,
                               ArgStringList &CmdArgs) const {
-  if (!needsProfileRT(Args)) return;
+  if (Args.hasArg(options::OPT_fcontract_violation_log))
+    AddLinkRuntimeLib(
+        Args, CmdArgs,
+        (Twine("libclang_rt.contracts_") + getOSLibraryNameSuffix() + ".a").str(),
+        RLO_AlwaysLink);
+
+  if (!needsProfileRT(Args) && !Args.hasArg(options::OPT_fcontract_profile))
+    return;
 
   AddLinkRuntimeLib(
       Args, CmdArgs,
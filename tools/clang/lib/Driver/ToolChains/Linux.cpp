@@ -850,7 +850,12 @@ SanitizerMask Linux::getSupportedSanitizers() const {
 
 void Linux::addProfileRTLibs(const llvm::opt::ArgList &Args,
                              llvm::opt::ArgStringList &CmdArgs) const {
-  if (!needsProfileRT(Args)) return;
+  // The contract profiling runtime does not need the initialization module;
+  // it is pulled in by the references emitted by -fcontract-profile.
+  if (!needsProfileRT(Args)) {
+    ToolChain::addProfileRTLibs(Args, CmdArgs);
+    return;
+  }
 
   // Add linker option -u__llvm_runtime_variable to cause runtime
   // initialization module to be linked in.
@@ -488,6 +488,8 @@ void CompilerInstance::createASTContext() {
                                  PP.getIdentifierTable(), PP.getSelectorTable(),
                                  PP.getBuiltinInfo());
   Context->InitBuiltinTypes(getTarget(), getAuxTarget());
+  if (getFrontendOpts().ShowTimers)
+    Context->enableContractTimers();
   setASTContext(Context);
 }
 
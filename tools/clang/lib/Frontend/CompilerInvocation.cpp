@@ -1952,6 +1952,80 @@ static void ParseLangArgs(LangOptions &Opts, ArgList &Args, InputKind IK,
       Opts.ContractViolationHandler = A->getValue();
   // Handle -fcontinue-after-violation option.
   Opts.EnableContinueAfterViolation = Args.hasArg(OPT_fcontinue_after_violation);
+  // Handle -contract-check-site= option.
+  if (Arg *A = Args.getLastArg(OPT_contract_check_site_EQ)) {
+    unsigned Val = llvm::StringSwitch<unsigned>(A->getValue())
+      .Case("callee", 0).Case("caller", 1)
+      .Default(~0U);
+    if (Val == ~0U)
+      Diags.Report(diag::err_drv_invalid_value) << A->getAsString(Args) << A->getValue();
+    else
+      Opts.ContractCheckSite = Val;
+  }
+  // Handle -fcontract-profile option.
+  Opts.ContractProfile = Args.hasArg(OPT_fcontract_profile);
+  // Handle -contract-sampling= option.
+  Opts.ContractSampling = getLastArgIntValue(Args, OPT_contract_sampling_EQ, 0, Diags);
+  // Handle -fcontract-profile-use=, -fcontract-profile-top= and
+  // -fcontract-profile-budget= options.
+  Opts.ContractProfileUsePath = Args.getLastArgValue(OPT_fcontract_profile_use_EQ);
+  Opts.ContractProfileTopN = getLastArgIntValue(Args, OPT_fcontract_profile_top_EQ, 0, Diags);
+  if (Arg *A = Args.getLastArg(OPT_fcontract_profile_budget_EQ)) {
+    unsigned Val;
+    if (StringRef(A->getValue()).getAsInteger(10, Val) || Val > 100)
+      Diags.Report(diag::err_drv_invalid_value) << A->getAsString(Args) << A->getValue();
+    else
+      Opts.ContractProfileBudget = Val;
+  }
+  // Handle -contract-assume-unchecked option.
+  Opts.ContractAssumeUnchecked = Args.hasArg(OPT_contract_assume_unchecked);
+  // Handle -contract-trust-ensures option.
+  Opts.ContractTrustEnsures = Args.hasArg(OPT_contract_trust_ensures);
+  // Handle -fcontract-proven= option.
+  Opts.ContractProvenPath = Args.getLastArgValue(OPT_fcontract_proven_EQ);
+  // Handle -fcontract-violation-log option.
+  Opts.ContractViolationLog = Args.hasArg(OPT_fcontract_violation_log);
+  // Handle -fcontract-violation-site-ids option; the site ids are looked up
+  // in ELF sections, and replace the table that -fcontract-profile and
+  // -fcontract-violation-log register with their runtimes.
+  if (Arg *A = Args.getLastArg(OPT_fcontract_violation_site_ids)) {
+    Opts.ContractViolationSiteIds = true;
+    if (!llvm::Triple(TargetOpts.Triple).isOSBinFormatELF())
+      Diags.Report(diag::err_drv_unsupported_opt_for_target)
+        << A->getAsString(Args) << TargetOpts.Triple;
+    if (Arg *Other = Args.getLastArg(OPT_fcontract_profile, OPT_fcontract_violation_log))
+      Diags.Report(diag::err_drv_argument_not_allowed_with)
+        << A->getAsString(Args) << Other->getAsString(Args);
+  }
+  // Handle -contract-violation-mode= option; the traps are described by site
+  // ids, and looked up by a SIGILL handler of the contracts runtime.
+  if (Arg *A = Args.getLastArg(OPT_contract_violation_mode_EQ)) {
+    unsigned Val = llvm::StringSwitch<unsigned>(A->getValue())
+      .Case("call", 0).Case("trap", 1)
+      .Default(~0U);
+    if (Val == ~0U)
+      Diags.Report(diag::err_drv_invalid_value) << A->getAsString(Args) << A->getValue();
+    else
+      Opts.ContractViolationMode = Val;
+    llvm::Triple T(TargetOpts.Triple);
+    if (Val == 1 && !(T.isOSLinux() &&
+                     (T.getArch() == llvm::Triple::x86 ||
+                      T.getArch() == llvm::Triple::x86_64)))
+      Diags.Report(diag::err_drv_unsupported_opt_for_target)
+        << A->getAsString(Args) << TargetOpts.Triple;
+    else if (Val == 1) {
+      Opts.ContractViolationSiteIds = true;
+      if (Arg *Other = Args.getLastArg(OPT_fcontract_profile, OPT_fcontract_violation_log))
+        Diags.Report(diag::err_drv_argument_not_allowed_with)
+          << A->getAsString(Args) << Other->getAsString(Args);
+    }
+  }
+  // Handle -fcontract-policy= option.
+  Opts.ContractPolicyFiles = Args.getAllArgValues(OPT_fcontract_policy_EQ);
+  // Handle -fcontract-export-unchecked option.
+  Opts.ContractExportUnchecked = Args.hasArg(OPT_fcontract_export_unchecked);
+  // Handle -fcontract-vtable-thunks option.
+  Opts.ContractVTableThunks = Args.hasArg(OPT_fcontract_vtable_thunks);
 
   // -cl-std only applies for OpenCL language standards.
   // Override the -std option in this case.
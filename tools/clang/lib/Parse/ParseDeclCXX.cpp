@@ -26,9 +26,14 @@
 #include "clang/Sema/Scope.h"
 #include "clang/Sema/SemaDiagnostic.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/Statistic.h"
 
 using namespace clang;
 
+#define DEBUG_TYPE "contracts"
+
+STATISTIC(NumContractAttrsParsed, "The # of contract attributes parsed");
+
 /// ParseNamespace - We know that the current token is a namespace keyword. This
 /// may either be a top level namespace or a block-level namespace alias. If
 /// there was an inline keyword, it has already been parsed.
@@ -3846,6 +3851,8 @@ VarDecl *Parser::CXXContracts_GetInternalReturnVarDecl(bool Make) {
 unsigned Parser::ParseContractAttrArgs(IdentifierInfo *AttrName,
                            SourceLocation AttrNameLoc,
                            ParsedAttributes &Attrs, SourceLocation *EndLoc) {
+  ContractTimeRegion Timer(Actions.getASTContext(), ASTContext::CTK_Parse);
+  ++NumContractAttrsParsed;
   AttributeList::Kind AttrKind =
      AttributeList::getKind(AttrName, nullptr, AttributeList::AS_CXX11);
   ArgsVector ArgExprs;
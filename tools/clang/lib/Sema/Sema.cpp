@@ -329,12 +329,16 @@ void Sema::Initialize() {
     PushOnScopeChains(Context.getBuiltinVaListDecl(), TUScope);
 
   // Declarations for C++ contract support (D0542R2)
-  if (getLangOpts().CPlusPlus
-      && IdResolver.begin(&Context.Idents.get("__builtin_contract_violation_t")) == IdResolver.end()) {
-    PushOnScopeChains(Context.getBuiltinContractViolationType()->getAs<TypedefType>()->getDecl(),
-                      TUScope);
+  if (getLangOpts().CPlusPlus) {
+    // The declarations below may have been loaded from an AST file, but the
+    // violation handler of the ASTContext is not; it is set up again.
+    if (IdResolver.begin(&Context.Idents.get("__builtin_contract_violation_t")) == IdResolver.end())
+      PushOnScopeChains(Context.getBuiltinContractViolationType()->getAs<TypedefType>()->getDecl(),
+                        TUScope);
 
-    if (getLangOpts().BuildLevel == 0 /*off*/)
+    // -fcontract-policy= may check the contracts of some functions
+    if (getLangOpts().BuildLevel == 0 /*off*/
+        && getLangOpts().ContractPolicyFiles.empty())
       return;
 
     // extern "C" {
@@ -356,19 +360,27 @@ void Sema::Initialize() {
     extern_C->addDecl(FD_terminate);
 
     Context.setViolationHandler(FD_terminate);
-    if (getLangOpts().ContractViolationHandler.empty())
+    if (getLangOpts().ContractViolationHandler.empty()
+        && !getLangOpts().ContractViolationLog)
       return;
 
     // -contract-violation-handler=
-    auto FD_vh = Context.getViolationHandlerDecl(&Context.Idents.get(
-                                                  getLangOpts().ContractViolationHandler));
-    FD_vh->setDeclContext(extern_C);
-    extern_C->addDecl(FD_vh);
+    if (!getLangOpts().ContractViolationHandler.empty()) {
+      auto FD_vh = Context.getViolationHandlerDecl(&Context.Idents.get(
+                                                    getLangOpts().ContractViolationHandler));
+      FD_vh->setDeclContext(extern_C);
+      extern_C->addDecl(FD_vh);
+    }
     // }
 
-    // required for -enable-continue-after-violation support
+    // required for -enable-continue-after-violation and -fcontract-violation-log
+    // support; takes the index of the violation in __contract_violation_tab[],
+    // or its site id with -fcontract-violation-site-ids
+    // (see CodeGenModule)
     auto FD_builtin_vh = Context.getViolationHandlerDecl(&Context.Idents.get(
-                                                          "__builtin_violation_handler"), SC_Static);
+                                                          "__builtin_violation_handler"), SC_Static,
+                                                         FunctionProtoType::ExtProtoInfo{},
+                                                         Context.UnsignedIntTy);
     FD_builtin_vh->setDeletedAsWritten();
     PushOnScopeChains(FD_builtin_vh, TUScope);
 
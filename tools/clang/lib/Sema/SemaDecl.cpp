@@ -2409,7 +2409,7 @@ namespace {
       llvm::DenseMap<DeclarationName, DeclarationName>::iterator Known
         = TransformedDN.find(NI.getName());
       if (Known != TransformedDN.end())
-        return DeclarationNameInfo(Known->second, SourceLocation());
+        return DeclarationNameInfo(Known->second, NI.getLoc());
 
       return NI;
     }
@@ -2418,6 +2418,9 @@ namespace {
                                   ValueDecl *VD,
                                   const DeclarationNameInfo &NameInfo,
                                   TemplateArgumentListInfo *TemplateArgs) {
+      // The condition keeps its source locations, which CodeGen uses to
+      // describe the contract; the parameters of D are used by it.
+      VD->markUsed(SemaRef.getASTContext());
       return ExprResult(DeclRefExpr::Create(SemaRef.getASTContext(),
                                    QualifierLoc, SourceLocation(), VD, false,
                                    NameInfo, VD->getType(), VK_LValue, nullptr,
@@ -2533,7 +2536,8 @@ static bool mergeDeclAttribute(Sema &S, NamedDecl *D, Decl *Old,
       NewAttr = new (S.Context) ExpectsAttr(A->getLocation(), S.Context, A->getLevel(),
                   MergeContractAttrTransform(S, cast<FunctionDecl>(Old),
                                cast<FunctionDecl>(D)).TransformExpr(A->getCond()).get(),
-                  A->getArgDependent(), A->getParent(), A->getSpellingListIndex());
+                  A->getArgDependent(), A->getParent(), A->getTriviallyTrue(),
+                  A->getPending(), A->getSpellingListIndex());
     } else {
       NewAttr = cast<InheritableAttr>(Attr->clone(S.Context));
     }
@@ -2541,7 +2545,9 @@ static bool mergeDeclAttribute(Sema &S, NamedDecl *D, Decl *Old,
       NewAttr = new (S.Context) EnsuresAttr(A->getLocation(), S.Context, A->getLevel(),
                   MergeContractAttrTransform(S, cast<FunctionDecl>(Old),
                                cast<FunctionDecl>(D)).TransformExpr(A->getCond()).get(),
-                  A->getRet(), A->getArgDependent(), A->getParent(), A->getSpellingListIndex());
+                  A->getRet(), A->getArgDependent(), A->getParent(),
+                  A->getTriviallyTrue(), A->getPending(),
+                  A->getSpellingListIndex());
   } else if (Attr->duplicatesAllowed() || !DeclHasAttr(D, Attr))
     NewAttr = cast<InheritableAttr>(Attr->clone(S.Context));
 
@@ -12413,6 +12419,9 @@ void Sema::adjustDeducedFunctionResultType(FunctionDecl *FD, QualType ResultType
     ________ret________->setType(ResultType);
 
     for (auto Attr : FD->specific_attrs<EnsuresAttr>()) {
+      // Pending conditions are instantiated with the deduced type.
+      if (Attr->getPending())
+        continue;
       ExprResult ER;
       if ((ER = RebuildExpr(Attr->getCond())).isInvalid())
         continue;
@@ -1018,6 +1018,23 @@ public:
 };
 }
 
+/// CXXContracts_IsTriviallyTrue - Folds the condition of a contract that
+/// doesn't depend on template parameters or function arguments.  Returns true
+/// if it always holds, in which case no check is emitted; a condition that
+/// never holds is diagnosed.
+bool Sema::CXXContracts_IsTriviallyTrue(Expr *Cond, ContractKind Kind,
+                                        SourceLocation Loc) {
+  bool Result;
+  if (Cond->isInstantiationDependent() ||
+      !Cond->EvaluateAsBooleanCondition(Result, Context) ||
+      Cond->HasSideEffects(Context))
+    return false;
+  if (!Result)
+    Diag(Loc, diag::warn_contract_always_false)
+        << Kind << Cond->getSourceRange();
+  return Result;
+}
+
 static void handle_Expects_Ensures_Attr(Sema &S, Decl *D, const AttributeList &Attr) {
   IdentifierInfo *Level = Attr.getArgAsIdent(0)->Ident;
   Expr *Cond = Attr.getArgAsExpr(1);
@@ -1041,13 +1058,18 @@ static void handle_Expects_Ensures_Attr(Sema &S, Decl *D, const AttributeList &A
     ArgDependent = ArgumentDependenceChecker(FD).referencesArgs(Cond);
 
   if (Attr.getKind() == AttributeList::AT_Expects) {
+    bool TriviallyTrue = S.CXXContracts_IsTriviallyTrue(Cond, Sema::CON_Expects,
+                                                        Attr.getLoc());
     D->addAttr(::new (S.Context) ExpectsAttr(
         Attr.getRange(), S.Context, Level, Cond, ArgDependent, cast<NamedDecl>(D),
-        Attr.getAttributeSpellingListIndex()));
+        TriviallyTrue, /*Pending=*/false, Attr.getAttributeSpellingListIndex()));
   } else {
+    bool TriviallyTrue = S.CXXContracts_IsTriviallyTrue(Cond, Sema::CON_Ensures,
+                                                        Attr.getLoc());
     D->addAttr(::new (S.Context) EnsuresAttr(
         Attr.getRange(), S.Context, Level, Cond, Attr.getArgAsIdent(2)->Ident,
-        ArgDependent, cast<NamedDecl>(D), Attr.getAttributeSpellingListIndex()));
+        ArgDependent, cast<NamedDecl>(D), TriviallyTrue, /*Pending=*/false,
+        Attr.getAttributeSpellingListIndex()));
   }
 }
 
@@ -6146,6 +6168,9 @@ static void ProcessDeclAttribute(Sema &S, Scope *scope, Decl *D,
   case AttributeList::AT_Ensures:
     handle_Expects_Ensures_Attr(S, D, Attr);
     break;
+  case AttributeList::AT_ContractTrusted:
+    handleSimpleAttribute<ContractTrustedAttr>(S, D, Attr);
+    break;
   case AttributeList::AT_DiagnoseIf:
     handleDiagnoseIfAttr(S, D, Attr);
     break;
@@ -68,8 +68,10 @@ static Attr *handleAssertAttr(Sema &S, Stmt *St, const AttributeList &A,
     E = Converted.get();
   }
 
+  bool TriviallyTrue =
+      S.CXXContracts_IsTriviallyTrue(E, Sema::CON_Assert, A.getLoc());
   AssertAttr Attr(A.getRange(), S.Context, A.getArgAsIdent(0)->Ident, E,
-                       A.getAttributeSpellingListIndex());
+                  TriviallyTrue, A.getAttributeSpellingListIndex());
   if (!isa<NullStmt>(St)) {
     S.Diag(A.getRange().getBegin(), diag::err_fallthrough_attr_wrong_target)
         << Attr.getSpelling() << St->getLocStart();
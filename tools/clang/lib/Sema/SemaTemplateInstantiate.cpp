@@ -1236,9 +1236,13 @@ TemplateInstantiator::TransformAssertAttr(const AssertAttr *A) {
   if (TransformedExpr == A->getCond())
     return A;
 
-  return AssertAttr::CreateImplicit(
-      getSema().Context, A->getLevel(),
-      getSema().PerformContextuallyConvertToBool(TransformedExpr).get(), A->getRange());
+  Expr *Cond = getSema().PerformContextuallyConvertToBool(TransformedExpr).get();
+  bool TriviallyTrue = A->getTriviallyTrue();
+  if (Cond && A->getCond()->isInstantiationDependent())
+    TriviallyTrue = getSema().CXXContracts_IsTriviallyTrue(
+        Cond, Sema::CON_Assert, A->getLocation());
+  return AssertAttr::CreateImplicit(getSema().Context, A->getLevel(), Cond,
+                                    TriviallyTrue, A->getRange());
 }
 
 ExprResult TemplateInstantiator::transformNonTypeTemplateParmRef(
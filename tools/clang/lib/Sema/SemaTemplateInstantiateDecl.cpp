@@ -24,9 +24,15 @@
 #include "clang/Sema/Lookup.h"
 #include "clang/Sema/PrettyDeclStackTrace.h"
 #include "clang/Sema/Template.h"
+#include "llvm/ADT/Statistic.h"
 
 using namespace clang;
 
+#define DEBUG_TYPE "contracts"
+
+STATISTIC(NumContractConditionsInstantiated,
+          "The # of contract conditions instantiated");
+
 static bool isDeclWithinFunction(const Decl *D) {
   const DeclContext *DC = D->getDeclContext();
   if (DC->isFunctionOrMethod())
@@ -208,6 +214,37 @@ static Expr *__instantiateDependentFunctionAttrCondition(
   return Cond;
 }
 
+/// Determine whether the instantiation of the condition of \p A, a contract
+/// of the pattern of \p New, is deferred until it is needed.  As for exception
+/// specifications, the conditions of dependent declarations stay pending, so
+/// that they are instantiated from the original pattern.  Members of local
+/// classes are instantiated along with the enclosing function, whose
+/// instantiation scope they may need.
+template <typename AttrT>
+static bool isContractInstantiationDeferred(const AttrT *A,
+                                            const FunctionDecl *New) {
+  return A->getPending() || !New->getParentFunctionOrMethod();
+}
+
+/// The declaration whose parameters the condition of \p A refers to: the
+/// pattern \p Tmpl, or the original pattern of a pending condition.
+template <typename AttrT>
+static NamedDecl *getContractPattern(const AttrT *A, const Decl *Tmpl) {
+  if (A->getPending())
+    return A->getParent();
+  return cast<NamedDecl>(const_cast<Decl *>(Tmpl));
+}
+
+/// Instantiate the condition of \p A, a contract of \p Tmpl, for \p New.
+static Expr *instantiateContractAttrCondition(
+    Sema &S, const MultiLevelTemplateArgumentList &TemplateArgs,
+    const Attr *A, Expr *OldCond, const Decl *Tmpl, FunctionDecl *New) {
+  ContractTimeRegion Timer(S.getASTContext(), ASTContext::CTK_Instantiate);
+  ++NumContractConditionsInstantiated;
+  return __instantiateDependentFunctionAttrCondition(S, TemplateArgs, A,
+      OldCond, Tmpl, New, Sema::ExpressionEvaluationContext::PotentiallyEvaluated);
+}
+
 static Expr *instantiateDependentFunctionAttrCondition(
     Sema &S, const MultiLevelTemplateArgumentList &TemplateArgs,
     const Attr *A, Expr *OldCond, const Decl *Tmpl, FunctionDecl *New,
@@ -431,22 +468,46 @@ void Sema::InstantiateAttrs(const MultiLevelTemplateArgumentList &TemplateArgs,
     // idea.  All these attributes are candidates to be ported in the future.
     //
     // In the interim, [[expects]] and [[ensures]] condictions are instantiated here.
+    //
+    // The conditions of a specialization are only instantiated when they are
+    // needed (see InstantiateContractConditions()); until then, the attribute
+    // keeps the condition of the pattern, and the pattern as its parent.
     if (const auto *A = dyn_cast<ExpectsAttr>(TmplAttr)) {
-      if (Expr *E = __instantiateDependentFunctionAttrCondition(*this,
-             TemplateArgs, A, A->getCond(), Tmpl, cast<FunctionDecl>(New),
-             Sema::ExpressionEvaluationContext::PotentiallyEvaluated))
+      if (isContractInstantiationDeferred(A, cast<FunctionDecl>(New))) {
+        New->addAttr(new (Context) ExpectsAttr(A->getLocation(), Context,
+                                    A->getLevel(), A->getCond(), A->getArgDependent(),
+                                    getContractPattern(A, Tmpl), A->getTriviallyTrue(),
+                                    /*Pending=*/true, A->getSpellingListIndex()));
+      } else if (Expr *E = instantiateContractAttrCondition(*this,
+             TemplateArgs, A, A->getCond(), Tmpl, cast<FunctionDecl>(New))) {
+        // Non-dependent conditions were already folded in the template.
+        bool TriviallyTrue = A->getCond()->isInstantiationDependent()
+            ? CXXContracts_IsTriviallyTrue(E, CON_Expects, A->getLocation())
+            : A->getTriviallyTrue();
         New->addAttr(new (Context) ExpectsAttr(A->getLocation(), Context,
                                     A->getLevel(), E, A->getArgDependent(),
-                                    A->getParent(), A->getSpellingListIndex()));
+                                    A->getParent(), TriviallyTrue, /*Pending=*/false,
+                                    A->getSpellingListIndex()));
+      }
       continue;
     }
     if (const auto *A = dyn_cast<EnsuresAttr>(TmplAttr)) {
-      if (Expr *E = __instantiateDependentFunctionAttrCondition(*this,
-             TemplateArgs, A, A->getCond(), Tmpl, cast<FunctionDecl>(New),
-             Sema::ExpressionEvaluationContext::PotentiallyEvaluated))
+      if (isContractInstantiationDeferred(A, cast<FunctionDecl>(New))) {
+        New->addAttr(new (Context) EnsuresAttr(A->getLocation(), Context,
+                                    A->getLevel(), A->getCond(), A->getRet(),
+                                    A->getArgDependent(), getContractPattern(A, Tmpl),
+                                    A->getTriviallyTrue(), /*Pending=*/true,
+                                    A->getSpellingListIndex()));
+      } else if (Expr *E = instantiateContractAttrCondition(*this,
+             TemplateArgs, A, A->getCond(), Tmpl, cast<FunctionDecl>(New))) {
+        bool TriviallyTrue = A->getCond()->isInstantiationDependent()
+            ? CXXContracts_IsTriviallyTrue(E, CON_Ensures, A->getLocation())
+            : A->getTriviallyTrue();
         New->addAttr(new (Context) EnsuresAttr(A->getLocation(), Context,
                                     A->getLevel(), E, A->getRet(), A->getArgDependent(),
-                                    A->getParent(), A->getSpellingListIndex()));
+                                    A->getParent(), TriviallyTrue, /*Pending=*/false,
+                                    A->getSpellingListIndex()));
+      }
       continue;
     }
 
@@ -3654,6 +3715,83 @@ void Sema::InstantiateExceptionSpec(SourceLocation PointOfInstantiation,
                      TemplateArgs);
 }
 
+template <typename AttrT>
+static void instantiateContractCondition(Sema &S,
+    const MultiLevelTemplateArgumentList &TemplateArgs, AttrT *A,
+    FunctionDecl *Decl, Sema::ContractKind Kind) {
+  Expr *E = instantiateContractAttrCondition(S, TemplateArgs, A, A->getCond(),
+                                             A->getParent(), Decl);
+  A->setPending(false);
+  if (!E) {
+    // The condition was diagnosed; the contract is dropped.
+    A->setTriviallyTrue(true);
+    return;
+  }
+  // Non-dependent conditions were already folded in the template.
+  if (A->getCond()->isInstantiationDependent())
+    A->setTriviallyTrue(S.CXXContracts_IsTriviallyTrue(E, Kind,
+                                                       A->getLocation()));
+  A->setCond(E);
+}
+
+void Sema::InstantiateContractConditions(SourceLocation PointOfInstantiation,
+                                         FunctionDecl *Decl) {
+  if (!Decl->hasAttrs() || Decl->isDependentContext())
+    return;
+
+  // Contracts that are neither checked nor assumed at the build level are
+  // never instantiated.
+  // All the contracts of Decl were instantiated from the same pattern.
+  FunctionDecl *Template = nullptr;
+  SmallVector<Attr *, 4> Pending;
+  for (Attr *A : Decl->attrs()) {
+    if (auto *EA = dyn_cast<ExpectsAttr>(A)) {
+      if (EA->getPending() &&
+          getLangOpts().isContractConditionUsed(EA->getLevel()->getName(),
+                                                /*Ensures=*/false)) {
+        Template = cast<FunctionDecl>(EA->getParent());
+        Pending.push_back(A);
+      }
+    } else if (auto *EA = dyn_cast<EnsuresAttr>(A)) {
+      if (EA->getPending() &&
+          getLangOpts().isContractConditionUsed(EA->getLevel()->getName(),
+                                                /*Ensures=*/true)) {
+        Template = cast<FunctionDecl>(EA->getParent());
+        Pending.push_back(A);
+      }
+    }
+  }
+  if (Pending.empty())
+    return;
+
+  InstantiatingTemplate Inst(*this, PointOfInstantiation, Decl);
+  if (Inst.isInvalid() || Inst.isAlreadyInstantiating())
+    return;
+
+  // Enter the scope of this instantiation. We don't use
+  // PushDeclContext because we don't have a scope.
+  Sema::ContextRAII savedContext(*this, Decl);
+  LocalInstantiationScope Scope(*this);
+
+  MultiLevelTemplateArgumentList TemplateArgs =
+    getTemplateInstantiationArgs(Decl, nullptr, /*RelativeToPrimary*/true);
+
+  if (addInstantiatedParametersToScope(*this, Decl, Template, Scope,
+                                       TemplateArgs))
+    return;
+  if (VarDecl *Tmpl________ret________ = Template->GetInternalReturnVarDecl())
+    if (VarDecl *________ret________ = Decl->GetInternalReturnVarDecl())
+      Scope.InstantiatedLocal(Tmpl________ret________, ________ret________);
+
+  for (Attr *A : Pending) {
+    if (auto *EA = dyn_cast<ExpectsAttr>(A))
+      instantiateContractCondition(*this, TemplateArgs, EA, Decl, CON_Expects);
+    else
+      instantiateContractCondition(*this, TemplateArgs, cast<EnsuresAttr>(A),
+                                   Decl, CON_Ensures);
+  }
+}
+
 /// \brief Initializes the common fields of an instantiation function
 /// declaration (New) from the corresponding fields of its template (Tmpl).
 ///
@@ -3923,6 +4061,9 @@ void Sema::InstantiateFunctionDefinition(SourceLocation PointOfInstantiation,
     }
   }
 
+  // The definition checks the contracts of the function.
+  InstantiateContractConditions(PointOfInstantiation, Function);
+
   InstantiatingTemplate Inst(*this, PointOfInstantiation, Function);
   if (Inst.isInvalid() || Inst.isAlreadyInstantiating())
     return;
@@ -6998,6 +6998,21 @@ CXXBaseSpecifier *ASTReader::GetExternalCXXBaseSpecifiers(uint64_t Offset) {
   return Bases;
 }
 
+Expr *ASTReader::ReadContractCondition(ModuleFile &F, uint64_t Offset) {
+  BitstreamCursor &Cursor = F.DeclsCursor;
+  SavedStreamPosition SavedPosition(Cursor);
+  Cursor.JumpToBit(Offset);
+  RecordData Record;
+  unsigned Code = Cursor.ReadCode();
+  unsigned RecCode = Cursor.readRecord(Code, Record);
+  if (RecCode != DECL_CONTRACT_CONDITION) {
+    Error("malformed AST file: missing contract condition");
+    return nullptr;
+  }
+
+  return cast_or_null<Expr>(ReadStmtFromStream(F));
+}
+
 serialization::DeclID
 ASTReader::getGlobalDeclID(ModuleFile &F, LocalDeclID LocalID) const {
   if (LocalID < NUM_PREDEF_DECL_IDS)
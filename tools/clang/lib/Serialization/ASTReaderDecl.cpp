@@ -2580,6 +2580,45 @@ void ASTDeclReader::VisitOMPCapturedExprDecl(OMPCapturedExprDecl *D) {
 //===----------------------------------------------------------------------===//
 
 /// \brief Reads attributes from the current stream position.
+/// Reads an [[expects]] or [[ensures]] attribute (see
+/// ASTRecordWriter::AddAttributes()).  Conditions that are neither checked
+/// nor assumed in this translation are not read; the attribute is left
+/// pending with a null condition.
+static Attr *readContractAttr(ASTRecordReader &Record, attr::Kind Kind,
+                              SourceRange Range) {
+  ASTContext &Context = Record.getContext();
+  bool IsInherited = Record.readInt();
+  bool IsImplicit = Record.readInt();
+  unsigned Spelling = Record.readInt();
+  IdentifierInfo *Level = Record.getIdentifierInfo();
+  uint64_t CondOffset = Record.readInt();
+  IdentifierInfo *Ret =
+      Kind == attr::Ensures ? Record.getIdentifierInfo() : nullptr;
+  bool ArgDependent = Record.readInt();
+  NamedDecl *Parent = Record.GetLocalDeclAs<NamedDecl>(Record.readInt());
+  bool TriviallyTrue = Record.readInt();
+  bool Pending = Record.readInt();
+
+  Expr *Cond = nullptr;
+  if (Context.getLangOpts().isContractConditionUsed(Level->getName(),
+                                                    Kind == attr::Ensures))
+    Cond = Record.readContractCondition(CondOffset);
+  else
+    Pending = true;
+
+  InheritableAttr *New;
+  if (Kind == attr::Expects)
+    New = new (Context) ExpectsAttr(Range, Context, Level, Cond, ArgDependent,
+                                    Parent, TriviallyTrue, Pending, Spelling);
+  else
+    New = new (Context) EnsuresAttr(Range, Context, Level, Cond, Ret,
+                                    ArgDependent, Parent, TriviallyTrue,
+                                    Pending, Spelling);
+  New->setInherited(IsInherited);
+  New->setImplicit(IsImplicit);
+  return New;
+}
+
 void ASTReader::ReadAttributes(ASTRecordReader &Record, AttrVec &Attrs) {
   for (unsigned i = 0, e = Record.readInt(); i != e; ++i) {
     Attr *New = nullptr;
@@ -2587,6 +2626,11 @@ void ASTReader::ReadAttributes(ASTRecordReader &Record, AttrVec &Attrs) {
     SourceRange Range = Record.readSourceRange();
     ASTContext &Context = getContext();
 
+    if (Kind == attr::Expects || Kind == attr::Ensures) {
+      Attrs.push_back(readContractAttr(Record, Kind, Range));
+      continue;
+    }
+
 #include "clang/Serialization/AttrPCHRead.inc"
 
     assert(New && "Unable to decode attribute?");
@@ -3641,6 +3685,9 @@ Decl *ASTReader::ReadDeclRecord(DeclID ID) {
   case DECL_CXX_CTOR_INITIALIZERS:
     Error("attempt to read a C++ ctor initializer record as a declaration");
     return nullptr;
+  case DECL_CONTRACT_CONDITION:
+    Error("attempt to read a contract condition record as a declaration");
+    return nullptr;
   case DECL_IMPORT:
     // Note: last entry of the ImportDecl record is the number of stored source 
     // locations.
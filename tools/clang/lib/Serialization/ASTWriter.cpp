@@ -1268,6 +1268,7 @@ void ASTWriter::WriteBlockInfoBlock() {
   RECORD(DECL_PRAGMA_COMMENT);
   RECORD(DECL_PRAGMA_DETECT_MISMATCH);
   RECORD(DECL_OMP_DECLARE_REDUCTION);
+  RECORD(DECL_CONTRACT_CONDITION);
   
   // Statements and Exprs can occur in the Decls and Types block.
   AddStmtsExprs(Stream, Record);
@@ -4380,6 +4381,35 @@ void ASTRecordWriter::AddAttributes(ArrayRef<const Attr *> Attrs) {
     Record.push_back(A->getKind()); // FIXME: stable encoding, target attrs
     Record.AddSourceRange(A->getRange());
 
+    // The conditions of contracts are written out of line, so that readers
+    // that neither check nor assume them don't deserialize them (see
+    // readContractAttr() in ASTReaderDecl.cpp).
+    if (const auto *EA = dyn_cast<ExpectsAttr>(A)) {
+      Record.push_back(EA->isInherited());
+      Record.push_back(EA->isImplicit());
+      Record.push_back(EA->getSpellingListIndex());
+      Record.AddIdentifierRef(EA->getLevel());
+      Record.AddContractCondition(EA->getCond());
+      Record.push_back(EA->getArgDependent());
+      Record.AddDeclRef(EA->getParent());
+      Record.push_back(EA->getTriviallyTrue());
+      Record.push_back(EA->getPending());
+      continue;
+    }
+    if (const auto *EA = dyn_cast<EnsuresAttr>(A)) {
+      Record.push_back(EA->isInherited());
+      Record.push_back(EA->isImplicit());
+      Record.push_back(EA->getSpellingListIndex());
+      Record.AddIdentifierRef(EA->getLevel());
+      Record.AddContractCondition(EA->getCond());
+      Record.AddIdentifierRef(EA->getRet());
+      Record.push_back(EA->getArgDependent());
+      Record.AddDeclRef(EA->getParent());
+      Record.push_back(EA->getTriviallyTrue());
+      Record.push_back(EA->getPending());
+      continue;
+    }
+
 #include "clang/Serialization/AttrPCHWrite.inc"
 
   }
@@ -5893,6 +5923,15 @@ void ASTRecordWriter::AddCXXCtorInitializers(
   AddOffset(EmitCXXCtorInitializers(*Writer, CtorInits));
 }
 
+void ASTRecordWriter::AddContractCondition(Expr *Cond) {
+  ASTWriter::RecordData Record;
+  ASTRecordWriter W(*Writer, Record);
+  W.AddStmt(Cond);
+  // ASTReader::ReadAttributes() doesn't know the offset of the record being
+  // read, so the offset is absolute.
+  push_back(W.Emit(serialization::DECL_CONTRACT_CONDITION));
+}
+
 void ASTRecordWriter::AddCXXDefinitionData(const CXXRecordDecl *D) {
   auto &Data = D->data();
   Record->push_back(Data.IsLambda);
@@ -0,0 +1,299 @@
+//===- ProvenContractsChecker.cpp - Preconditions proven at call sites ----===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This defines ProvenContractsChecker, which evaluates the [[expects]] of the
+// callee at each call and records those that hold on every path in a file
+// (see clang/Analysis/ProvenContracts.h), so that -fcontract-proven= can omit
+// their checks at -contract-check-site=caller.
+//
+// A precondition is only recorded as proven when proven in the analysis of
+// the function that contains the call, i.e. for any input, and never found
+// to fail when the function is inlined elsewhere. Analyses that do not
+// explore all the paths (e.g. because of -analyzer-max-loop) prove nothing.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ClangSACheckers.h"
+#include "clang/AST/Attr.h"
+#include "clang/AST/Mangle.h"
+#include "clang/Analysis/ProvenContracts.h"
+#include "clang/StaticAnalyzer/Core/BugReporter/BugReporter.h"
+#include "clang/StaticAnalyzer/Core/Checker.h"
+#include "clang/StaticAnalyzer/Core/CheckerManager.h"
+#include "clang/StaticAnalyzer/Core/PathSensitive/AnalysisManager.h"
+#include "clang/StaticAnalyzer/Core/PathSensitive/CallEvent.h"
+#include "clang/StaticAnalyzer/Core/PathSensitive/CheckerContext.h"
+#include "clang/StaticAnalyzer/Core/PathSensitive/ExprEngine.h"
+#include "llvm/Support/FileSystem.h"
+#include <set>
+
+using namespace clang;
+using namespace ento;
+
+namespace {
+class ProvenContractsChecker
+    : public Checker<check::PreCall, check::EndAnalysis,
+                     check::EndOfTranslationUnit> {
+  typedef ProvenContracts::KeyTy KeyTy;
+
+  /// Preconditions at call sites proven in the function being analyzed, and
+  /// found to fail, in the current analysis.
+  mutable std::set<KeyTy> ProvenInTopFrame, Unproven;
+  /// The same, over all the complete analyses.
+  mutable std::set<KeyTy> AllProven, AllUnproven;
+  /// Names the functions of the records.
+  mutable std::unique_ptr<MangleContext> Mangler;
+
+  SVal evalRValue(const Expr *E, const CallEvent &Call,
+                  CheckerContext &C) const;
+  SVal evalLValue(const Expr *E, const CallEvent &Call,
+                  CheckerContext &C) const;
+  bool isProven(const Expr *Cond, const CallEvent &Call,
+                CheckerContext &C) const;
+
+public:
+  void checkPreCall(const CallEvent &Call, CheckerContext &C) const;
+  void checkEndAnalysis(ExplodedGraph &G, BugReporter &BR,
+                        ExprEngine &Eng) const;
+  void checkEndOfTranslationUnit(const TranslationUnitDecl *TU,
+                                 AnalysisManager &Mgr, BugReporter &BR) const;
+};
+} // end anonymous namespace
+
+/// Returns the parameter of the callee that E names, if Call binds it to an
+/// argument.
+static const ParmVarDecl *getParam(const Expr *E, const CallEvent &Call) {
+  const auto *DRE = dyn_cast<DeclRefExpr>(E->IgnoreParens());
+  const auto *PVD = DRE ? dyn_cast<ParmVarDecl>(DRE->getDecl()) : nullptr;
+  if (!PVD || PVD->getFunctionScopeIndex() >= Call.getNumArgs())
+    return nullptr;
+  return PVD;
+}
+
+SVal ProvenContractsChecker::evalLValue(const Expr *E, const CallEvent &Call,
+                                        CheckerContext &C) const {
+  E = E->IgnoreParens();
+  ProgramStateRef State = C.getState();
+
+  if (const ParmVarDecl *PVD = getParam(E, Call)) {
+    // A reference argument is the location of the referenced object
+    if (PVD->getType()->isReferenceType())
+      return Call.getArgSVal(PVD->getFunctionScopeIndex());
+    return UnknownVal();
+  }
+  if (const auto *DRE = dyn_cast<DeclRefExpr>(E)) {
+    const auto *VD = dyn_cast<VarDecl>(DRE->getDecl());
+    if (VD && VD->hasGlobalStorage() && !VD->getType()->isReferenceType())
+      return State->getLValue(VD, C.getLocationContext());
+    return UnknownVal();
+  }
+  if (const auto *ME = dyn_cast<MemberExpr>(E)) {
+    const auto *FD = dyn_cast<FieldDecl>(ME->getMemberDecl());
+    if (!FD || FD->getType()->isReferenceType())
+      return UnknownVal();
+    SVal Base = ME->isArrow() ? evalRValue(ME->getBase(), Call, C)
+                              : evalLValue(ME->getBase(), Call, C);
+    if (!Base.getAs<Loc>())
+      return UnknownVal();
+    return State->getLValue(FD, Base);
+  }
+  if (const auto *UO = dyn_cast<UnaryOperator>(E))
+    if (UO->getOpcode() == UO_Deref)
+      return evalRValue(UO->getSubExpr(), Call, C);
+  return UnknownVal();
+}
+
+SVal ProvenContractsChecker::evalRValue(const Expr *E, const CallEvent &Call,
+                                        CheckerContext &C) const {
+  E = E->IgnoreParens();
+  ASTContext &Ctx = C.getASTContext();
+  ProgramStateRef State = C.getState();
+  SValBuilder &SVB = C.getSValBuilder();
+  if (E->isValueDependent())
+    return UnknownVal();
+
+  llvm::APSInt V;
+  if (E->getType()->isIntegralOrEnumerationType() && E->EvaluateAsInt(V, Ctx))
+    return SVB.makeIntVal(V);
+  if (E->getType()->isPointerType() &&
+      E->isNullPointerConstant(Ctx, Expr::NPC_ValueDependentIsNotNull))
+    return SVB.makeNullWithType(E->getType());
+
+  if (isa<CXXThisExpr>(E)) {
+    if (const auto *IC = dyn_cast<CXXInstanceCall>(&Call))
+      return IC->getCXXThisVal();
+    return UnknownVal();
+  }
+
+  if (const auto *CE = dyn_cast<ImplicitCastExpr>(E)) {
+    const Expr *Sub = CE->getSubExpr();
+    switch (CE->getCastKind()) {
+    case CK_LValueToRValue: {
+      if (const ParmVarDecl *PVD = getParam(Sub, Call))
+        if (!PVD->getType()->isReferenceType())
+          return Call.getArgSVal(PVD->getFunctionScopeIndex());
+      SVal L = evalLValue(Sub, Call, C);
+      if (Optional<Loc> LV = L.getAs<Loc>())
+        return State->getSVal(*LV, E->getType());
+      return UnknownVal();
+    }
+    case CK_NoOp:
+    case CK_IntegralCast:
+    case CK_NullToPointer: {
+      SVal SubV = evalRValue(Sub, Call, C);
+      if (SubV.isUnknownOrUndef())
+        return SubV;
+      return SVB.evalCast(SubV, E->getType(), Sub->getType());
+    }
+    case CK_IntegralToBoolean:
+    case CK_PointerToBoolean: {
+      SVal SubV = evalRValue(Sub, Call, C);
+      if (SubV.isUnknownOrUndef())
+        return SubV;
+      return SVB.evalBinOp(State, BO_NE, SubV,
+                           SVB.makeZeroVal(Sub->getType()), E->getType());
+    }
+    default:
+      return UnknownVal();
+    }
+  }
+
+  if (const auto *BO = dyn_cast<BinaryOperator>(E)) {
+    if (BO->isLogicalOp() || BO->isAssignmentOp() ||
+        BO->getOpcode() == BO_Comma || BO->isPtrMemOp())
+      return UnknownVal();
+    SVal L = evalRValue(BO->getLHS(), Call, C);
+    SVal R = evalRValue(BO->getRHS(), Call, C);
+    if (L.isUnknownOrUndef() || R.isUnknownOrUndef())
+      return UnknownVal();
+    return SVB.evalBinOp(State, BO->getOpcode(), L, R, E->getType());
+  }
+
+  if (const auto *UO = dyn_cast<UnaryOperator>(E)) {
+    SVal SubV = evalRValue(UO->getSubExpr(), Call, C);
+    if (SubV.isUnknownOrUndef())
+      return UnknownVal();
+    switch (UO->getOpcode()) {
+    case UO_LNot:
+      return SVB.evalBinOp(State, BO_EQ, SubV,
+                           SVB.makeZeroVal(UO->getSubExpr()->getType()),
+                           E->getType());
+    case UO_Minus:
+      if (Optional<NonLoc> NL = SubV.getAs<NonLoc>())
+        return SVB.evalMinus(*NL);
+      return UnknownVal();
+    default:
+      return UnknownVal();
+    }
+  }
+
+  return UnknownVal();
+}
+
+/// Returns true if Cond holds in every state in which Call may happen.
+bool ProvenContractsChecker::isProven(const Expr *Cond, const CallEvent &Call,
+                                      CheckerContext &C) const {
+  Cond = Cond->IgnoreParens();
+  if (const auto *BO = dyn_cast<BinaryOperator>(Cond)) {
+    if (BO->getOpcode() == BO_LAnd)
+      return isProven(BO->getLHS(), Call, C) && isProven(BO->getRHS(), Call, C);
+    if (BO->getOpcode() == BO_LOr)
+      return isProven(BO->getLHS(), Call, C) || isProven(BO->getRHS(), Call, C);
+  }
+
+  Optional<DefinedSVal> V = evalRValue(Cond, Call, C).getAs<DefinedSVal>();
+  if (!V)
+    return false;
+  ProgramStateRef StTrue, StFalse;
+  std::tie(StTrue, StFalse) = C.getState()->assume(*V);
+  return !StFalse;
+}
+
+void ProvenContractsChecker::checkPreCall(const CallEvent &Call,
+                                          CheckerContext &C) const {
+  const auto *FD = dyn_cast_or_null<FunctionDecl>(Call.getDecl());
+  const Expr *CE = Call.getOriginExpr();
+  const Decl *Caller = C.getStackFrame()->getDecl();
+  if (!FD || !CE || !Caller)
+    return;
+  // [[expects]] may have been merged into a later redeclaration; conditions
+  // refer to the parameters of the redeclaration that holds them.
+  FD = FD->getMostRecentDecl();
+  if (!FD->hasAttr<ExpectsAttr>())
+    return;
+
+  if (!Mangler)
+    Mangler.reset(C.getASTContext().createMangleContext());
+  std::string CallerName = ProvenContracts::getFunctionName(*Mangler, Caller);
+  std::string CalleeName = ProvenContracts::getFunctionName(*Mangler, FD);
+  std::string Loc = ProvenContracts::getCallLocation(C.getSourceManager(),
+                                                     CE->getExprLoc());
+  if (CallerName.empty() || CalleeName.empty() || Loc.empty())
+    return;
+
+  for (const auto *A : FD->specific_attrs<ExpectsAttr>()) {
+    KeyTy Key(CallerName, Loc, CalleeName,
+              ProvenContracts::getConditionHash(C.getASTContext(),
+                                                A->getCond()));
+    // Conditions not instantiated at this build level can't be proven.
+    if (A->getPending() || !isProven(A->getCond(), Call, C))
+      Unproven.insert(Key);
+    else if (C.inTopFrame())
+      ProvenInTopFrame.insert(Key);
+  }
+}
+
+void ProvenContractsChecker::checkEndAnalysis(ExplodedGraph &G,
+                                              BugReporter &BR,
+                                              ExprEngine &Eng) const {
+  if (Eng.hasWorkRemaining())
+    AllUnproven.insert(ProvenInTopFrame.begin(), ProvenInTopFrame.end());
+  else
+    AllProven.insert(ProvenInTopFrame.begin(), ProvenInTopFrame.end());
+  AllUnproven.insert(Unproven.begin(), Unproven.end());
+  ProvenInTopFrame.clear();
+  Unproven.clear();
+}
+
+void ProvenContractsChecker::checkEndOfTranslationUnit(
+    const TranslationUnitDecl *TU, AnalysisManager &Mgr,
+    BugReporter &BR) const {
+  ProvenContracts Proven;
+  for (const KeyTy &Key : AllProven)
+    if (!AllUnproven.count(Key))
+      Proven.add(std::get<0>(Key), std::get<1>(Key), std::get<2>(Key),
+                 std::get<3>(Key));
+  if (Proven.empty())
+    return;
+
+  // Append the records in one write, as several translation units may be
+  // analyzed at once.
+  std::string Records;
+  llvm::raw_string_ostream OS(Records);
+  Proven.write(OS);
+  OS.flush();
+
+  StringRef Path = Mgr.getAnalyzerOptions().getOptionAsString(
+      "Output", "default.proven", this);
+  std::error_code EC;
+  llvm::raw_fd_ostream File(Path, EC, llvm::sys::fs::F_Append |
+                                          llvm::sys::fs::F_Text);
+  if (EC) {
+    DiagnosticsEngine &Diags = Mgr.getDiagnostic();
+    unsigned DiagID = Diags.getCustomDiagID(DiagnosticsEngine::Error,
+                                            "Could not write %0: %1");
+    Diags.Report(DiagID) << Path << EC.message();
+    return;
+  }
+  File << Records;
+}
+
+void ento::registerProvenContractsChecker(CheckerManager &mgr) {
+  mgr.registerChecker<ProvenContractsChecker>();
+}
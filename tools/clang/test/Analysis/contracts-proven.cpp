@@ -0,0 +1,28 @@
+// RUN: rm -f %t
+// RUN: %clang_analyze_cc1 -std=c++14 -analyzer-checker=optin.performance.ProvenContracts -analyzer-config optin.performance.ProvenContracts:Output=%t %s
+// RUN: FileCheck %s < %t
+// RUN: FileCheck %s --check-prefix=UNPROVEN < %t
+
+int f(int x) [[expects: x > 0]] [[expects: x < 100]];
+
+// CHECK-DAG: _Z1gv	{{.*}}contracts-proven.cpp:[[@LINE+2]]:18	_Z1fi	41f29d3235e4f71169aa55c55dfb849c
+// CHECK-DAG: _Z1gv	{{.*}}contracts-proven.cpp:[[@LINE+1]]:18	_Z1fi	a136067f5e332e75314bbf670231122e
+int g() { return f(5); }
+
+int h(int y) {
+  if (y >= 100)
+    return 0;
+  // Only one of the preconditions holds on every path.
+  // CHECK-DAG: _Z1hi	{{.*}}contracts-proven.cpp:[[@LINE+1]]:10	_Z1fi
+  return f(y);
+}
+
+// UNPROVEN-NOT: _Z1ki
+int k(int y) { return f(y); }
+
+struct S {
+  int n;
+  int at(int i) [[expects: i >= 0 && i < n]];
+  // CHECK-DAG: _ZN1S5firstEv	{{.*}}contracts-proven.cpp:[[@LINE+1]]:31	_ZN1S2atEi	aa8129cb6b8e1d0e6d0278fb0ff4efe0
+  int first() { n = 1; return at(0); }
+};
@@ -0,0 +1,48 @@
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -O1 -disable-llvm-passes -emit-llvm -o - %s | FileCheck %s
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -O1 -disable-llvm-passes -axiom-mode=off -emit-llvm -o - %s | FileCheck %s --check-prefix=OFF
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -O1 -disable-llvm-passes -contract-assume-unchecked -emit-llvm -o - %s | FileCheck %s --check-prefix=UNCHECKED
+
+typedef __UINTPTR_TYPE__ uintptr_t;
+
+void f(int *p, float *q, int n)
+  [[expects axiom: p != nullptr && (uintptr_t)q % 32 == 0]]
+  [[expects axiom: n > 0]];
+void g(int *p) [[expects audit: p]];
+
+struct S {
+  void h(int *p) [[expects axiom: ((uintptr_t)p & 15) == 0]];
+};
+
+// Axioms are assumed by the callers, and become attributes of the parameters.
+// CHECK-LABEL: define void @_Z6callerPiPfR1S(
+// CHECK: call void @llvm.assume(i1
+// CHECK: call void @llvm.assume(i1
+// CHECK: call void @_Z1fPiPfi(i32* nonnull %{{.*}}, float* align 32 %{{.*}}, i32 4)
+// CHECK-NOT: call void @llvm.assume(
+// CHECK: call void @_Z1gPi(i32* %{{.*}})
+// CHECK: call void @llvm.assume(i1
+// CHECK: call void @_ZN1S1hEPi(%struct.S* %{{.*}}, i32* align 16 %{{.*}})
+// CHECK-DAG: declare void @_Z1fPiPfi(i32* nonnull, float* align 32, i32)
+// CHECK-DAG: declare void @_Z1gPi(i32*)
+// OFF-LABEL: define void @_Z6callerPiPfR1S(
+// OFF-NOT: call void @llvm.assume(
+// OFF: call void @_Z1fPiPfi(i32* %{{.*}}, float* %{{.*}}, i32 4)
+// UNCHECKED-LABEL: define void @_Z6callerPiPfR1S(
+// UNCHECKED: call void @_Z1fPiPfi(i32* nonnull %{{.*}}, float* align 32 %{{.*}}, i32 4)
+// UNCHECKED: call void @llvm.assume(i1
+// UNCHECKED: call void @_Z1gPi(i32* nonnull %{{.*}})
+// UNCHECKED: declare void @_Z1gPi(i32* nonnull)
+void caller(int *p, float *q, S &s) {
+  f(p, q, 4);
+  g(p);
+  s.h(p);
+}
+
+// The callee has them as well, even once its checked body is synthesized.
+// CHECK-LABEL: define void @_Z1kPi(i32* nonnull %p)
+void k(int *p) [[expects axiom: p]] [[ensures: true]] { *p = 0; }
+
+// CHECK-LABEL: define void @_Z8caller_kPi(
+// CHECK: call void @llvm.assume(i1
+// CHECK: call void @_Z1kPi(i32* nonnull %{{.*}})
+void caller_k(int *p) { k(p); }
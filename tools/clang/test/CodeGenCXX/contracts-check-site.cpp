@@ -0,0 +1,43 @@
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -emit-llvm -o - %s | FileCheck %s --check-prefix=CALLEE
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -contract-check-site=caller -emit-llvm -o - %s | FileCheck %s --check-prefix=CALLER
+
+int f(int x) [[expects: x > 0]] { return x; }
+// CALLEE-LABEL: define i32 @_Z1fi(
+// CALLEE: call void @_ZSt9terminatev()
+// CALLEE: ret i32
+// CALLER-LABEL: define i32 @_Z1fi(
+// CALLER-NOT: call void @_ZSt9terminatev()
+// CALLER: ret i32
+
+// CALLEE-LABEL: define i32 @_Z1gi(
+// CALLEE-NOT: call void @_ZSt9terminatev()
+// CALLEE: call i32 @_Z1fi(
+// CALLER-LABEL: define i32 @_Z1gi(
+// CALLER: store i32 %{{.*}}, i32* %[[ARG:contract.arg[0-9]*]]
+// CALLER: %[[X:.*]] = load i32, i32* %[[ARG]]
+// CALLER: icmp sgt i32 %[[X]], 0
+// CALLER: call void @_ZSt9terminatev()
+// CALLER: call i32 @_Z1fi(
+int g(int y) { return f(y); }
+
+struct S {
+  int n;
+  int at(int i) [[expects: i < n]] { return i; }
+};
+
+// CALLER-LABEL: define i32 @_Z1hR1Si(
+// CALLER: %[[N:.*]] = getelementptr inbounds %struct.S, %struct.S* %{{.*}}, i32 0, i32 0
+// CALLER: load i32, i32* %[[N]]
+// CALLER: call void @_ZSt9terminatev()
+// CALLER: call i32 @_ZN1S2atEi(
+int h(S &s, int i) { return s.at(i); }
+
+// The caller of a function pointer does not know the preconditions, and the
+// called function leaves them to its callers: indirect calls are not checked
+// (see README.md).
+// CALLER-LABEL: define i32 @_Z8indirectPFiiEi(
+// CALLER-NOT: call void @_ZSt9terminatev()
+// CALLER: call i32 %
+// CALLER-NOT: call void @_ZSt9terminatev()
+// CALLER: ret i32
+int indirect(int (*fp)(int), int i) { return fp(i); }
@@ -0,0 +1,39 @@
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -emit-llvm -o - %s | FileCheck %s
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -contract-trust-ensures -emit-llvm -o - %s | FileCheck %s --check-prefix=TRUST
+
+typedef __UINTPTR_TYPE__ uintptr_t;
+
+int *alloc(int n) [[ensures axiom r: r != nullptr && (uintptr_t)r % 64 == 0]];
+int index(int n) [[ensures r: r >= 0 && r < 16]];
+unsigned bucket(unsigned h) [[ensures axiom r: r <= 7]];
+short narrow() [[ensures axiom r: r < 4]];
+
+// Axioms are relied on by the callers; other postconditions only with
+// -contract-trust-ensures.
+// CHECK-LABEL: define i32 @_Z1fi(
+// CHECK: call nonnull align 64 i32* @_Z5alloci(
+// CHECK: call i32 @_Z5indexi(i32 %{{.*}})
+// CHECK-NOT: !range
+// CHECK: call i32 @_Z6bucketj(i32 %{{.*}}), !range ![[BUCKET:[0-9]+]]
+// CHECK: call signext i16 @_Z6narrowv()
+// CHECK-NOT: !range
+// CHECK: ret i32
+// CHECK: declare i32* @_Z5alloci(i32)
+// TRUST-LABEL: define i32 @_Z1fi(
+// TRUST: call i32 @_Z5indexi(i32 %{{.*}}), !range ![[INDEX:[0-9]+]]
+int f(int n) {
+  return alloc(n)[index(n)] + bucket(n) + narrow();
+}
+
+// The checked function itself does not rely on its postconditions.
+// TRUST-LABEL: define i32* @_Z2idPi(i32* %p)
+int *id(int *p) [[ensures r: r != nullptr]] { return p; }
+
+// CHECK-LABEL: define i32* @_Z1gPi(
+// CHECK: call i32* @_Z2idPi(
+// TRUST-LABEL: define i32* @_Z1gPi(
+// TRUST: call nonnull i32* @_Z2idPi(
+int *g(int *p) { return id(p); }
+
+// CHECK: ![[BUCKET]] = !{i32 0, i32 8}
+// TRUST: ![[INDEX]] = !{i32 0, i32 16}
@@ -0,0 +1,50 @@
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -fcontract-export-unchecked -emit-llvm -o - %s | FileCheck %s
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -fcontract-export-unchecked -build-level=off -emit-llvm -o - %s | FileCheck %s --check-prefix=OFF
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -emit-llvm -o - %s | FileCheck %s --check-prefix=NOEXPORT
+
+// Functions with contracts export an unchecked entry point, mangled with the
+// U9unchecked qualifier, which trusted callers call directly.
+// NOEXPORT-NOT: U9unchecked
+
+int f(int x) [[expects: x > 0]];
+
+struct S {
+  int v;
+  int get(int i) [[expects: i >= 0]] { return v + i; }
+};
+
+// CHECK-LABEL: define i32 @_Z4usesi(
+// CHECK: call i32 @_Z1fi(
+// OFF-LABEL: define i32 @_Z4usesi(
+// OFF: call i32 @_Z1fU9uncheckedi(
+int uses(int x) { return f(x); }
+
+// The checked entry point checks the contracts and calls the unchecked one,
+// which has the body of the function.
+// CHECK-LABEL: define i32 @_Z1fi(
+// CHECK: call i1 @llvm.contract.check(
+// CHECK: [[R:%.*]] = call i32 @_Z1fU9uncheckedi(i32
+// CHECK-NEXT: ret i32 [[R]]
+// OFF-LABEL: define i32 @_Z1fi(
+// OFF-NOT: @llvm.contract.check
+// OFF: call i32 @_Z1fU9uncheckedi(i32
+
+// CHECK-LABEL: define i32 @_Z7trustedR1Si(
+// CHECK: call i32 @_Z1fU9uncheckedi(
+// CHECK: call i32 @_ZN1S3getEU9uncheckedi(
+[[clang::contract_trusted]] int trusted(S &s, int x) {
+  return f(x) + s.get(x);
+}
+
+// CHECK-LABEL: define i32 @_Z1fU9uncheckedi(
+// CHECK-NOT: @llvm.contract.check
+// CHECK: mul nsw i32
+// CHECK: ret i32
+int f(int x) [[expects: x > 0]] { return x * 2; }
+
+// Inline functions have their unchecked entry point emitted where it is used.
+// CHECK-LABEL: define linkonce_odr i32 @_ZN1S3getEi(
+// CHECK: call i32 @_ZN1S3getEU9uncheckedi(%struct.S*
+// CHECK-LABEL: define linkonce_odr i32 @_ZN1S3getEU9uncheckedi(
+// CHECK-NOT: @llvm.contract.check
+// CHECK: ret i32
@@ -0,0 +1,25 @@
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -Wno-contract-always-false -emit-llvm -o - %s | FileCheck %s
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -Wno-contract-always-false -emit-llvm -o - %s | FileCheck %s --check-prefix=NOSPLIT
+// NOSPLIT-NOT: U9unchecked
+
+// Contracts that Sema folded to true are not checked, and don't require a
+// checked function.
+// CHECK-LABEL: define i32 @_Z1fi(
+// CHECK-NOT: @llvm.contract.check
+// CHECK: ret i32
+int f(int x) [[expects: sizeof(int) >= 2]] [[ensures: true]] {
+  [[assert: 1 + 1 == 2]];
+  return x;
+}
+
+template <typename T> T g(T x) [[expects: sizeof(T) == 4]] { return x; }
+
+// CHECK-LABEL: define i32 @_Z6call_gi(
+// CHECK-NOT: @llvm.contract.check
+// CHECK: ret i32
+int call_g(int x) { return g(x); }
+
+// Conditions that never hold are still checked.
+// CHECK-LABEL: define void @_Z1hv(
+// CHECK: call i1 @llvm.contract.check(i1 false
+void h() { [[assert: sizeof(int) == 1]]; }
@@ -0,0 +1,22 @@
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -O2 -vectorize-loops -emit-llvm -o - %s | FileCheck %s
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -O2 -vectorize-loops -fexperimental-new-pass-manager -emit-llvm -o - %s | FileCheck %s
+
+// The precondition of the inlined accessor is tested once before the loop,
+// which is then vectorized; the violations are still reported by the copy of
+// the loop that keeps the checks.
+
+struct Vec {
+  int *p;
+  unsigned long n;
+  int &at(unsigned long i) [[expects: i < n]] { return p[i]; }
+};
+
+// CHECK-LABEL: define void @_Z3incR3Vecm(
+// CHECK: for.body.contract.check:
+// CHECK: vector.body:
+// CHECK: add nsw <4 x i32>
+// CHECK: call void @_ZSt9terminatev()
+void inc(Vec &v, unsigned long m) {
+  for (unsigned long i = 0; i < m; ++i)
+    v.at(i) += 1;
+}
@@ -0,0 +1,32 @@
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -fcontract-policy=%S/Inputs/contracts-policy.txt -emit-llvm -o - %s | FileCheck %s
+
+// The policy file sets the build level and axiom mode of the contracts of
+// some functions; the others have those of the translation unit.
+namespace fast {
+// CHECK-LABEL: define i32 @_ZN4fast1fEi(
+// CHECK-NOT: @llvm.contract.check
+// CHECK: ret i32
+int f(int x) [[expects: x > 0]] { return x; }
+
+// CHECK-LABEL: define i32 @_ZN4fast1gEPi(
+// CHECK-NOT: @llvm.assume
+// CHECK: ret i32
+int g(int *p) [[expects axiom: p != nullptr]] { return *p; }
+}
+
+// CHECK-LABEL: define i32 @_Z4coldi(
+// CHECK: call i1 @llvm.contract.check(
+int cold(int x) [[expects audit: x > 0]] { return x; }
+
+// CHECK-LABEL: define i32 @_Z6normali(
+// CHECK-NOT: @llvm.contract.check
+// CHECK: ret i32
+int normal(int x) [[expects audit: x > 0]] { return x; }
+
+// CHECK-LABEL: define i32 @_Z8default_i(
+// CHECK: call i1 @llvm.contract.check(
+int default_(int x) [[expects: x > 0]] { return x; }
+
+// CHECK-LABEL: define i32 @_Z5axiomPi(
+// CHECK: call void @llvm.assume(
+int axiom(int *p) [[expects axiom: p != nullptr]] { return *p; }
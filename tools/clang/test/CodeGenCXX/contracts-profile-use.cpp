@@ -0,0 +1,28 @@
+// RUN: sed -e "s|FILE|%s|" %S/Inputs/contracts-profile-use.contractprof > %t.contractprof
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -fcontract-profile-use=%t.contractprof -emit-llvm -o - %s | FileCheck %s --check-prefix=KEEP-ALL
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -fcontract-profile-use=%t.contractprof -fcontract-profile-top=1 -emit-llvm -o - %s | FileCheck %s --check-prefix=TOP1
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -fcontract-profile-use=%t.contractprof -fcontract-profile-budget=10 -emit-llvm -o - %s | FileCheck %s --check-prefix=BUDGET
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -fcontract-profile-use=%t.contractprof -fcontract-profile-top=1 -build-level=audit -emit-llvm -o - %s | FileCheck %s --check-prefix=KEEP-ALL
+// RUN: not %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -fcontract-profile-use=%t.missing -emit-llvm -o - %s 2>&1 | FileCheck %s --check-prefix=MISSING
+
+// MISSING: error: Could not read profile {{.*}}.missing
+
+// The profile ranks the checks on a (2000 cycles), c (1000) and b (20).
+
+// KEEP-ALL-LABEL: define void @_Z1fiii(
+// KEEP-ALL: icmp sgt i32 %{{.*}}, 1
+// KEEP-ALL: icmp sgt i32 %{{.*}}, 2
+// KEEP-ALL: icmp sgt i32 %{{.*}}, 3
+// TOP1-LABEL: define void @_Z1fiii(
+// TOP1-NOT: icmp sgt i32 %{{.*}}, 1
+// TOP1: icmp sgt i32 %{{.*}}, 2
+// TOP1: icmp sgt i32 %{{.*}}, 3
+// BUDGET-LABEL: define void @_Z1fiii(
+// BUDGET-NOT: icmp sgt i32 %{{.*}}, 1
+// BUDGET: icmp sgt i32 %{{.*}}, 2
+// BUDGET-NOT: icmp sgt i32 %{{.*}}, 3
+void f(int a, int b, int c) {
+  [[assert: a > 1]];
+  [[assert: b > 2]];
+  [[assert: c > 3]];
+}
@@ -0,0 +1,31 @@
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -fcontract-profile -emit-llvm -o - %s | FileCheck %s --check-prefix=CHECK --check-prefix=O0
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -fcontract-profile -O1 -disable-llvm-passes -emit-llvm -o - %s | FileCheck %s --check-prefix=CHECK --check-prefix=O1
+
+// CHECK: @__contract_violation_tab = private unnamed_addr constant [2 x { i32, i32, i32, i32, i32 }]
+// CHECK: @__contract_profile_counters = private global [2 x [2 x i64]] zeroinitializer, align 8
+// CHECK: @__contract_profile_cost = private unnamed_addr constant [2 x i32] [i32 2, i32 7]
+// CHECK: @__contract_profile_module = private global { i8*, i32, i8*, i8*, i8*, i8* } { i8* null, i32 2, i8* bitcast ({{.*}} @__contract_violation_tab to i8*), i8* getelementptr inbounds ({{.*}} @__contract_violation_strtab, {{.*}}), i8* bitcast ({{.*}} @__contract_profile_cost to i8*), i8* bitcast ({{.*}} @__contract_profile_counters to i8*) }
+// CHECK: @llvm.global_ctors = appending global {{.*}} @__contract_profile_init
+
+int sq(int x);
+
+// CHECK-LABEL: define void @_Z1fii(
+void f(int a, int b) {
+  // CHECK: %[[N0:.*]] = load i64, i64* {{.*}}@__contract_profile_counters{{.*}}, align 8
+  // CHECK: %[[I0:.*]] = add i64 %[[N0]], 1
+  // CHECK: store i64 %[[I0]], i64* {{.*}}@__contract_profile_counters{{.*}}, align 8
+  // CHECK: call i1 @llvm.contract.check(i1 %{{.*}}, i32 0)
+  // O0: contract.violation:
+  // O0: load i64, i64* {{.*}}@__contract_profile_counters{{.*}}, align 8
+  // O0: call void @_ZSt9terminatev()
+  // O1: %contract.id = phi i32 [ 0, %{{.*}} ], [ 1, %{{.*}} ]
+  // O1: getelementptr {{.*}}@__contract_profile_counters{{.*}}, i32 0, i32 %contract.id, i32 1
+  // O1: call void @_ZSt9terminatev()
+  [[assert: a > 0]];
+
+  // CHECK: call i1 @llvm.contract.check(i1 %{{.*}}, i32 1)
+  [[assert: sq(b) > 0]];
+}
+
+// CHECK-LABEL: define internal void @__contract_profile_init()
+// CHECK: call void @__contract_profile_register(i8* bitcast ({{.*}} @__contract_profile_module to i8*))
@@ -0,0 +1,24 @@
+// RUN: sed -e "s|FILE|%s|" %S/Inputs/contracts-proven.proven > %t.proven
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -contract-check-site=caller -emit-llvm -o - %s | FileCheck %s --check-prefix=ALL
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -contract-check-site=caller -fcontract-proven=%t.proven -emit-llvm -o - %s | FileCheck %s
+// RUN: not %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -fcontract-proven=%t.missing -emit-llvm -o - %s 2>&1 | FileCheck %s --check-prefix=MISSING
+
+int f(int x) [[expects: x > 0]] [[expects: x < 100]];
+
+// ALL-LABEL: define i32 @_Z1gv(
+// ALL: call void @_ZSt9terminatev()
+// CHECK-LABEL: define i32 @_Z1gv(
+// CHECK-NOT: icmp
+// CHECK-NOT: call void @_ZSt9terminatev()
+// CHECK: call i32 @_Z1fi(i32 5)
+int g() { return f(5); }
+
+// Only the second precondition is proven at this call; the record of the first
+// one is for another condition.
+// CHECK-LABEL: define i32 @_Z1hi(
+// CHECK: icmp sgt i32 %{{.*}}, 0
+// CHECK-NOT: icmp slt
+// CHECK: call i32 @_Z1fi(
+int h(int y) { return f(y); }
+
+// MISSING: error: Could not read {{.*}}.missing
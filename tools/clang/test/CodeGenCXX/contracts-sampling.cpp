@@ -0,0 +1,29 @@
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -contract-sampling=100 -build-level=audit -emit-llvm -o - %s | FileCheck %s
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -emit-llvm -o - %s | FileCheck %s --check-prefix=NOSAMPLE
+
+// CHECK: @__contract_sampling_countdown = internal thread_local global i32 0, align 4
+// NOSAMPLE-NOT: __contract_sampling_countdown
+
+int p(int);
+
+// CHECK-LABEL: define void @_Z1fi(
+void f(int a) {
+  // CHECK: %[[C:contract.countdown[0-9]*]] = load i32, i32* @__contract_sampling_countdown, align 4
+  // CHECK: %[[D:.*]] = sub i32 %[[C]], 1
+  // CHECK: store i32 %[[D]], i32* @__contract_sampling_countdown, align 4
+  // CHECK: %[[S:.*]] = icmp sle i32 %[[D]], 0
+  // CHECK: br i1 %[[S]], label %[[SAMPLE:contract.sample[0-9]*]], label %[[CONT:contract.cont[0-9]*]], !prof ![[SAMPLING:[0-9]+]]
+  // CHECK: [[SAMPLE]]:
+  // CHECK: store i32 100, i32* @__contract_sampling_countdown, align 4
+  // CHECK: call i32 @_Z1pi(
+  // CHECK: call i1 @llvm.contract.check(
+  // CHECK: [[CONT]]:
+  [[assert: p(a) > 0]];
+
+  // Audit checks are never sampled.
+  // CHECK-NOT: __contract_sampling_countdown
+  // CHECK: call i1 @llvm.contract.check(
+  [[assert audit: a > 1]];
+}
+
+// CHECK: ![[SAMPLING]] = !{!"branch_weights", i32 1, i32 99}
@@ -0,0 +1,107 @@
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -emit-llvm -o %t %s
+// RUN: FileCheck %s < %t
+// RUN: FileCheck %s --check-prefix=BASE < %t
+// RUN: FileCheck %s --check-prefix=COMPLETE < %t
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -fcontract-export-unchecked -emit-llvm -o - %s | FileCheck %s --check-prefix=EXPORT
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -emit-llvm -o /dev/null -verify %s
+
+// The body of a function with contracts is emitted once, between the checks
+// of its preconditions and those of its postconditions.
+// CHECK-NOT: U9unchecked
+
+// CHECK-LABEL: define i32 @_Z1fi(
+// CHECK: [[X:%.*]] = load i32, i32* %x.addr
+// CHECK: icmp sgt i32 [[X]], 0
+// CHECK: call i1 @llvm.contract.check(
+// CHECK: store i32 {{.*}}, i32* %retval
+// CHECK: [[R:%.*]] = load i32, i32* %retval
+// CHECK: icmp slt i32 [[R]], 100
+// CHECK: call i1 @llvm.contract.check(
+// CHECK: [[RET:%.*]] = load i32, i32* %retval
+// CHECK: ret i32 [[RET]]
+// CHECK-NOT: U9unchecked
+int f(int x) [[expects: x > 0]] [[ensures r: r < 100]] {
+  if (x > 10)
+    return 10;
+  return x;
+}
+
+struct S {
+  int v;
+  S(int v) [[expects: v != 0]] : v(v) {}
+};
+
+// The complete constructor delegates to the base one, which checks the
+// precondition before the member initializers.
+// BASE-LABEL: define linkonce_odr void @_ZN1SC2Ei(
+// BASE: call i1 @llvm.contract.check(
+// BASE: getelementptr inbounds %struct.S
+// BASE: ret void
+// COMPLETE-LABEL: define linkonce_odr void @_ZN1SC1Ei(
+// COMPLETE-NOT: @llvm.contract.check
+// COMPLETE: call void @_ZN1SC2Ei(
+// COMPLETE: ret void
+void g() { S s(1); }
+
+// The postconditions are checked on the returned object in place: the sret
+// slot, or the returned reference.
+struct Big { int a[8]; };
+
+// CHECK-LABEL: define void @_Z3bigi(%struct.Big* noalias sret %agg.result, i32
+// CHECK-NOT: memcpy
+// CHECK: store i32 {{.*}}, i32* %arrayidx
+// CHECK: [[A:%.*]] = getelementptr inbounds %struct.Big, %struct.Big* %agg.result, i32 0, i32 0
+// CHECK: getelementptr inbounds [8 x i32], [8 x i32]* [[A]]
+// CHECK: call i1 @llvm.contract.check(
+// CHECK-NOT: memcpy
+// CHECK: ret void
+Big big(int x) [[ensures r: r.a[0] == x]] {
+  Big b = {};
+  b.a[0] = x;
+  return b;
+}
+
+// CHECK-LABEL: define dereferenceable(4) i32* @_Z3refRi(
+// CHECK: [[P:%.*]] = load i32*, i32** %retval
+// CHECK: load i32, i32* [[P]]
+// CHECK: call i1 @llvm.contract.check(
+int &ref(int &x) [[ensures r: r > 0]] { return x; }
+
+// The postconditions refer to the parameters as they were on entry, which the
+// body may modify.
+// CHECK-LABEL: define i32 @_Z3inci(
+// CHECK: [[X0:%.*]] = load i32, i32* %x.addr
+// CHECK: store i32 [[X0]], i32* %x.entry
+// CHECK: store i32 {{.*}}, i32* %x.addr
+// CHECK: [[R:%.*]] = load i32, i32* %retval
+// CHECK: [[X1:%.*]] = load i32, i32* %x.entry
+// CHECK: icmp sgt i32 [[R]], [[X1]]
+// CHECK: call i1 @llvm.contract.check(
+int inc(int x) [[ensures r: r > x]] { x = x + 1; return x; }
+
+// Parameters that can't be copied on entry are read on return.
+struct Counter {
+  int n;
+  Counter(const Counter &c) : n(c.n) {}
+};
+
+// CHECK-LABEL: define i32 @_Z4next7Counter(
+// CHECK-NOT: .entry
+// CHECK: call i1 @llvm.contract.check(
+int next(Counter c) [[ensures r: r == c.n]] { // expected-warning {{postcondition refers to parameter 'c', which can't be copied on entry and is checked with its value on return}}
+  return c.n++;
+}
+
+// The checked entry point stores the result of the unchecked one straight
+// into its return value, even if it is returned in registers.
+struct Pair { int a, b; };
+
+// EXPORT-LABEL: define i64 @_Z4pairi(
+// EXPORT-NOT: %coerce
+// EXPORT: [[R:%.*]] = call i64 @_Z4pairU9uncheckedi(i32
+// EXPORT-NOT: memcpy
+// EXPORT: store i64 [[R]], i64*
+// EXPORT: call i1 @llvm.contract.check(
+// EXPORT-NOT: memcpy
+// EXPORT: ret i64
+Pair pair(int x) [[ensures r: r.a == x]] { return {x, x}; }
@@ -0,0 +1,28 @@
+// REQUIRES: asserts
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -fcontract-vtable-thunks -contract-violation-handler=handler -contract-assume-unchecked -emit-llvm -o /dev/null -print-stats %s 2>&1 | FileCheck %s
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -fcontract-export-unchecked -emit-llvm -o /dev/null -print-stats %s 2>&1 | FileCheck %s --check-prefix=EXPORT
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -emit-llvm -o /dev/null -ftime-report %s 2>&1 | FileCheck %s --check-prefix=TIME
+
+// CHECK-DAG: 1 contracts - The # of contract conditions emitted as assumptions
+// CHECK-DAG: 4 contracts - The # of contract attributes parsed
+// CHECK-DAG: 1 contracts - The # of contract conditions instantiated
+// CHECK-DAG: 1 contracts - The # of thunks emitted that check contracts
+// CHECK-DAG: 3 contracts - The # of contract violation table entries registered
+// CHECK-NOT: unchecked entry points
+
+// EXPORT: 3 contracts - The # of unchecked entry points emitted for contracts
+
+// TIME: Contract Processing Time
+// TIME-DAG: Contract Attribute Parsing
+// TIME-DAG: Contract Condition Instantiation
+// TIME-DAG: Contract Check Generation
+
+void f(int a) [[expects: a > 0]] [[expects audit: a < 100]] {}
+
+template <class T> void g(T x) [[expects: x > 0]] {}
+void h() { g(1); }
+
+struct B {
+  virtual void v(int x) [[expects: x > 0]];
+};
+void B::v(int x) {}
@@ -0,0 +1,26 @@
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -emit-llvm -o - %s | FileCheck %s --check-prefix=CHECK --check-prefix=O0
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -O1 -disable-llvm-passes -contract-violation-handler=handler -emit-llvm -o - %s | FileCheck %s --check-prefix=CHECK --check-prefix=O1
+
+// CHECK-LABEL: define void @_Z1fii(
+void f(int a, int b) {
+  // CHECK: [[C1:%.*]] = call i1 @llvm.contract.check(i1 %{{.*}}, i32 0)
+  // CHECK: br i1 [[C1]], label %{{.*}}, label %[[VIOL:contract.violation[0-9]*]], !prof ![[WEIGHTS:[0-9]+]]
+  // CHECK: [[VIOL]]:
+  // O1: %contract.id = phi i32 [ 0, %{{.*}} ], [ 1, %{{.*}} ]
+  // O0: call void @_ZSt9terminatev()
+  // O1: call void @_ZL27__builtin_violation_handlerj(i32 %contract.id)
+  // O1-NEXT: unreachable
+  [[assert: a > 0]];
+
+  // O0: [[C2:%.*]] = call i1 @llvm.contract.check(i1 %{{.*}}, i32 0)
+  // O1: [[C2:%.*]] = call i1 @llvm.contract.check(i1 %{{.*}}, i32 1)
+  // O0: br i1 [[C2]], label %{{.*}}, label %contract.violation{{[0-9]+}}, !prof ![[WEIGHTS]]
+  // O1: br i1 [[C2]], label %{{.*}}, label %[[VIOL]], !prof ![[WEIGHTS]]
+  [[assert: b > 0]];
+}
+
+// O0: declare void @_ZSt9terminatev() [[HANDLER:#[0-9]+]]
+// O1: define internal void @_ZL27__builtin_violation_handlerj({{.*}}) [[HANDLER:#[0-9]+]]
+
+// CHECK: attributes [[HANDLER]] = { cold noinline {{.*}}}
+// CHECK: ![[WEIGHTS]] = !{!"branch_weights", i32 1048575, i32 1}
@@ -0,0 +1,38 @@
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -fcontract-violation-log -emit-llvm -o - %s | FileCheck %s
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -fcontract-violation-log -fcontinue-after-violation -emit-llvm -o - %s | FileCheck %s --check-prefix=CONTINUE
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -fcontract-violation-log -contract-violation-handler=handler -emit-llvm -o - %s | FileCheck %s --check-prefix=HANDLER
+
+// CHECK: @__contract_violation_tab = private unnamed_addr constant [2 x { i32, i32, i32, i32, i32 }]
+// CHECK: @__contract_log_rate = private global [2 x i64] zeroinitializer, align 8
+// CHECK: @__contract_log_module = private global { i8*, i32, i32, i8*, i8*, i8* } { i8* null, i32 2, i32 0, i8* bitcast ({{.*}} @__contract_violation_tab to i8*), i8* getelementptr inbounds ({{.*}} @__contract_violation_strtab, {{.*}}), i8* bitcast ({{.*}} @__contract_log_rate to i8*) }
+// CHECK: @llvm.global_ctors = appending global {{.*}} @__contract_log_init
+
+// Without a user handler, violations still go through
+// __builtin_violation_handler().
+// CHECK-LABEL: define void @_Z1fii(
+void f(int a, int b) {
+  // CHECK: call void @_ZL27__builtin_violation_handlerj(i32 0)
+  [[assert: a > 0]];
+  // CHECK: call void @_ZL27__builtin_violation_handlerj(i32 1)
+  [[assert: b > 0]];
+}
+
+// The violation is logged first; the log is flushed before terminating.
+// CHECK-LABEL: define internal void @_ZL27__builtin_violation_handlerj(i32
+// CHECK: call void @__contract_violation_log(i8* bitcast ({{.*}} @__contract_log_module to i8*), i32 %
+// CHECK-NEXT: call void @__contract_violation_log_flush()
+// CHECK-NEXT: call void @_ZSt9terminatev()
+// CHECK-NEXT: unreachable
+
+// CONTINUE-LABEL: define internal void @_ZL27__builtin_violation_handlerj(i32
+// CONTINUE: call void @__contract_violation_log(
+// CONTINUE-NEXT: ret void
+
+// HANDLER-LABEL: define internal void @_ZL27__builtin_violation_handlerj(i32
+// HANDLER: call void @__contract_violation_log(
+// HANDLER: call void @handler(
+// HANDLER: call void @__contract_violation_log_flush()
+// HANDLER-NEXT: call void @_ZSt9terminatev()
+
+// CHECK-LABEL: define internal void @__contract_log_init()
+// CHECK: call void @__contract_log_register(i8* bitcast ({{.*}} @__contract_log_module to i8*))
@@ -0,0 +1,44 @@
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -contract-violation-handler=handler -fcontract-violation-site-ids -emit-llvm -o - %s | FileCheck %s
+// RUN: not %clang_cc1 -std=c++14 -triple x86_64-apple-darwin -fcontract-violation-site-ids -emit-llvm -o - %s 2>&1 | FileCheck %s --check-prefix=DARWIN
+// RUN: not %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -fcontract-violation-log -fcontract-violation-site-ids -emit-llvm -o - %s 2>&1 | FileCheck %s --check-prefix=LOG
+
+// DARWIN: error: unsupported option '-fcontract-violation-site-ids' for target 'x86_64-apple-darwin'
+// LOG: error: invalid argument '-fcontract-violation-site-ids' not allowed with '-fcontract-violation-log'
+
+// The handler is passed a site id; the entries and their strings only go to
+// the .llvm_contract_info section, which is not loaded.
+// CHECK-NOT: @__contract_violation_tab
+// CHECK-NOT: @__contract_violation_strtab
+// CHECK: @__contract_violation_info = private constant <{ i32, i32, i32, [3 x { i32, { i32, i32, i32, i32, i32 } }], [{{[0-9]+}} x i8] }>
+// CHECK-SAME: <{ i32 1, i32 3, i32 {{[0-9]+}},
+// CHECK-SAME: { i32 [[A:-?[0-9]+]], { i32, i32, i32, i32, i32 } { i32 {{[0-9]+}}, i32 0,
+// CHECK-SAME: { i32 [[B:-?[0-9]+]], { i32, i32, i32, i32, i32 } { i32 {{[0-9]+}}, i32 0,
+// CHECK-SAME: { i32 [[G:-?[0-9]+]], { i32, i32, i32, i32, i32 } { i32 {{[0-9]+}}, i32 0,
+// CHECK-SAME: c"{{.*}}contracts-violation-site-ids.cpp\00f\00a > 0\00default\00b > 0\00g\00{{(\\00)*}}" }>, section ".llvm_contract_info", align 4
+// CHECK: @llvm.used = appending global {{.*}} @__contract_violation_info
+
+// CHECK-LABEL: define void @_Z1fii(
+void f(int a, int b) {
+  // CHECK: call void @_ZL27__builtin_violation_handlerj(i32 [[A]])
+  [[assert: a > 0]];
+  // CHECK: call void @_ZL27__builtin_violation_handlerj(i32 [[B]])
+  [[assert: b > 0]];
+}
+
+// CHECK-LABEL: define internal void @_ZL27__builtin_violation_handlerj(i32
+// CHECK: %[[STRTAB:.*]] = alloca i8*
+// CHECK: %[[ENTRY:.*]] = call i32* @__contract_violation_decode(i32 %{{.*}}, i8** %[[STRTAB]])
+// CHECK: bitcast i32* %[[ENTRY]] to { i32, i32, i32, i32, i32 }*
+// CHECK: getelementptr inbounds i8, i8* %{{.*}}, i32 %
+// CHECK: call void @handler(
+// CHECK: call void @_ZSt9terminatev()
+// CHECK-NEXT: unreachable
+
+// Instantiations of the same contract share a site id.
+template <class T> void g(T a) { [[assert: a > 0]]; }
+void h() { g(1); g(2L); }
+
+// CHECK-LABEL: define linkonce_odr void @_Z1gIiEvT_(
+// CHECK: call void @_ZL27__builtin_violation_handlerj(i32 [[G]])
+// CHECK-LABEL: define linkonce_odr void @_Z1gIlEvT_(
+// CHECK: call void @_ZL27__builtin_violation_handlerj(i32 [[G]])
@@ -0,0 +1,33 @@
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -contract-violation-handler=handler -emit-llvm -o - %s | FileCheck %s
+
+// Strings are stored once, and entries refer to them by offset.
+// CHECK: @__contract_violation_strtab = private unnamed_addr constant [{{[0-9]+}} x i8] c"{{.*}}contracts-violation-table.cpp\00f\00a > 0\00default\00b > 0\00g\00", align 1
+// CHECK: @__contract_violation_tab = private unnamed_addr constant [3 x { i32, i32, i32, i32, i32 }]
+// CHECK-SAME: [{ i32, i32, i32, i32, i32 } { i32 {{[0-9]+}}, i32 0, i32 [[F:[0-9]+]], i32 [[A:[0-9]+]], i32 [[DEF:[0-9]+]] },
+// CHECK-SAME: { i32, i32, i32, i32, i32 } { i32 {{[0-9]+}}, i32 0, i32 [[F]], i32 {{[0-9]+}}, i32 [[DEF]] },
+// CHECK-SAME: { i32, i32, i32, i32, i32 } { i32 {{[0-9]+}}, i32 0, i32 {{[0-9]+}}, i32 [[A]], i32 [[DEF]] }]
+
+// CHECK-LABEL: define void @_Z1fii(
+void f(int a, int b) {
+  // CHECK: call void @_ZL27__builtin_violation_handlerj(i32 0)
+  [[assert: a > 0]];
+  // CHECK: call void @_ZL27__builtin_violation_handlerj(i32 1)
+  [[assert: b > 0]];
+}
+
+// CHECK-LABEL: define internal void @_ZL27__builtin_violation_handlerj(i32
+// CHECK: %[[ENTRY:.*]] = getelementptr inbounds [3 x { i32, i32, i32, i32, i32 }], [3 x { i32, i32, i32, i32, i32 }]* @__contract_violation_tab, i32 0, i32 %
+// CHECK: getelementptr inbounds { i32, i32, i32, i32, i32 }, { i32, i32, i32, i32, i32 }* %[[ENTRY]], i32 0, i32 1
+// CHECK: getelementptr inbounds i8, i8* getelementptr inbounds ([{{[0-9]+}} x i8], [{{[0-9]+}} x i8]* @__contract_violation_strtab, i32 0, i32 0), i32 %
+// CHECK: call void @handler(
+// CHECK: call void @_ZSt9terminatev()
+// CHECK-NEXT: unreachable
+
+// Instantiations of the same contract share an entry.
+template <class T> void g(T a) { [[assert: a > 0]]; }
+void h() { g(1); g(2L); }
+
+// CHECK-LABEL: define linkonce_odr void @_Z1gIiEvT_(
+// CHECK: call void @_ZL27__builtin_violation_handlerj(i32 2)
+// CHECK-LABEL: define linkonce_odr void @_Z1gIlEvT_(
+// CHECK: call void @_ZL27__builtin_violation_handlerj(i32 2)
@@ -0,0 +1,65 @@
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -contract-violation-mode=trap -emit-llvm -o - %s | FileCheck %s
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -O1 -disable-llvm-passes -contract-violation-mode=trap -contract-violation-handler=handler -emit-llvm -o - %s | FileCheck %s --check-prefix=HANDLER
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -contract-violation-mode=trap -fcontinue-after-violation -emit-llvm -o - %s | FileCheck %s --check-prefix=CONTINUE
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -target-feature +avx512f -contract-violation-mode=trap -fcontinue-after-violation -emit-llvm -o - %s | FileCheck %s --check-prefix=AVX512
+// RUN: %clang_cc1 -std=c++14 -triple i386-unknown-linux-gnu -contract-violation-mode=trap -emit-llvm -o - %s | FileCheck %s --check-prefix=I386
+// RUN: %clang_cc1 -std=c++14 -triple i386-unknown-linux-gnu -contract-violation-mode=trap -fcontinue-after-violation -emit-llvm -o - %s | FileCheck %s --check-prefix=I386-CONTINUE
+// RUN: not %clang_cc1 -std=c++14 -triple aarch64-unknown-linux-gnu -contract-violation-mode=trap -emit-llvm -o - %s 2>&1 | FileCheck %s --check-prefix=AARCH64
+// RUN: not %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -contract-violation-mode=trap -fcontract-violation-log -emit-llvm -o - %s 2>&1 | FileCheck %s --check-prefix=LOG
+// RUN: not %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -contract-violation-mode=abort -emit-llvm -o - %s 2>&1 | FileCheck %s --check-prefix=INVALID
+
+// AARCH64: error: unsupported option '-contract-violation-mode=trap' for target 'aarch64-unknown-linux-gnu'
+// LOG: error: invalid argument '-contract-violation-mode=trap' not allowed with '-fcontract-violation-log'
+// INVALID: error: invalid value 'abort' in '-contract-violation-mode=abort'
+
+// The sites are described in the non-loaded .llvm_contract_info section, as
+// with -fcontract-violation-site-ids, and the module registers with the
+// runtime that looks up the traps.
+// CHECK-NOT: @__contract_violation_tab
+// CHECK: @__contract_violation_info = private constant {{.*}} section ".llvm_contract_info", align 4
+// CHECK: @llvm.global_ctors = appending global {{.*}} @__contract_trap_init
+
+// Each failing check only executes its own trap.
+// CHECK-LABEL: define void @_Z1fii(
+void f(int a, int b) {
+  // CHECK: %[[A:.*]] = call i1 @llvm.contract.check(i1 %{{.*}}, i32 [[ID_A:-?[0-9]+]])
+  // CHECK: br i1 %[[A]], label %{{.*}}, label %[[VA:.*]], !prof
+  // CHECK: [[VA]]:
+  // CHECK-NEXT: call void asm sideeffect "1:\0A\09ud2\0A\09.pushsection .llvm_contract_traps,\22\22,@progbits\0A\09.quad 1b\0A\09.long ${0:c}\0A\09.popsection", "i"(i32 [[ID_A]])
+  // CHECK-NEXT: unreachable
+  [[assert: a > 0]];
+  // CHECK: %[[B:.*]] = call i1 @llvm.contract.check(i1 %{{.*}}, i32 [[ID_B:-?[0-9]+]])
+  // CHECK: br i1 %[[B]], label %{{.*}}, label %[[VB:.*]], !prof
+  // CHECK: [[VB]]:
+  // CHECK-NEXT: call void asm sideeffect "{{.*}}", "i"(i32 [[ID_B]])
+  // CHECK-NEXT: unreachable
+  [[assert: b > 0]];
+}
+
+// CHECK-LABEL: define internal void @__contract_trap_init()
+// CHECK: call void @__contract_trap_register(i8* null, i8* bitcast (void ()* @__contract_trap_init to i8*))
+// CHECK-NOT: __builtin_violation_handler
+
+// The traps are not merged when optimizing, and the user-defined handler is
+// reached through the runtime only.
+// HANDLER-LABEL: define void @_Z1fii(
+// HANDLER: call void asm sideeffect "{{.*}}", "i"(i32
+// HANDLER-NEXT: unreachable
+// HANDLER: call void asm sideeffect "{{.*}}", "i"(i32
+// HANDLER-NEXT: unreachable
+// HANDLER-NOT: call void @_ZL27__builtin_violation_handlerj
+// HANDLER-LABEL: define internal void @_ZL27__builtin_violation_handlerj(i32
+// HANDLER: call i32* @__contract_violation_decode(
+// HANDLER: call void @handler(
+// HANDLER-LABEL: define internal void @__contract_trap_init()
+// HANDLER: call void @__contract_trap_register(i8* bitcast (void (i32)* @_ZL27__builtin_violation_handlerj to i8*), i8* bitcast (void ()* @__contract_trap_init to i8*))
+
+// CONTINUE-LABEL: define void @_Z1fii(
+// CONTINUE: call void asm sideeffect "{{.*}}", "i,~{rax},~{rcx},~{rdx},~{rsi},~{rdi},~{r8},~{r9},~{r10},~{r11},~{xmm0},{{.*}},~{xmm15},~{dirflag},~{fpsr},~{flags}"(i32
+// CONTINUE-NEXT: br label %contract.cont
+
+// I386: call void asm sideeffect "1:\0A\09ud2\0A\09.pushsection .llvm_contract_traps,\22\22,@progbits\0A\09.long 1b\0A\09.long ${0:c}\0A\09.popsection", "i"(i32
+
+// The registers the handler may use are clobbered only when it returns.
+// AVX512: call void asm sideeffect "{{.*}}", "i,{{.*}},~{xmm31},~{dirflag},~{fpsr},~{flags}"(i32
+// I386-CONTINUE: call void asm sideeffect "{{.*}}", "i,~{eax},~{ecx},~{edx},~{xmm0},{{.*}},~{xmm7},~{dirflag},~{fpsr},~{flags}"(i32
@@ -0,0 +1,56 @@
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -fcontract-vtable-thunks -emit-llvm -o - %s | FileCheck %s
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -fcontract-vtable-thunks -contract-violation-handler=handler -emit-llvm -o - %s | FileCheck %s --check-prefix=HANDLER
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -emit-llvm -o - %s | FileCheck %s --check-prefix=DEFAULT
+
+// With -fcontract-vtable-thunks, the preconditions of virtual functions are
+// checked by a thunk in each vtable slot, and by the callers when the function
+// is called directly.
+struct B {
+  virtual int f(int i) [[expects: i >= 0]];
+  virtual int g(int i);
+};
+
+struct D final : B {
+  int f(int i) [[expects: i >= 0]] override;
+};
+
+// The conditions merged into the out-of-line definitions keep their source,
+// which the thunks register in the violation table.
+// HANDLER: @__contract_violation_strtab = {{.*}} c"{{.*}}i >= 0\00
+
+// CHECK-DAG: @_ZTV1B = {{.*}} @_ZTh0_N1B1fEi {{.*}} @_ZN1B1gEi
+// CHECK-DAG: @_ZTV1D = {{.*}} @_ZTh0_N1D1fEi {{.*}} @_ZN1B1gEi
+
+// By default, the functions check their own preconditions.
+// DEFAULT-NOT: _ZTh0_
+// DEFAULT: @_ZTV1B = {{.*}} @_ZN1B1fEi {{.*}} @_ZN1B1gEi
+// DEFAULT-LABEL: define i32 @_ZN1B1fEi(
+// DEFAULT: call i1 @llvm.contract.check(
+// DEFAULT-LABEL: define i32 @_Z6directR1Di(
+// DEFAULT-NOT: @llvm.contract.check
+// DEFAULT: ret i32
+// DEFAULT-NOT: _ZTh0_
+
+// CHECK-LABEL: define i32 @_ZN1B1fEi(
+// CHECK-NOT: @llvm.contract.check
+// CHECK: ret i32
+// CHECK-LABEL: define i32 @_ZTh0_N1B1fEi(
+// CHECK: icmp sge i32 {{.*}}, 0
+// CHECK: call i1 @llvm.contract.check(
+// CHECK: tail call i32 @_ZN1B1fEi(
+int B::f(int i) { return i; }
+int B::g(int i) { return i; }
+int D::f(int i) { return i + 1; }
+
+// The call to the final overrider is direct: the caller checks.
+// CHECK-LABEL: define i32 @_Z6directR1Di(
+// CHECK: call i1 @llvm.contract.check(
+// CHECK: call i32 @_ZN1D1fEi(
+int direct(D &d, int i) { return d.f(i); }
+
+// CHECK-LABEL: define i32 @_Z8virtual_R1Bi(
+// CHECK-NOT: @llvm.contract.check
+// CHECK: call i32 %
+// CHECK-NOT: @llvm.contract.check
+// CHECK: ret i32
+int virtual_(B &b, int i) { return b.f(i); }
@@ -0,0 +1,13 @@
+// Test that -fcontract-profile is passed to cc1 and links the profile runtime
+// without its initialization module.
+//
+// RUN: %clang -no-canonical-prefixes %s -### -o %t.o 2>&1 \
+// RUN:     -target x86_64-unknown-linux -fcontract-profile -fuse-ld=ld \
+// RUN:     -resource-dir=%S/Inputs/resource_dir \
+// RUN:     --sysroot=%S/Inputs/basic_linux_tree \
+// RUN:   | FileCheck %s
+//
+// CHECK: "-cc1" {{.*}}"-fcontract-profile"
+// CHECK: "{{(.*[^-.0-9A-Z_a-z])?}}ld{{(.exe)?}}"
+// CHECK-NOT: "-u__llvm_profile_runtime"
+// CHECK: "{{.*}}/Inputs/resource_dir{{/|\\\\}}lib{{/|\\\\}}linux{{/|\\\\}}libclang_rt.profile-x86_64.a"
@@ -0,0 +1,20 @@
+// Test that -fcontract-violation-log is passed to cc1 and links the contracts
+// runtime and its thread library.
+//
+// RUN: %clang -no-canonical-prefixes %s -### -o %t.o 2>&1 \
+// RUN:     -target x86_64-unknown-linux -fcontract-violation-log -fuse-ld=ld \
+// RUN:     -resource-dir=%S/Inputs/resource_dir \
+// RUN:     --sysroot=%S/Inputs/basic_linux_tree \
+// RUN:   | FileCheck %s
+//
+// CHECK: "-cc1" {{.*}}"-fcontract-violation-log"
+// CHECK: "{{(.*[^-.0-9A-Z_a-z])?}}ld{{(.exe)?}}"
+// CHECK: "{{.*}}/Inputs/resource_dir{{/|\\\\}}lib{{/|\\\\}}linux{{/|\\\\}}libclang_rt.contracts-x86_64.a" "-lpthread"
+//
+// RUN: %clang -no-canonical-prefixes %s -### -o %t.o 2>&1 \
+// RUN:     -target x86_64-apple-darwin12 -fcontract-violation-log \
+// RUN:     -resource-dir=%S/Inputs/resource_dir \
+// RUN:   | FileCheck %s --check-prefix=DARWIN
+//
+// DARWIN: "{{.*}}ld{{(.exe)?}}"
+// DARWIN: libclang_rt.contracts_osx.a"
@@ -0,0 +1,28 @@
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -emit-pch -o %t %s
+// RUN: %clang_cc1 -std=c++14 -triple x86_64-unknown-linux-gnu -include-pch %t -emit-llvm -o - %s | FileCheck %s
+// RUN: %clang_cc1 -std=c++14 -build-level=off -axiom-mode=off -emit-pch -o %t.off %s
+// RUN: %clang_cc1 -std=c++14 -build-level=off -axiom-mode=off -include-pch %t.off -ast-dump-all %s | FileCheck %s --check-prefix=OFF
+
+// Contract conditions are read from the PCH only if they are checked or
+// assumed.
+
+#ifndef HEADER
+#define HEADER
+
+inline int f(int x) [[expects: x > 0]] [[ensures r: r > x]] { return x + 1; }
+
+#else
+
+// CHECK-LABEL: define linkonce_odr i32 @_Z1fi(
+// CHECK: icmp sgt i32 {{.*}}, 0
+// CHECK: call i1 @llvm.contract.check(
+// CHECK: icmp sgt i32
+// CHECK: call i1 @llvm.contract.check(
+
+// OFF: ExpectsAttr {{.*}} Pending
+// OFF-NEXT: <<<NULL>>>
+// OFF: EnsuresAttr {{.*}} Pending
+// OFF-NEXT: <<<NULL>>>
+int use(int x) { return f(x); }
+
+#endif
@@ -0,0 +1,56 @@
+// RUN: %clang_cc1 -std=c++14 -fsyntax-only -verify %s
+// RUN: %clang_cc1 -std=c++14 -fsyntax-only -verify -build-level=audit -DAUDIT %s
+
+// Contract conditions that are constant expressions are folded by Sema.
+void f() [[expects: sizeof(int) > 1]];
+void g() [[expects: sizeof(int) < 1]]; // expected-warning {{precondition is always false}}
+int h() [[ensures: 2 + 2 == 5]]; // expected-warning {{postcondition is always false}}
+
+void body() {
+  [[assert: 0]]; // expected-warning {{assertion is always false}}
+}
+
+template <typename T> void tmpl() [[expects: sizeof(T) == 4]] {}
+template void tmpl<int>();
+template void tmpl<char>(); // expected-warning@-2 {{precondition is always false}} expected-note {{in instantiation of}}
+
+template <typename T> void tmpl_assert() {
+  [[assert: sizeof(T) == 4]]; // expected-warning {{assertion is always false}}
+}
+template void tmpl_assert<int>();
+template void tmpl_assert<char>(); // expected-note {{in instantiation of}}
+
+// Contracts are checked during constant evaluation.
+constexpr int pos(int x) [[expects: x > 0]] { return x; } // expected-note {{precondition is violated}}
+constexpr int p1 = pos(1);
+constexpr int p2 = pos(0); // expected-error {{must be initialized by a constant expression}} expected-note {{in call to 'pos(0)'}}
+
+constexpr int twice(int x) [[ensures r: r > x]] { return 2 * x; } // expected-note {{postcondition is violated}}
+constexpr int t1 = twice(1);
+constexpr int t2 = twice(-1); // expected-error {{must be initialized by a constant expression}} expected-note {{in call to 'twice(-1)'}}
+
+constexpr int half(int x) {
+  [[assert: x % 2 == 0]]; // expected-note {{assertion is violated}}
+  return x / 2;
+}
+constexpr int h1 = half(4);
+constexpr int h2 = half(3); // expected-error {{must be initialized by a constant expression}} expected-note {{in call to 'half(3)'}}
+
+struct S {
+  int v;
+  constexpr S(int v) [[expects: v != 0]] : v(v) {} // expected-note {{precondition is violated}}
+};
+constexpr S s1(1);
+constexpr S s2(0); // expected-error {{must be initialized by a constant expression}} expected-note {{in call to 'S(0)'}}
+
+// A failed check outside of a constant expression is left to run time.
+int runtime() { return pos(0); }
+
+// Audit contracts are only evaluated at -build-level=audit.
+constexpr int audited(int x) [[expects audit: x > 0]] { return x; }
+#ifdef AUDIT
+// expected-note@-2 {{precondition is violated}}
+constexpr int a = audited(0); // expected-error {{must be initialized by a constant expression}} expected-note {{in call to 'audited(0)'}}
+#else
+constexpr int a = audited(0);
+#endif
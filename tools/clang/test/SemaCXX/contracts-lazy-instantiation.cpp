@@ -0,0 +1,52 @@
+// RUN: %clang_cc1 -std=c++14 -fsyntax-only -verify -build-level=off -axiom-mode=off %s
+// RUN: %clang_cc1 -std=c++14 -fsyntax-only -verify -DDEFAULT %s
+// RUN: %clang_cc1 -std=c++14 -fsyntax-only -verify -build-level=off -axiom-mode=off -contract-assume-unchecked -DDEFAULT -DAUDIT %s
+
+// The contract conditions of a specialization are only instantiated when it is
+// used, and only those checked or assumed at the build level.
+
+struct S { int size() const { return 1; } };
+
+template <typename T> int f(T x) [[expects: x.size() > 0]] { return 0; }
+#ifdef DEFAULT
+// expected-error@-2 {{member reference base type 'int' is not a structure or union}}
+#endif
+
+template <typename T> int g(T x) [[expects audit: x.size() > 0]] { return 0; }
+#ifdef AUDIT
+// expected-error@-2 {{member reference base type 'int' is not a structure or union}}
+#endif
+
+template <typename T> T h(T x) [[ensures r: r.size() > 0]] { return x; }
+#ifdef DEFAULT
+// expected-error@-2 {{member reference base type 'int' is not a structure or union}}
+#endif
+
+template <typename T> int k(T x) [[expects: x.size() > 0]];
+
+int use(S s) {
+  return f(s) + g(s) + h(s).size();
+}
+
+int use_int() {
+  int r = f(1);
+#ifdef DEFAULT
+  // expected-note@-2 {{in instantiation of function template specialization 'f<int>' requested here}}
+#endif
+  r += g(1);
+#ifdef AUDIT
+  // expected-note@-2 {{in instantiation of function template specialization 'g<int>' requested here}}
+#endif
+  r += h(1);
+#ifdef DEFAULT
+  // expected-note@-2 {{in instantiation of function template specialization 'h<int>' requested here}}
+#endif
+  return r;
+}
+
+// Unevaluated operands don't need the conditions.
+decltype(k(1)) unevaluated;
+
+#if !defined(DEFAULT)
+// expected-no-diagnostics
+#endif
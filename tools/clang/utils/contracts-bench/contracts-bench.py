@@ -0,0 +1,213 @@
+#!/usr/bin/env python
+#===- contracts-bench.py - Contract overhead benchmarks ------*- python -*--===#
+#
+#                     The LLVM Compiler Infrastructure
+#
+# This file is distributed under the University of Illinois Open Source
+# License. See LICENSE.TXT for details.
+#
+#===------------------------------------------------------------------------===#
+#
+# Builds the kernels in the kernels/ directory at each contract build level and
+# axiom mode, and measures the compile time, the code size and the run time of
+# each build.  The results, and their ratios to the build without contracts
+# (-build-level=off -axiom-mode=off), are written as JSON.
+#
+#===------------------------------------------------------------------------===#
+
+from __future__ import print_function
+
+import argparse
+import datetime
+import json
+import os
+import platform
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+# (name, build level, axiom mode); the first one is the baseline.
+CONFIGS = [
+  ('off', 'off', 'off'),
+  ('off-axiom', 'off', 'on'),
+  ('default', 'default', 'off'),
+  ('default-axiom', 'default', 'on'),
+  ('audit', 'audit', 'off'),
+  ('audit-axiom', 'audit', 'on'),
+]
+
+def findKernels(path):
+  return sorted(os.path.join(path, f) for f in os.listdir(path)
+                if f.endswith('.cpp'))
+
+def findTool(name, clang):
+  # Prefer the tools built along with clang.
+  tool = os.path.join(os.path.dirname(clang), name)
+  if os.path.exists(tool):
+    return tool
+  for dir in os.environ.get('PATH', '').split(os.pathsep):
+    tool = os.path.join(dir, name)
+    if os.path.exists(tool):
+      return tool
+  return None
+
+def bestTime(cmd, runs, **kwargs):
+  best, out = None, None
+  for i in range(runs):
+    start = time.time()
+    out = subprocess.check_output(cmd, **kwargs)
+    elapsed = time.time() - start
+    if best is None or elapsed < best:
+      best = elapsed
+  return best, out
+
+def textSize(size_tool, obj):
+  # Berkeley format: text data bss dec hex filename
+  out = subprocess.check_output([size_tool, obj]).decode()
+  return int(out.splitlines()[1].split()[0])
+
+def countUnchecked(nm_tool, obj):
+  # Unchecked copies of the functions with contracts are mangled with the
+  # U9unchecked vendor qualifier.
+  if not nm_tool:
+    return None
+  out = subprocess.check_output([nm_tool, obj]).decode()
+  return sum(1 for line in out.splitlines() if 'U9unchecked' in line)
+
+def benchmark(args, kernel, config, tmpdir):
+  name, level, axiom = config
+  base = os.path.splitext(os.path.basename(kernel))[0]
+  obj = os.path.join(tmpdir, '%s.%s.o' % (base, name))
+  exe = os.path.join(tmpdir, '%s.%s' % (base, name))
+  flags = ['-std=c++14', '-build-level=' + level, '-axiom-mode=' + axiom]
+  flags += args.cxxflags
+
+  compile_time, _ = bestTime([args.clang, '--driver-mode=g++', '-c', kernel,
+                              '-o', obj] + flags, args.compile_runs)
+  subprocess.check_call([args.clang, '--driver-mode=g++', obj, '-o', exe] +
+                        args.ldflags)
+  result = {
+    'kernel': base,
+    'config': name,
+    'build_level': level,
+    'axiom_mode': axiom,
+    'compile_time': compile_time,
+    'text_size': textSize(args.size, obj),
+    'unchecked_functions': countUnchecked(args.nm, obj),
+  }
+  if not args.compile_only:
+    cmd = [exe]
+    if args.iterations:
+      cmd.append(str(args.iterations))
+    run_time, out = bestTime(cmd, args.runs)
+    result['run_time'] = run_time
+    result['output'] = out.decode().strip()
+  return result
+
+def addRatios(results):
+  baselines = {}
+  for r in results:
+    if r['config'] == CONFIGS[0][0]:
+      baselines[r['kernel']] = r
+  for r in results:
+    b = baselines.get(r['kernel'])
+    if not b:
+      continue
+    r['compile_time_growth'] = r['compile_time'] / b['compile_time']
+    r['size_growth'] = float(r['text_size']) / b['text_size']
+    if 'run_time' in r:
+      r['slowdown'] = r['run_time'] / b['run_time']
+      # Contracts that hold must not change the results.
+      r['output_matches'] = r['output'] == b['output']
+
+def main():
+  parser = argparse.ArgumentParser(
+    description='Measure the overhead of C++ contracts on the benchmark '
+                'kernels and write the results as JSON.')
+  parser.add_argument('--clang', required=True,
+    help='clang binary to benchmark')
+  parser.add_argument('--kernels',
+    default=os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                         'kernels'),
+    help='directory of the kernels (default: kernels/)')
+  parser.add_argument('--filter', default=None,
+    help='only run the kernels whose name contains this string')
+  parser.add_argument('--configs', default=None,
+    help='comma-separated list of the configurations to run (default: all '
+         'of %s)' % ', '.join(c[0] for c in CONFIGS))
+  parser.add_argument('--cxxflags', default='-O2',
+    help='additional compiler flags (default: -O2)')
+  parser.add_argument('--ldflags', default='',
+    help='additional linker flags')
+  parser.add_argument('--runs', type=int, default=5,
+    help='number of runs of each kernel; the best time is kept (default: 5)')
+  parser.add_argument('--compile-runs', type=int, default=3,
+    help='number of compilations of each kernel (default: 3)')
+  parser.add_argument('--iterations', type=int, default=None,
+    help='number of iterations passed to the kernels')
+  parser.add_argument('--compile-only', action='store_true',
+    help='only measure compile time and code size')
+  parser.add_argument('--output', '-o', default=None,
+    help='JSON output file (default: stdout)')
+  args = parser.parse_args()
+
+  args.clang = os.path.abspath(args.clang)
+  args.cxxflags = args.cxxflags.split()
+  args.ldflags = args.ldflags.split()
+  args.size = findTool('llvm-size', args.clang) or findTool('size', args.clang)
+  args.nm = findTool('llvm-nm', args.clang) or findTool('nm', args.clang)
+  if not args.size:
+    print('error: llvm-size or size not found', file=sys.stderr)
+    return 1
+
+  configs = CONFIGS
+  if args.configs:
+    names = args.configs.split(',')
+    configs = [c for c in CONFIGS if c[0] in names]
+    unknown = set(names) - set(c[0] for c in configs)
+    if unknown:
+      print('error: unknown configuration(s): %s' % ', '.join(sorted(unknown)),
+            file=sys.stderr)
+      return 1
+    if CONFIGS[0] not in configs:
+      configs.insert(0, CONFIGS[0])
+
+  kernels = findKernels(args.kernels)
+  if args.filter:
+    kernels = [k for k in kernels if args.filter in os.path.basename(k)]
+
+  version = subprocess.check_output([args.clang, '--version']).decode()
+  tmpdir = tempfile.mkdtemp(prefix='contracts-bench-')
+  try:
+    results = []
+    for kernel in kernels:
+      for config in configs:
+        print('%s: %s' % (os.path.basename(kernel), config[0]),
+              file=sys.stderr)
+        results.append(benchmark(args, kernel, config, tmpdir))
+  finally:
+    shutil.rmtree(tmpdir)
+  addRatios(results)
+
+  report = {
+    'clang': args.clang,
+    'clang_version': version.splitlines()[0],
+    'host': platform.node(),
+    'date': datetime.datetime.utcnow().strftime('%Y-%m-%dT%H:%M:%SZ'),
+    'cxxflags': args.cxxflags,
+    'baseline': CONFIGS[0][0],
+    'results': results,
+  }
+  if args.output:
+    with open(args.output, 'w') as f:
+      json.dump(report, f, indent=2, sort_keys=True)
+      f.write('\n')
+  else:
+    json.dump(report, sys.stdout, indent=2, sort_keys=True)
+    print()
+  return 0
+
+if __name__ == '__main__':
+  sys.exit(main())
@@ -0,0 +1,70 @@
+//===- bounds.cpp - Bounds-checked container kernel -----------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Element accesses of a fixed-capacity vector check their index, and binary
+// search audits that the vector is sorted.
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstdlib>
+
+template <typename T, unsigned N> class Vector {
+  T Data[N];
+  unsigned Size = 0;
+
+public:
+  unsigned size() const { return Size; }
+
+  bool sorted() const {
+    for (unsigned I = 1; I < Size; ++I)
+      if (Data[I] < Data[I - 1])
+        return false;
+    return true;
+  }
+
+  void push_back(const T &V) [[expects: Size < N]] { Data[Size++] = V; }
+
+  T &operator[](unsigned I) [[expects: I < Size]] { return Data[I]; }
+
+  const T &operator[](unsigned I) const [[expects: I < Size]] {
+    return Data[I];
+  }
+
+  unsigned lower_bound(const T &V) const [[expects audit: sorted()]]
+      [[ensures R: R <= Size]] {
+    unsigned Lo = 0, Hi = Size;
+    while (Lo < Hi) {
+      unsigned Mid = Lo + (Hi - Lo) / 2;
+      if ((*this)[Mid] < V)
+        Lo = Mid + 1;
+      else
+        Hi = Mid;
+    }
+    return Lo;
+  }
+};
+
+static Vector<unsigned, 4096> V;
+
+int main(int argc, char **argv) {
+  unsigned Iterations = argc > 1 ? atoi(argv[1]) : 2000;
+  for (unsigned I = 0; I < 4096; ++I)
+    V.push_back(I * 3);
+
+  unsigned long long Sum = 0;
+  for (unsigned It = 0; It < Iterations; ++It) {
+    for (unsigned I = 0; I < V.size(); ++I)
+      Sum += V[I] ^ It;
+    for (unsigned I = 0; I < 64; ++I)
+      Sum += V.lower_bound((It * 64 + I) % 12288);
+  }
+  printf("%llu\n", Sum);
+  return 0;
+}
@@ -0,0 +1,66 @@
+//===- numeric.cpp - Numeric loop kernel ----------------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Vector loops whose preconditions state the sizes and alignment of their
+// operands (axioms, assumed with -axiom-mode=on), with a checked result.
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+__attribute__((noinline))
+void saxpy(float A, const float *X, float *Y, unsigned N)
+    [[expects: X != nullptr && Y != nullptr]]
+    [[expects axiom: N % 8 == 0]]
+    [[expects axiom: (uintptr_t)X % 32 == 0 && (uintptr_t)Y % 32 == 0]] {
+  for (unsigned I = 0; I < N; ++I)
+    Y[I] += A * X[I];
+}
+
+__attribute__((noinline))
+float dot(const float *X, const float *Y, unsigned N)
+    [[expects axiom: N % 8 == 0]] {
+  float Sum = 0;
+  for (unsigned I = 0; I < N; ++I)
+    Sum += X[I] * Y[I];
+  return Sum;
+}
+
+__attribute__((noinline))
+float norm2(const float *X, unsigned N) [[ensures R: R >= 0]] {
+  return dot(X, X, N);
+}
+
+static void scale(float *X, unsigned N, float F) {
+  for (unsigned I = 0; I < N; ++I) {
+    [[assert: I < N]];
+    X[I] *= F;
+  }
+}
+
+alignas(32) static float X[1024], Y[1024];
+
+int main(int argc, char **argv) {
+  unsigned Iterations = argc > 1 ? atoi(argv[1]) : 20000;
+  for (unsigned I = 0; I < 1024; ++I) {
+    X[I] = (I % 7) * 0.25f;
+    Y[I] = (I % 5) * 0.5f;
+  }
+
+  double Sum = 0;
+  for (unsigned It = 0; It < Iterations; ++It) {
+    saxpy(0.001f, X, Y, 1024);
+    Sum += norm2(Y, 1024) * 1e-9;
+    scale(Y, 1024, 0.999f);
+  }
+  printf("%.3f\n", Sum);
+  return 0;
+}
@@ -0,0 +1,61 @@
+//===- virtual.cpp - Virtual dispatch kernel ------------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Virtual functions with contracts called through pointers to the base class,
+// which always go through the checked definitions.
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstdlib>
+
+struct Shape {
+  virtual ~Shape() {}
+  virtual double area() const = 0;
+  virtual void grow(double F) = 0;
+};
+
+struct Square : Shape {
+  double Side;
+  explicit Square(double S) : Side(S) {}
+  double area() const [[ensures R: R >= 0]] override { return Side * Side; }
+  void grow(double F) [[expects: F > 0]] override { Side *= F; }
+};
+
+struct Circle : Shape {
+  double Radius;
+  explicit Circle(double R) : Radius(R) {}
+  double area() const [[ensures R: R >= 0]] override {
+    return 3.14159265 * Radius * Radius;
+  }
+  void grow(double F) [[expects: F > 0]] [[expects audit: F < 2]] override {
+    Radius *= F;
+  }
+};
+
+static Shape *Shapes[256];
+
+int main(int argc, char **argv) {
+  unsigned Iterations = argc > 1 ? atoi(argv[1]) : 50000;
+  for (unsigned I = 0; I < 256; ++I)
+    Shapes[I] = I % 3 ? static_cast<Shape *>(new Square(1 + I % 5))
+                      : static_cast<Shape *>(new Circle(1 + I % 7));
+
+  double Sum = 0;
+  for (unsigned It = 0; It < Iterations; ++It)
+    for (Shape *S : Shapes) {
+      S->grow(It % 2 ? 1.0001 : 0.9999);
+      Sum += S->area() * 1e-6;
+    }
+  printf("%.3f\n", Sum);
+
+  for (Shape *S : Shapes)
+    delete S;
+  return 0;
+}
@@ -327,6 +327,8 @@ static const char *GetCodeName(unsigned CodeID, unsigned BlockID,
       STRINGIFY_CODE(FS, VALUE_GUID)
       STRINGIFY_CODE(FS, CFI_FUNCTION_DEFS)
       STRINGIFY_CODE(FS, CFI_FUNCTION_DECLS)
+      STRINGIFY_CODE(FS, CONTRACT_CHECKS)
+      STRINGIFY_CODE(FS, CONTRACT_CALL_ARGS)
     }
   case bitc::METADATA_ATTACHMENT_ID:
     switch(CodeID) {
@@ -15,6 +15,8 @@
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/ProfileData/ContractProf.h"
+#include "llvm/ProfileData/ContractViolationLog.h"
 #include "llvm/ProfileData/InstrProfReader.h"
 #include "llvm/ProfileData/InstrProfWriter.h"
 #include "llvm/ProfileData/ProfileCommon.h"
@@ -755,6 +757,126 @@ static int show_main(int argc, const char *argv[]) {
                              ShowFunction, OS);
 }
 
+static int contract_main(int argc, const char *argv[]) {
+  cl::list<std::string> InputFilenames(cl::Positional, cl::OneOrMore,
+                                       cl::desc("<contract-profile-files...>"));
+  cl::opt<std::string> OutputFilename(
+      "output", cl::value_desc("output"),
+      cl::desc("Write the merged profile to <output> instead of showing the "
+               "ranking"));
+  cl::alias OutputFilenameA("o", cl::desc("Alias for --output"),
+                            cl::aliasopt(OutputFilename));
+  cl::opt<uint32_t> TopNSites(
+      "topn", cl::init(0),
+      cl::desc("Show only the contract sites with the largest estimated "
+               "cycles"));
+
+  cl::ParseCommandLineOptions(argc, argv,
+                              "LLVM contract profile merger and ranking\n");
+
+  ContractProfile Profile;
+  for (const auto &Filename : InputFilenames)
+    if (Error E = Profile.readFile(Filename))
+      exitWithError(std::move(E));
+
+  if (!OutputFilename.empty()) {
+    std::error_code EC;
+    raw_fd_ostream OS(OutputFilename.data(), EC, sys::fs::F_Text);
+    if (EC)
+      exitWithErrorCode(EC, OutputFilename);
+    Profile.write(OS);
+    return 0;
+  }
+
+  auto Ranking = Profile.getRanking();
+  if (TopNSites && TopNSites < Ranking.size())
+    Ranking.resize(TopNSites);
+
+  raw_ostream &OS = outs();
+  OS << "Contract sites: " << Profile.size() << "\n";
+  OS << "      Est.cycles  Evaluations   Violations  Level    Site\n";
+  for (const ContractProfRecord *R : Ranking) {
+    OS << format_decimal(R->getEstimatedCycles(), 16) << ' '
+       << format_decimal(R->Evaluations, 12) << ' '
+       << format_decimal(R->Violations, 12) << "  " << left_justify(R->Level, 8)
+       << ' ' << R->File << ':' << R->Line << ": " << R->Function << ": "
+       << R->Comment << "\n";
+  }
+  return 0;
+}
+
+static void printContractSite(raw_ostream &OS, const ContractViolationSite *S) {
+  if (!S) {
+    OS << "<full buffer>";
+    return;
+  }
+  OS << S->File << ':' << S->Line << ": " << S->Function << ": " << S->Comment;
+}
+
+static int contract_log_main(int argc, const char *argv[]) {
+  cl::list<std::string> InputFilenames(cl::Positional, cl::OneOrMore,
+                                       cl::desc("<contract-violation-logs...>"));
+  cl::opt<bool> Summary(
+      "summary", cl::init(false),
+      cl::desc("Show the number of logged and dropped violations of each "
+               "contract site instead of the violations"));
+
+  cl::ParseCommandLineOptions(argc, argv,
+                              "LLVM contract violation log decoder\n");
+
+  raw_ostream &OS = outs();
+  for (const auto &Filename : InputFilenames) {
+    ContractViolationLog Log;
+    if (Error E = Log.readFile(Filename))
+      exitWithError(std::move(E));
+
+    if (!Summary) {
+      for (const ContractViolationEvent &E : Log.events()) {
+        OS << format("%llu.%09llu", (unsigned long long)(E.Time / 1000000000),
+                     (unsigned long long)(E.Time % 1000000000));
+        if (E.Dropped)
+          OS << "  dropped " << E.Count << "  ";
+        else
+          OS << "  violation  ";
+        printContractSite(OS, E.Site);
+        if (E.Site)
+          OS << " [" << E.Site->Level << ']';
+        OS << "\n";
+      }
+      continue;
+    }
+
+    // Sum the events by site, and show the most violated sites first.
+    std::vector<std::pair<const ContractViolationSite *, std::pair<uint64_t, uint64_t>>>
+        Totals;
+    for (const ContractViolationEvent &E : Log.events()) {
+      auto I = std::find_if(Totals.begin(), Totals.end(),
+                            [&](const decltype(Totals)::value_type &T) {
+                              return T.first == E.Site;
+                            });
+      if (I == Totals.end())
+        I = Totals.insert(Totals.end(), {E.Site, {0, 0}});
+      (E.Dropped ? I->second.second : I->second.first) += E.Count;
+    }
+    std::stable_sort(Totals.begin(), Totals.end(),
+                     [](const decltype(Totals)::value_type &L,
+                        const decltype(Totals)::value_type &R) {
+                       return L.second.first + L.second.second >
+                              R.second.first + R.second.second;
+                     });
+    OS << Filename << ": " << Log.events().size() << " records\n";
+    OS << "      Logged      Dropped  Level    Site\n";
+    for (const auto &T : Totals) {
+      OS << format_decimal(T.second.first, 12) << ' '
+         << format_decimal(T.second.second, 12) << "  "
+         << left_justify(T.first ? T.first->Level : "", 8) << ' ';
+      printContractSite(OS, T.first);
+      OS << "\n";
+    }
+  }
+  return 0;
+}
+
 int main(int argc, const char *argv[]) {
   // Print a stack trace if we signal out.
   sys::PrintStackTraceOnErrorSignal(argv[0]);
@@ -769,6 +891,10 @@ int main(int argc, const char *argv[]) {
       func = merge_main;
     else if (strcmp(argv[1], "show") == 0)
       func = show_main;
+    else if (strcmp(argv[1], "contract") == 0)
+      func = contract_main;
+    else if (strcmp(argv[1], "contract-log") == 0)
+      func = contract_log_main;
 
     if (func) {
       std::string Invocation(ProgName.str() + " " + argv[1]);
@@ -783,7 +909,7 @@ int main(int argc, const char *argv[]) {
              << "USAGE: " << ProgName << " <command> [args...]\n"
              << "USAGE: " << ProgName << " <command> -help\n\n"
              << "See each individual command --help for more details.\n"
-             << "Available commands: merge, show\n";
+             << "Available commands: merge, show, contract, contract-log\n";
       return 0;
     }
   }
@@ -793,6 +919,7 @@ int main(int argc, const char *argv[]) {
   else
     errs() << ProgName << ": Unknown command!\n";
 
-  errs() << "USAGE: " << ProgName << " <merge|show> [args...]\n";
+  errs() << "USAGE: " << ProgName
+         << " <merge|show|contract|contract-log> [args...]\n";
   return 1;
 }